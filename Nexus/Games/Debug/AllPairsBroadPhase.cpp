@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "AllPairsBroadPhase.h"
+
+int AllPairsBroadPhase::CreateProxy(const AABB& aabb, const Entity entity, const bool isStatic)
+{
+	if (m_freeProxies.empty())
+	{
+		m_proxies.push_back({ aabb, entity, isStatic, true });
+		return static_cast<int>(m_proxies.size()) - 1;
+	}
+
+	const int proxyId = m_freeProxies.back();
+	m_freeProxies.pop_back();
+	m_proxies[proxyId] = { aabb, entity, isStatic, true };
+	return proxyId;
+}
+
+void AllPairsBroadPhase::DestroyProxy(const int proxyId)
+{
+	if (!m_proxies[proxyId].isAlive)
+	{
+		return;
+	}
+	m_proxies[proxyId].isAlive = false;
+	m_freeProxies.push_back(proxyId);
+}
+
+void AllPairsBroadPhase::MoveProxy(const int proxyId, const AABB& aabb, const Vector2& /*displacement*/)
+{
+	m_proxies[proxyId].aabb = aabb;
+}
+
+void AllPairsBroadPhase::FindPairs(std::vector<BroadPhasePair>& outPairs)
+{
+	outPairs.clear();
+	for (size_t i = 0; i < m_proxies.size(); i++)
+	{
+		const Proxy& a = m_proxies[i];
+		if (!a.isAlive)
+		{
+			continue;
+		}
+		for (size_t j = i + 1; j < m_proxies.size(); j++)
+		{
+			const Proxy& b = m_proxies[j];
+			if (b.isAlive && !(a.isStatic && b.isStatic) && a.aabb.Overlaps(b.aabb))
+			{
+				outPairs.push_back({ a.entity, b.entity });
+			}
+		}
+	}
+}
+
+void AllPairsBroadPhase::QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+	for (const auto& proxy : m_proxies)
+	{
+		if (proxy.isAlive && proxy.aabb.Overlaps(region))
+		{
+			outEntities.push_back(proxy.entity);
+		}
+	}
+}
+
+void AllPairsBroadPhase::RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+	for (const auto& proxy : m_proxies)
+	{
+		if (proxy.isAlive && proxy.aabb.IntersectsSegment(start, end))
+		{
+			outEntities.push_back(proxy.entity);
+		}
+	}
+}
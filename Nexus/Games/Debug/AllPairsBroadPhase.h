@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "src/Physics/BroadPhase.h"
+
+//------------------------------------------------------------------------
+// AllPairsBroadPhase
+// Reference broad phase for BroadPhaseScene: tests every proxy against every other one (O(n²)), like the CollisionSystem did before it had a broad phase.
+//------------------------------------------------------------------------
+class AllPairsBroadPhase final : public IBroadPhase
+{
+public:
+	int CreateProxy(const AABB& aabb, Entity entity, bool isStatic) override;
+	void DestroyProxy(int proxyId) override;
+	void MoveProxy(int proxyId, const AABB& aabb, const Vector2& displacement) override;
+	void FindPairs(std::vector<BroadPhasePair>& outPairs) override;
+	void QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const override;
+	void RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const override;
+
+	[[nodiscard]] size_t GetProxyCount() const override { return m_proxies.size() - m_freeProxies.size(); }
+
+private:
+	struct Proxy
+	{
+		AABB aabb;
+		Entity entity;
+		bool isStatic;
+		bool isAlive;
+	};
+
+	// [Vector index = proxy id]
+	std::vector<Proxy> m_proxies;
+	// Proxy ids that were destroyed and can be reused
+	std::vector<int> m_freeProxies;
+};
@@ -0,0 +1,26 @@
+#include "stdafx.h"
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(const size_t size)
+{
+	AllocationCounter::OnAllocation();
+	// malloc(0) may return nullptr, operator new has to return a unique pointer
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t /*size*/) noexcept
+{
+	std::free(memory);
+}
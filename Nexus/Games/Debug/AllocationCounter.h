@@ -0,0 +1,20 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Counts the heap allocations of the whole program, for the benchmarks that check a loop doesn't allocate.
+// AllocationCounter.cpp replaces the global operator new and delete (the array and nothrow versions go through them). Counting is one relaxed atomic increment per allocation.
+// The over-aligned versions (std::align_val_t) aren't counted, nothing in the engine uses them.
+class AllocationCounter
+{
+public:
+	// Allocations since the start of the program, on every thread
+	[[nodiscard]] static size_t GetCount() { return s_allocationCount.load(std::memory_order_relaxed); }
+
+	// Called by the replaced operator new
+	static void OnAllocation() { s_allocationCount.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+	inline static std::atomic<size_t> s_allocationCount{ 0 };
+};
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "BroadPhaseScene.h"
+#include "AllPairsBroadPhase.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+
+#include "src/Physics/BroadPhase.h"
+#include "src/Physics/DynamicAABBTree.h"
+#include "src/Physics/PhysicsEngine.h"
+#include "src/Physics/SweepAndPrune.h"
+#include "src/Physics/UniformGridBroadPhase.h"
+#include "src/Systems/CollisionSystem.h"
+
+#include "src/Utils/Logger.h"
+
+BroadPhaseScene::Result BroadPhaseScene::Run(std::unique_ptr<IBroadPhase> broadPhase, const size_t bodyCount, const int stepCount)
+{
+	Coordinator coordinator;
+	coordinator.AddSystem<CollisionSystem>();
+	auto& collisionSystem = coordinator.GetSystem<CollisionSystem>();
+	collisionSystem.SetBroadPhase(std::move(broadPhase));
+
+	// Floor of static boxes, 20 px apart
+	const float boxStride = WORLD_WIDTH / static_cast<float>(STATIC_BOX_COUNT);
+	for (size_t i = 0; i < STATIC_BOX_COUNT; i++)
+	{
+		Entity box = coordinator.CreateEntity();
+		box.AddComponent<TransformComponent>(Vector2(boxStride * (static_cast<float>(i) + 0.5f), 20.f), Vector2(1.f, 1.f));
+		box.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f);
+		box.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+		box.AddComponent<BoxColliderComponent>(boxStride - 4.f, 40.f);
+	}
+
+	// Fixed seed, so every broad phase gets the same bodies
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> positionX(0.f, WORLD_WIDTH);
+	std::uniform_real_distribution<float> positionY(0.f, WORLD_HEIGHT);
+	std::uniform_real_distribution<float> speed(-300.f, 300.f);
+	std::uniform_real_distribution<float> radius(5.f, 30.f);
+	std::vector<Entity> bodies;
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		Entity body = coordinator.CreateEntity();
+		body.AddComponent<TransformComponent>(Vector2(positionX(random), positionY(random)), Vector2(1.f, 1.f));
+		body.AddComponent<RigidBodyComponent>(Vector2(speed(random), speed(random)), Vector2(), false, 1.f);
+		body.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
+		body.AddComponent<CircleColliderComponent>(radius(random));
+		bodies.push_back(body);
+	}
+	coordinator.Update();
+
+	constexpr float stepTime = 1.f / 60.f;
+	IBroadPhase& activeBroadPhase = collisionSystem.GetBroadPhase();
+	std::vector<BroadPhasePair> pairs;
+	double moveMilliseconds = 0.0;
+	double pairsMilliseconds = 0.0;
+	for (int step = 0; step < stepCount; step++)
+	{
+		const auto moveStart = std::chrono::steady_clock::now();
+		for (const Entity& body : bodies)
+		{
+			auto& transform = body.GetComponent<TransformComponent>();
+			auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+
+			// Bounce on the borders of the world
+			if (transform.position.x < 0.f || transform.position.x > WORLD_WIDTH) rigidBody.velocity.x = -rigidBody.velocity.x;
+			if (transform.position.y < 0.f || transform.position.y > WORLD_HEIGHT) rigidBody.velocity.y = -rigidBody.velocity.y;
+
+			const Vector2 displacement = rigidBody.velocity * stepTime;
+			transform.position += displacement;
+			PhysicsEngine::UpdateColliderProperties(body, transform, activeBroadPhase, displacement);
+		}
+
+		const auto pairsStart = std::chrono::steady_clock::now();
+		activeBroadPhase.FindPairs(pairs);
+		const auto pairsEnd = std::chrono::steady_clock::now();
+
+		moveMilliseconds += std::chrono::duration<double, std::milli>(pairsStart - moveStart).count();
+		pairsMilliseconds += std::chrono::duration<double, std::milli>(pairsEnd - pairsStart).count();
+	}
+
+	return { moveMilliseconds / stepCount, pairsMilliseconds / stepCount, pairs.size() };
+}
+
+void BroadPhaseScene::LogComparison()
+{
+	for (const size_t bodyCount : { 500, 2000, 8000 })
+	{
+		std::vector<std::pair<const char*, Result>> results;
+		// About 170 ms per step at 8000 bodies, the reference stops before
+		if (bodyCount <= 2000)
+		{
+			results.emplace_back("AllPairsBroadPhase", Run(std::make_unique<AllPairsBroadPhase>(), bodyCount));
+		}
+		results.emplace_back("DynamicAABBTree", Run(std::make_unique<DynamicAABBTree>(), bodyCount));
+		results.emplace_back("SweepAndPrune", Run(std::make_unique<SweepAndPrune>(), bodyCount));
+		results.emplace_back("UniformGridBroadPhase", Run(std::make_unique<UniformGridBroadPhase>(), bodyCount));
+		for (const auto& [name, result] : results)
+		{
+			Logger::Log(std::to_string(bodyCount) + " bodies, " + name + ": move " + std::to_string(result.moveMilliseconds) + " ms, find pairs "
+				+ std::to_string(result.pairsMilliseconds) + " ms, " + std::to_string(result.pairCount) + " pairs");
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+class IBroadPhase;
+
+// Headless scene for comparing the broad phases: circles of a few sizes flying around a closed world above a floor of static boxes, like the obstacles of a level.
+// Every step moves the proxies of the circles and finds the pairs, without the narrow phase. Like StackingScene it builds its own coordinator, which becomes the current one.
+class BroadPhaseScene
+{
+public:
+	struct Result
+	{
+		double moveMilliseconds;	// Average time per step to move the proxies (PhysicsEngine::UpdateColliderProperties())
+		double pairsMilliseconds;	// Average time per step of IBroadPhase::FindPairs()
+		size_t pairCount;			// Pairs found in the last step, the same for every broad phase
+	};
+
+	// Simulate the scene for stepCount steps of 1/60 s. The bodies start at the same places for every broad phase
+	static Result Run(std::unique_ptr<IBroadPhase> broadPhase, size_t bodyCount, int stepCount = 300);
+
+	// Logs the results of DynamicAABBTree, SweepAndPrune and UniformGridBroadPhase for a few body counts, and of AllPairsBroadPhase as the reference (up to 2000 bodies)
+	static void LogComparison();
+
+	static constexpr float WORLD_WIDTH = 4000.f;
+	static constexpr float WORLD_HEIGHT = 2000.f;
+	static constexpr size_t STATIC_BOX_COUNT = 200;
+};
@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "BulletScene.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Games/GalaxyGolf/WorldSettings.h"
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+#include "src/EventManagement/EventManager.h"
+#include "src/Events/CollisionEvent.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+
+#include "src/Systems/CollisionSystem.h"
+#include "src/Systems/PhysicsSystem.h"
+#include "src/Systems/ConstraintSystem.h"
+
+#include "src/Utils/Logger.h"
+
+BulletScene::Result BulletScene::Run(const Target target, const bool isBullet)
+{
+	Result result{ SHOT_COUNT, 0, 0.f, 0.0 };
+	for (int shot = 1; shot <= SHOT_COUNT; shot++)
+	{
+		const float speed = SPEED_STEP * static_cast<float>(shot);
+		double velocitiesMicroseconds = 0.0;
+		if (Shoot(target, isBullet, speed, velocitiesMicroseconds))
+		{
+			if (result.tunnelCount == 0)
+			{
+				result.minTunnelSpeed = speed;
+			}
+			result.tunnelCount++;
+		}
+		result.velocitiesMicroseconds += velocitiesMicroseconds / SHOT_COUNT;
+	}
+	return result;
+}
+
+bool BulletScene::Shoot(const Target target, const bool isBullet, const float speed, double& outVelocitiesMicroseconds)
+{
+	Coordinator coordinator;
+	const auto eventManager = std::make_shared<EventManager>();
+	coordinator.AddSystem<CollisionSystem>();
+	coordinator.AddSystem<PhysicsSystem>();
+	coordinator.AddSystem<ConstraintSystem>();
+
+	auto& collisionSystem = coordinator.GetSystem<CollisionSystem>();
+	auto& physicsSystem = coordinator.GetSystem<PhysicsSystem>();
+	auto& constraintSystem = coordinator.GetSystem<ConstraintSystem>();
+	constraintSystem.SubscribeToEvents(eventManager);
+
+	// The wall stands at x = TARGET_DISTANCE and the ball flies right, the chain lies at y = 0 and the ball falls on it
+	Entity obstacle = coordinator.CreateEntity();
+	Vector2 ballPosition;
+	Vector2 ballVelocity;
+	if (target == Target::Wall)
+	{
+		obstacle.AddComponent<TransformComponent>(Vector2(TARGET_DISTANCE, 0.f), Vector2(1.f, 1.f));
+		obstacle.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f, 0.f, 0.f, 0.f, 0.7f);
+		obstacle.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+		obstacle.AddComponent<BoxColliderComponent>(WALL_THICKNESS, 4000.f);
+		ballVelocity = Vector2(speed, 0.f);
+	}
+	else
+	{
+		obstacle.AddComponent<TransformComponent>(Vector2(), Vector2(1.f, 1.f));
+		obstacle.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f, 0.f, 0.f, 0.f, 0.7f);
+		obstacle.AddComponent<ColliderTypeComponent>(ColliderType::Chain);
+		obstacle.AddComponent<ChainColliderComponent>(std::vector<Vector2>{ Vector2(-4000.f, 0.f), Vector2(0.f, 0.f), Vector2(4000.f, 0.f) });
+		ballPosition = Vector2(0.f, TARGET_DISTANCE);
+		ballVelocity = Vector2(0.f, -speed);
+	}
+
+	// Same body as the golf ball of GalaxyGolf::LoadLevel(), without restitution so a hit stays on its side
+	Entity ball = coordinator.CreateEntity();
+	ball.AddComponent<TransformComponent>(ballPosition, Vector2(1.f, 1.f));
+	ball.AddComponent<RigidBodyComponent>(ballVelocity, Vector2(), false, 10.f, 0.f, 0.f, 0.f, 0.7f);
+	ball.GetComponent<RigidBodyComponent>().isBullet = isBullet;
+	ball.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
+	ball.AddComponent<CircleColliderComponent>(BALL_RADIUS);
+
+	coordinator.Update();
+	physicsSystem.InitializeEntityPhysics();
+
+	// Same order as the physics steps of GalaxyGolf (see GalaxyGolf::AddSystemSteps())
+	constexpr float stepTime = 1.f / 60.f;
+	constexpr int stepCount = 30;
+	const WorldSettings worldSettings;
+	double velocitiesMicroseconds = 0.0;
+	for (int step = 0; step < stepCount; step++)
+	{
+		physicsSystem.UpdateForces(stepTime, worldSettings);
+		collisionSystem.Update(eventManager);
+		eventManager->FlushEvents<CollisionEvent>();
+		constraintSystem.Update(stepTime);
+
+		const auto start = std::chrono::steady_clock::now();
+		physicsSystem.UpdateVelocities(stepTime);
+		velocitiesMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+	outVelocitiesMicroseconds = velocitiesMicroseconds / stepCount;
+
+	const Vector2& position = ball.GetComponent<TransformComponent>().position;
+	return target == Target::Wall ? position.x > TARGET_DISTANCE : position.y < 0.f;
+}
+
+void BulletScene::LogTunnels()
+{
+	for (const Target target : { Target::Wall, Target::Chain })
+	{
+		for (const bool isBullet : { false, true })
+		{
+			const Result result = Run(target, isBullet);
+			Logger::Log(std::string(target == Target::Wall ? "Wall" : "Chain") + (isBullet ? ", bullet: " : ": ") + std::to_string(result.tunnelCount) + " of "
+				+ std::to_string(result.shotCount) + " shots tunneled, the slowest at " + std::to_string(result.minTunnelSpeed) + " px/s. UpdateVelocities() "
+				+ std::to_string(result.velocitiesMicroseconds) + " us per step");
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Headless scene for the continuous collision detection: a ball shot at a thin static wall or straight down at a terrain chain, at speeds up to a power shot and more.
+// Each shot counts as a tunnel if the ball ends up on the other side. Like StackingScene it builds its own coordinator for each shot, which becomes the current one.
+class BulletScene
+{
+public:
+	enum class Target
+	{
+		Wall,	// Static box WALL_THICKNESS wide
+		Chain,	// Flat terrain chain, like PCG::AddTerrain()
+	};
+
+	struct Result
+	{
+		int shotCount;
+		int tunnelCount;
+		float minTunnelSpeed;				// Slowest shot that tunneled, in pixels per second (0 if none did)
+		double velocitiesMicroseconds;		// Average time per step of PhysicsSystem::UpdateVelocities(), which sweeps the bullets
+	};
+
+	// Shoots the ball at speeds from SPEED_STEP to SHOT_COUNT * SPEED_STEP pixels per second, each shot simulated for 0.5 s at 60 Hz
+	static Result Run(Target target, bool isBullet);
+
+	// Logs the results for both targets, with and without RigidBodyComponent::isBullet
+	static void LogTunnels();
+
+	static constexpr int SHOT_COUNT = 40;
+	static constexpr float SPEED_STEP = 500.f;
+	static constexpr float BALL_RADIUS = 8.f;
+	static constexpr float WALL_THICKNESS = 10.f;
+	static constexpr float TARGET_DISTANCE = 300.f;
+
+private:
+	// Returns true if the ball tunneled
+	static bool Shoot(Target target, bool isBullet, float speed, double& outVelocitiesMicroseconds);
+};
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "ConstraintBenchmark.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/JointConstraintComponent.h"
+
+#include "src/Physics/PenetrationConstraint.h"
+#include "src/Systems/ConstraintSystem.h"
+
+#include "src/Utils/Logger.h"
+
+#include "AllocationCounter.h"
+
+ConstraintBenchmark::Result ConstraintBenchmark::Run(const size_t bodyCount, const int stepCount, const int solverIterations)
+{
+	Coordinator coordinator;
+
+	// Fixed seed, so every run solves the same constraints
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	// The inverse masses are set directly, the bodies have no collider to compute them from
+	std::vector<Entity> bodies;
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		const bool isStatic = i % 10 == 0;
+		Entity body = coordinator.CreateEntity();
+		body.AddComponent<TransformComponent>(Vector2(unit(random) * 500.f, unit(random) * 500.f), Vector2(1.f, 1.f), unit(random));
+		body.AddComponent<RigidBodyComponent>(Vector2(unit(random) * 50.f, unit(random) * 50.f), Vector2(), false, 1.f);
+		auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		rigidBody.inverseOfMass = isStatic ? 0.f : 0.5f + unit(random) * 0.4f;
+		rigidBody.inverseOfAngularMass = isStatic ? 0.f : 0.01f + unit(random) * 0.005f;
+		rigidBody.angularVelocity = unit(random);
+		rigidBody.friction = i % 3 == 0 ? 0.f : 0.5f;
+		rigidBody.restitution = 0.2f;
+		bodies.push_back(body);
+	}
+	coordinator.Update();
+
+	std::vector<PenetrationConstraint> penetrations;
+	std::vector<JointConstraintComponent> joints;
+	penetrations.reserve(bodyCount);
+	joints.reserve(bodyCount);
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		const Entity a = bodies[i];
+		const Vector2 position = a.GetComponent<TransformComponent>().position;
+		const Vector2 normal = Vector2(unit(random), unit(random)).Normalize();
+		penetrations.emplace_back(a, bodies[(i * 7 + 1) % bodyCount], position + Vector2(unit(random), unit(random)) * 10.f, position + Vector2(unit(random), unit(random)) * 10.f, normal);
+
+		auto& joint = joints.emplace_back(a, bodies[(i * 13 + 5) % bodyCount]);
+		joint.anchorPointForA = Vector2(unit(random) * 5.f, unit(random) * 5.f);
+		joint.anchorPointForB = Vector2(unit(random) * 5.f, unit(random) * 5.f);
+	}
+
+	// Same order as ConstraintSystem::SolveIsland()
+	constexpr float stepTime = 1.f / 60.f;
+	const size_t allocationCount = AllocationCounter::GetCount();
+	const auto start = std::chrono::steady_clock::now();
+	for (int step = 0; step < stepCount; step++)
+	{
+		for (auto& joint : joints)
+		{
+			ConstraintSystem::PreSolveJoint(joint, stepTime);
+		}
+		for (auto& penetration : penetrations)
+		{
+			ConstraintSystem::PreSolvePenetration(penetration, stepTime);
+		}
+		for (int iteration = 0; iteration < solverIterations; iteration++)
+		{
+			for (auto& joint : joints)
+			{
+				ConstraintSystem::SolveJoint(joint);
+			}
+			for (auto& penetration : penetrations)
+			{
+				ConstraintSystem::SolvePenetration(penetration);
+			}
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const size_t solveAllocations = AllocationCounter::GetCount() - allocationCount;
+
+	double velocityChecksum = 0.0;
+	for (const auto& body : bodies)
+	{
+		const auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		velocityChecksum += rigidBody.velocity.x + rigidBody.velocity.y * 3.0 + rigidBody.angularVelocity * 7.0;
+	}
+
+	const double solveCount = static_cast<double>(penetrations.size() + joints.size()) * solverIterations * stepCount;
+	return { solveCount / seconds, velocityChecksum, solveAllocations };
+}
+
+void ConstraintBenchmark::LogResults()
+{
+	const Result result = Run();
+	Logger::Log("Constraint solver: " + std::to_string(result.constraintsPerSecond / 1e6) + " M constraints per second, velocity checksum " + std::to_string(result.velocityChecksum)
+		+ ", " + std::to_string(result.solveAllocations) + " allocations while solving");
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+// Throughput of the constraint solver: PreSolve() and SolverIterations() x Solve() of random contacts and joints between random bodies, without the collision detection or the islands.
+// Like StackingScene it builds its own coordinator, which becomes the current one.
+class ConstraintBenchmark
+{
+public:
+	struct Result
+	{
+		double constraintsPerSecond;	// Constraint solves per second (one Solve() of one contact or joint), PreSolve() included in the time
+		double velocityChecksum;		// Weighted sum of every body velocity at the end, to compare two versions of the solver
+		size_t solveAllocations;		// Heap allocations during the PreSolve() and Solve() loop, 0 since the solver works on Vec and scalars
+	};
+
+	// bodyCount bodies, as many contacts and as many joints, every 10th body static. The same for every run
+	static Result Run(size_t bodyCount = 2000, int stepCount = 50, int solverIterations = 8);
+
+	// Logs the result of Run()
+	static void LogResults();
+};
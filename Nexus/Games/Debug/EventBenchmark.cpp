@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#include "EventBenchmark.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "src/ECS/Entity.h"
+#include "src/EventManagement/EventManager.h"
+#include "src/Events/ActionChangeEvent.h"
+#include "src/Events/CollisionEvent.h"
+#include "src/Events/LaunchBallEvent.h"
+#include "src/Events/PlayerStateChangeEvent.h"
+#include "src/Physics/Contact.h"
+#include "src/Utils/Logger.h"
+
+#include "AllocationCounter.h"
+#include "ListEventManager.h"
+
+template <typename TEvent>
+void EventBenchmark::Subscribe(ListEventManager& eventManager, Listener& listener)
+{
+	eventManager.SubscribeToEvent<TEvent, Listener>(&listener, &Listener::OnEvent<TEvent>);
+}
+
+template <typename TEvent>
+void EventBenchmark::Subscribe(EventManager& eventManager, Listener& listener)
+{
+	eventManager.SubscribeToEvent<TEvent, &Listener::OnEvent<TEvent>>(&listener);
+}
+
+template <typename TEventManager>
+void EventBenchmark::SubscribeSystems(TEventManager& eventManager, Listeners& listeners)
+{
+	Subscribe<ActionChangeEvent>(eventManager, listeners[0]);
+	Subscribe<CollisionEvent>(eventManager, listeners[1]);
+	Subscribe<CollisionEvent>(eventManager, listeners[2]);
+	Subscribe<LaunchBallEvent>(eventManager, listeners[2]);
+	Subscribe<PlayerStateChangeEvent>(eventManager, listeners[2]);
+	Subscribe<PlayerStateChangeEvent>(eventManager, listeners[3]);
+}
+
+template <typename TEventManager>
+double EventBenchmark::CountAllocations(const size_t frameCount, const bool isResubscribing)
+{
+	TEventManager eventManager;
+	Listeners listeners{};
+	SubscribeSystems(eventManager, listeners);
+
+	const Entity ball(1);
+	const Entity other(2);
+	std::vector<Contact> contacts(2);
+	const auto runFrame = [&]
+	{
+		if (isResubscribing)
+		{
+			eventManager.Reset();
+			SubscribeSystems(eventManager, listeners);
+		}
+		for (size_t i = 0; i < COLLISION_COUNT; i++)
+		{
+			eventManager.template EmitEvent<CollisionEvent>(ball, other, contacts);
+		}
+		eventManager.template EmitEvent<PlayerStateChangeEvent>(ball, true, Ability::NORMAL_SHOT);
+	};
+
+	// Not counted: the first frame grows the vectors of the EventManager
+	runFrame();
+	const size_t allocationCount = AllocationCounter::GetCount();
+	for (size_t frame = 0; frame < frameCount; frame++)
+	{
+		runFrame();
+	}
+	return static_cast<double>(AllocationCounter::GetCount() - allocationCount) / static_cast<double>(frameCount);
+}
+
+template <typename TEventManager, typename TEvent, typename... TArgs>
+double EventBenchmark::TimeEmit(std::vector<Listener>& listeners, TArgs&&... args)
+{
+	TEventManager eventManager;
+	for (auto& listener : listeners)
+	{
+		Subscribe<TEvent>(eventManager, listener);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < EMIT_COUNT; i++)
+	{
+		eventManager.template EmitEvent<TEvent>(args...);
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(EMIT_COUNT);
+}
+
+EventBenchmark::FrameAllocations EventBenchmark::CountFrameAllocations(const size_t frameCount)
+{
+	return { CountAllocations<ListEventManager>(frameCount, true), CountAllocations<EventManager>(frameCount, true), CountAllocations<EventManager>(frameCount, false) };
+}
+
+EventBenchmark::EmitTimes EventBenchmark::TimeEmit(const size_t subscriberCount)
+{
+	std::vector<Listener> listeners(subscriberCount);
+	const Entity ball(1);
+	const Entity other(2);
+	std::vector<Contact> contacts(2);
+
+	EmitTimes times{};
+	times.listCollisionNanoseconds = TimeEmit<ListEventManager, CollisionEvent>(listeners, ball, other, contacts);
+	times.collisionNanoseconds = TimeEmit<EventManager, CollisionEvent>(listeners, ball, other, contacts);
+	times.listPlayerStateNanoseconds = TimeEmit<ListEventManager, PlayerStateChangeEvent>(listeners, ball, true, Ability::NORMAL_SHOT);
+	times.playerStateNanoseconds = TimeEmit<EventManager, PlayerStateChangeEvent>(listeners, ball, true, Ability::NORMAL_SHOT);
+	return times;
+}
+
+void EventBenchmark::LogResults()
+{
+	const FrameAllocations allocations = CountFrameAllocations();
+	Logger::Log("Allocations per frame: ListEventManager resubscribing " + std::to_string(allocations.listResubscribe) + ", EventManager resubscribing "
+		+ std::to_string(allocations.resubscribe) + ", EventManager subscribed once " + std::to_string(allocations.persistent));
+
+	for (const size_t subscriberCount : { 1, 4, 16 })
+	{
+		const EmitTimes times = TimeEmit(subscriberCount);
+		Logger::Log(std::to_string(subscriberCount) + " subscribers, per emit: CollisionEvent " + std::to_string(times.listCollisionNanoseconds) + " vs "
+			+ std::to_string(times.collisionNanoseconds) + " ns, PlayerStateChangeEvent " + std::to_string(times.listPlayerStateNanoseconds) + " vs "
+			+ std::to_string(times.playerStateNanoseconds) + " ns (ListEventManager vs EventManager)");
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class ActionChangeEvent;
+class CollisionEvent;
+class EventManager;
+class LaunchBallEvent;
+class ListEventManager;
+class PlayerStateChangeEvent;
+
+// Benchmarks of the EventManager against ListEventManager, the std::map + std::list event manager it replaced.
+// The allocations are counted with AllocationCounter.
+class EventBenchmark
+{
+public:
+	// Heap allocations per frame
+	struct FrameAllocations
+	{
+		double listResubscribe;	// ListEventManager, Reset() and subscribe again every frame, like GalaxyGolf::Update() did
+		double resubscribe;		// EventManager, Reset() and subscribe again every frame
+		double persistent;		// EventManager, subscribed once
+	};
+
+	// Time per EmitEvent() call
+	struct EmitTimes
+	{
+		double listCollisionNanoseconds;	// ListEventManager, CollisionEvent of 2 contacts
+		double collisionNanoseconds;		// EventManager, CollisionEvent of 2 contacts
+		double listPlayerStateNanoseconds;	// ListEventManager, PlayerStateChangeEvent (nothing to copy)
+		double playerStateNanoseconds;		// EventManager, PlayerStateChangeEvent
+	};
+
+	// A GalaxyGolf frame: the 6 subscriptions of the input, constraint, gameplay and particle systems, then COLLISION_COUNT CollisionEvents of 2 contacts and a PlayerStateChangeEvent
+	static FrameAllocations CountFrameAllocations(size_t frameCount = 600);
+
+	// EMIT_COUNT events emitted to subscriberCount listeners
+	static EmitTimes TimeEmit(size_t subscriberCount);
+
+	// Logs the allocations per frame and the emit times with 1, 4 and 16 subscribers
+	static void LogResults();
+
+	static constexpr size_t COLLISION_COUNT = 20;
+	static constexpr size_t EMIT_COUNT = 200000;
+
+private:
+	// Stands in for a system, only counts the events it gets
+	struct Listener
+	{
+		size_t eventCount = 0;
+
+		template <typename TEvent>
+		void OnEvent(TEvent&) { eventCount++; }
+	};
+	// Input, constraint, gameplay and particle systems
+	using Listeners = std::array<Listener, 4>;
+
+	// One subscription, with the API of each event manager
+	template <typename TEvent>
+	static void Subscribe(ListEventManager& eventManager, Listener& listener);
+	template <typename TEvent>
+	static void Subscribe(EventManager& eventManager, Listener& listener);
+
+	// The subscriptions of GalaxyGolf
+	template <typename TEventManager>
+	static void SubscribeSystems(TEventManager& eventManager, Listeners& listeners);
+
+	template <typename TEventManager>
+	static double CountAllocations(size_t frameCount, bool isResubscribing);
+
+	template <typename TEventManager, typename TEvent, typename... TArgs>
+	static double TimeEmit(std::vector<Listener>& listeners, TArgs&&... args);
+};
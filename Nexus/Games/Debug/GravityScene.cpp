@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include "GravityScene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/Physics/GravityField.h"
+#include "src/Utils/Logger.h"
+
+GravityScene::Result GravityScene::Run(const size_t bodyCount, const float openingAngle)
+{
+	// Fixed seed, so both sums get the same bodies for every opening angle
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(0.f, WORLD_SIZE);
+	std::uniform_real_distribution<float> mass(1.f, 10.f);
+	GravityField field;
+	field.SetOpeningAngle(openingAngle);
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		field.Add(Vector2(position(random), position(random)), mass(random));
+	}
+
+	Result result{};
+	auto start = std::chrono::steady_clock::now();
+	field.ComputeForcesExact();
+	result.exactMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::vector<Vector2> exactForces(bodyCount);
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		exactForces[i] = field.GetForce(i);
+	}
+
+	start = std::chrono::steady_clock::now();
+	field.ComputeForcesBarnesHut();
+	result.barnesHutMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	result.nodeCount = field.GetNodeCount();
+
+	// Relative to the mean force: a body in the middle of the crowd gets almost no net force, its own relative error means little
+	double forceSum = 0.0;
+	double errorSum = 0.0;
+	double maxError = 0.0;
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		const double error = (field.GetForce(i) - exactForces[i]).Magnitude();
+		forceSum += exactForces[i].Magnitude();
+		errorSum += error;
+		maxError = std::max(maxError, error);
+	}
+	const double meanForce = forceSum / static_cast<double>(bodyCount);
+	result.meanError = errorSum / static_cast<double>(bodyCount) / meanForce;
+	result.maxError = maxError / meanForce;
+	return result;
+}
+
+void GravityScene::LogScaling()
+{
+	for (const size_t bodyCount : { 100, 1000, 5000, 20000 })
+	{
+		for (const float openingAngle : { 0.5f, 1.f })
+		{
+			const Result result = Run(bodyCount, openingAngle);
+			Logger::Log(std::to_string(bodyCount) + " bodies, opening angle " + std::to_string(openingAngle) + ": exact " + std::to_string(result.exactMilliseconds)
+				+ " ms, Barnes-Hut " + std::to_string(result.barnesHutMilliseconds) + " ms (" + std::to_string(result.nodeCount) + " nodes), mean error "
+				+ std::to_string(result.meanError * 100.0) + " %, max error " + std::to_string(result.maxError * 100.0) + " %");
+		}
+	}
+}
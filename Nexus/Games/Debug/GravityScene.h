@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+// Scaling of the N-body gravity (GravityField): the exact sum against Barnes-Hut for the same bodies, spread over a WORLD_SIZE square with masses from 1 to 10.
+// Barnes-Hut runs on the current JobSystem, the exact sum on the calling thread.
+class GravityScene
+{
+public:
+	struct Result
+	{
+		double exactMilliseconds;		// ComputeForcesExact()
+		double barnesHutMilliseconds;	// ComputeForcesBarnesHut()
+		double meanError;				// Mean of |Barnes-Hut force - exact force|, relative to the mean exact force
+		double maxError;				// Max of |Barnes-Hut force - exact force|, relative to the mean exact force
+		size_t nodeCount;				// Nodes of the quadtree
+	};
+
+	static Result Run(size_t bodyCount, float openingAngle = 0.5f);
+
+	// Logs the results for 100 to 20k bodies, with opening angles of 0.5 and 1
+	static void LogScaling();
+
+	static constexpr float WORLD_SIZE = 5000.f;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------
+// HashMapPool
+// Reference pool for PoolBenchmark: the Pool as it was before the paged sparse set, mapping the entity ids to the packed indices with two unordered_maps.
+//------------------------------------------------------------------------
+template <typename T>
+class HashMapPool
+{
+public:
+	explicit HashMapPool(size_t capacity = 100) { m_data.reserve(capacity); }
+
+	[[nodiscard]] size_t GetSize() const { return m_data.size(); }
+
+	void Set(size_t entityId, T object)
+	{
+		if (m_entityToIndex.find(entityId) != m_entityToIndex.end())
+		{
+			// If the element already exist, replace the component object
+			size_t index = m_entityToIndex[entityId];
+			m_data[index] = object;
+		}
+		else
+		{
+			size_t index = m_data.size();
+			m_entityToIndex.emplace(entityId, index);
+			m_indexToEntity.emplace(index, entityId);
+			if (index >= m_data.capacity())
+			{
+				m_data.reserve(m_data.capacity() * 2);
+			}
+			m_data.push_back(object);
+		}
+	}
+
+	void Remove(const size_t entityId)
+	{
+		// Copy the last element to the deleted position to keep the array packed
+		size_t indexOfRemoved = m_entityToIndex[entityId];
+		size_t indexOfLast = m_data.size() - 1;
+		m_data[indexOfRemoved] = m_data[indexOfLast];
+
+		// Update the index-entity maps to point to the correct elements
+		const size_t entityIdOfLastElement = m_indexToEntity[indexOfLast];
+		m_entityToIndex[entityIdOfLastElement] = indexOfRemoved;
+		m_indexToEntity[indexOfRemoved] = entityIdOfLastElement;
+
+		// Remove the last element from the vector
+		m_data.pop_back();
+
+		// Remove the mappings for the removed entity
+		m_entityToIndex.erase(entityId);
+		m_indexToEntity.erase(indexOfLast);
+	}
+
+	T& Get(const size_t entityId)
+	{
+		size_t index = m_entityToIndex[entityId];
+		return m_data[index];
+	}
+
+private:
+	std::vector<T> m_data;
+
+	// Map from an entity ID to a component pool index.
+	std::unordered_map<size_t, size_t> m_entityToIndex;
+
+	// Map from a component pool index to an entity ID.
+	std::unordered_map<size_t, size_t> m_indexToEntity;
+};
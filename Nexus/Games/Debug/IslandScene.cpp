@@ -0,0 +1,119 @@
+#include "stdafx.h"
+#include "IslandScene.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Games/GalaxyGolf/WorldSettings.h"
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+#include "src/EventManagement/EventManager.h"
+#include "src/Events/CollisionEvent.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+
+#include "src/Systems/CollisionSystem.h"
+#include "src/Systems/PhysicsSystem.h"
+#include "src/Systems/ConstraintSystem.h"
+
+#include "src/Utils/JobSystem.h"
+#include "src/Utils/Logger.h"
+
+IslandScene::Result IslandScene::Run(const size_t workerCount, const size_t pileCount, const int stepCount)
+{
+	JobSystem::Shutdown();
+	JobSystem::Initialize(workerCount);
+
+	Coordinator coordinator;
+	const auto eventManager = std::make_shared<EventManager>();
+	coordinator.AddSystem<CollisionSystem>();
+	coordinator.AddSystem<PhysicsSystem>();
+	coordinator.AddSystem<ConstraintSystem>();
+
+	auto& collisionSystem = coordinator.GetSystem<CollisionSystem>();
+	auto& physicsSystem = coordinator.GetSystem<PhysicsSystem>();
+	auto& constraintSystem = coordinator.GetSystem<ConstraintSystem>();
+	constraintSystem.SubscribeToEvents(eventManager);
+
+	// One static ground under all the piles, its top at y = 0. Static bodies don't join the islands
+	const float pileStride = BOX_SIZE * 3.f;
+	const float groundWidth = pileStride * static_cast<float>(pileCount);
+	Entity ground = coordinator.CreateEntity();
+	ground.AddComponent<TransformComponent>(Vector2(groundWidth / 2.f, -BOX_SIZE / 2.f), Vector2(1.f, 1.f));
+	ground.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f, 0.f, 0.f, 0.f, 0.7f);
+	ground.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+	ground.AddComponent<BoxColliderComponent>(groundWidth, BOX_SIZE);
+
+	// The boxes start a little apart and slightly shifted, so the piles settle instead of starting at rest
+	std::vector<Entity> boxes;
+	for (size_t pile = 0; pile < pileCount; pile++)
+	{
+		for (int i = 0; i < BOXES_PER_PILE; i++)
+		{
+			const float shift = (i % 2 == 0 ? 1.f : -1.f) * BOX_SIZE * 0.1f;
+			Entity box = coordinator.CreateEntity();
+			box.AddComponent<TransformComponent>(Vector2(pileStride * (static_cast<float>(pile) + 0.5f) + shift, BOX_SIZE * 1.1f * (static_cast<float>(i) + 0.5f)), Vector2(1.f, 1.f));
+			box.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 1.f, 0.f, 0.f, 0.f, 0.7f);
+			box.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+			box.AddComponent<BoxColliderComponent>(BOX_SIZE, BOX_SIZE);
+			boxes.push_back(box);
+		}
+	}
+
+	coordinator.Update();
+	physicsSystem.InitializeEntityPhysics();
+
+	// Same order as the physics steps of GalaxyGolf (see GalaxyGolf::AddSystemSteps()), only the constraints are timed
+	constexpr float stepTime = 1.f / 60.f;
+	const WorldSettings worldSettings;
+	double constraintMilliseconds = 0.0;
+	for (int step = 0; step < stepCount; step++)
+	{
+		physicsSystem.UpdateForces(stepTime, worldSettings);
+		collisionSystem.Update(eventManager);
+		eventManager->FlushEvents<CollisionEvent>();
+
+		const auto start = std::chrono::steady_clock::now();
+		constraintSystem.Update(stepTime);
+		constraintMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		physicsSystem.UpdateVelocities(stepTime);
+	}
+
+	// FNV-1a over the bits, any difference in the last bit of a float changes it
+	uint64_t hash = 14695981039346656037ull;
+	const auto addToHash = [&hash](const float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		hash = (hash ^ bits) * 1099511628211ull;
+	};
+	for (const auto& box : boxes)
+	{
+		const auto& transform = box.GetComponent<TransformComponent>();
+		addToHash(transform.position.x);
+		addToHash(transform.position.y);
+		addToHash(transform.rotation);
+	}
+
+	return { constraintMilliseconds / stepCount, constraintSystem.GetIslandCount(), hash };
+}
+
+void IslandScene::LogScaling()
+{
+	for (const size_t workerCount : { 0, 1, 3, 7 })
+	{
+		const Result result = Run(workerCount);
+		Logger::Log(std::to_string(workerCount + 1) + " threads: constraints " + std::to_string(result.constraintMilliseconds) + " ms per step, "
+			+ std::to_string(result.islandCount) + " islands, position hash " + std::to_string(result.positionHash));
+	}
+
+	JobSystem::Shutdown();
+	JobSystem::Initialize();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Headless scene for the island solver: many small piles of boxes, far enough apart that every pile is its own island, dropped on a static ground.
+// Run() restarts the JobSystem with the given worker count, so it shows how ConstraintSystem::Update() scales and checks that the result doesn't depend on the worker count.
+// Like StackingScene it builds its own coordinator, which becomes the current one.
+class IslandScene
+{
+public:
+	struct Result
+	{
+		double constraintMilliseconds;	// Average time per step of ConstraintSystem::Update()
+		size_t islandCount;				// Islands solved in the last step
+		uint64_t positionHash;			// Hash of the bits of every box position and rotation at the end, equal for every worker count
+	};
+
+	// Simulate the scene for stepCount steps of 1/60 s with workerCount JobSystem workers (0 solves on the calling thread)
+	static Result Run(size_t workerCount, size_t pileCount = 200, int stepCount = 60);
+
+	// Logs the results with 0, 1, 3 and 7 workers (1, 2, 4 and 8 threads with the calling one), then restarts the JobSystem with the default worker count
+	static void LogScaling();
+
+	static constexpr int BOXES_PER_PILE = 4;
+	static constexpr float BOX_SIZE = 40.f;
+};
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include "JobSystemBenchmark.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "src/Utils/JobSystem.h"
+#include "src/Utils/Logger.h"
+
+JobSystemBenchmark::Result JobSystemBenchmark::Run(const size_t workerCount)
+{
+	JobSystem::Initialize(workerCount);
+	Result result{};
+	const auto elapsedMicroseconds = [](const std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	// One job at a time: the whole round trip, with nothing else to overlap
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < JOB_COUNT; i++)
+	{
+		JobSystem::Wait(JobSystem::Schedule([] {}));
+	}
+	result.scheduleWaitMicroseconds = elapsedMicroseconds(start) / JOB_COUNT;
+
+	std::vector<JobSystem::JobHandle> jobs;
+	jobs.reserve(JOB_COUNT);
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < JOB_COUNT; i++)
+	{
+		jobs.push_back(JobSystem::Schedule([] {}));
+	}
+	for (const auto& job : jobs)
+	{
+		JobSystem::Wait(job);
+	}
+	result.batchMicroseconds = elapsedMicroseconds(start) / JOB_COUNT;
+
+	jobs.clear();
+	start = std::chrono::steady_clock::now();
+	jobs.push_back(JobSystem::Schedule([] {}));
+	for (size_t i = 1; i < JOB_COUNT; i++)
+	{
+		jobs.push_back(JobSystem::ContinueWith(jobs.back(), [] {}));
+	}
+	JobSystem::Wait(jobs.back());
+	result.continuationMicroseconds = elapsedMicroseconds(start) / JOB_COUNT;
+
+	// A loop with enough work per index to be worth splitting, like the particles
+	std::vector<float> values(LOOP_COUNT, 2.0f);
+	const auto loop = [&values](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			values[i] = std::sqrt(values[i] * 1.0001f + 1.0f);
+		}
+	};
+	start = std::chrono::steady_clock::now();
+	loop(0, LOOP_COUNT);
+	result.loopMilliseconds = elapsedMicroseconds(start) / 1000.0;
+
+	start = std::chrono::steady_clock::now();
+	JobSystem::ParallelFor(LOOP_COUNT, LOOP_GRAIN_SIZE, loop);
+	result.parallelForMilliseconds = elapsedMicroseconds(start) / 1000.0;
+
+	start = std::chrono::steady_clock::now();
+	JobSystem::ParallelFor(LOOP_COUNT, 64, loop);
+	result.fineParallelForMilliseconds = elapsedMicroseconds(start) / 1000.0;
+
+	return result;
+}
+
+void JobSystemBenchmark::LogResults()
+{
+	for (const size_t workerCount : { 0, 1, 3, 7 })
+	{
+		const Result result = Run(workerCount);
+		Logger::Log(std::to_string(workerCount) + " workers: schedule + wait " + std::to_string(result.scheduleWaitMicroseconds) + " us, batch "
+			+ std::to_string(result.batchMicroseconds) + " us, continuation " + std::to_string(result.continuationMicroseconds) + " us per job. Loop "
+			+ std::to_string(result.loopMilliseconds) + " ms, ParallelFor " + std::to_string(result.parallelForMilliseconds) + " ms, ranges of 64 "
+			+ std::to_string(result.fineParallelForMilliseconds) + " ms");
+	}
+
+	JobSystem::Initialize();
+}
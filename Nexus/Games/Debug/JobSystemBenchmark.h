@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Microbenchmarks of the JobSystem: the cost of a job (schedule, steal, continuation) and how ParallelFor() scales over a simple loop.
+// Run() restarts the JobSystem with the given worker count.
+class JobSystemBenchmark
+{
+public:
+	struct Result
+	{
+		double scheduleWaitMicroseconds;	// Schedule() then Wait() of one empty job
+		double batchMicroseconds;			// Per job, JOB_COUNT empty jobs scheduled at once then waited for (the workers steal them)
+		double continuationMicroseconds;	// Per job, a chain of JOB_COUNT jobs that each depend on the previous one
+		double loopMilliseconds;			// The ParallelFor() loop on the calling thread only
+		double parallelForMilliseconds;		// The same loop with ParallelFor(), ranges of LOOP_GRAIN_SIZE
+		double fineParallelForMilliseconds;	// The same loop with ranges of 64, mostly overhead
+	};
+
+	static Result Run(size_t workerCount);
+
+	// Logs the results with 0, 1, 3 and 7 workers, then restarts the JobSystem with the default worker count
+	static void LogResults();
+
+	static constexpr size_t JOB_COUNT = 10000;
+	static constexpr size_t LOOP_COUNT = 1 << 22;
+	static constexpr size_t LOOP_GRAIN_SIZE = 1 << 14;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <typeindex>
+
+#include "src/EventManagement/EventCallback.h"
+#include "src/Utils/Logger.h"
+
+//------------------------------------------------------------------------
+// ListEventManager
+// Reference event manager for EventBenchmark: the EventManager as it was before the persistent subscriptions and the flat dispatch.
+// A std::map from the event type to a std::list of heap callbacks, each one a std::function called through IEventCallback. The event is built again for every callback.
+//------------------------------------------------------------------------
+class ListEventManager
+{
+	using CallbackList = std::list<std::unique_ptr<IEventCallback>>;
+
+public:
+	// Clears the subscribers list
+	void Reset()
+	{
+		m_subscribers.clear();
+	}
+
+	template <typename TEvent, typename TOwner>
+	void SubscribeToEvent(TOwner* ownerInstance, std::function<void(TOwner*, TEvent&)> callbackFunction)
+	{
+		if (!m_subscribers[typeid(TEvent)].get())
+		{
+			m_subscribers[typeid(TEvent)] = std::make_unique<CallbackList>();
+		}
+		auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction);
+		m_subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+	}
+
+	template<typename TEvent, typename ...TArgs>
+	void EmitEvent(TArgs&& ...args)
+	{
+		if (const auto eventCallbacks = m_subscribers[typeid(TEvent)].get())
+		{
+			for (auto& callback : *eventCallbacks)
+			{
+				TEvent event(std::forward<TArgs>(args)...);
+				callback->Execute(event);
+			}
+		}
+		else
+		{
+			Logger::Warn("No callbacks for event type!");
+		}
+	}
+
+private:
+	std::map<std::type_index, std::unique_ptr<CallbackList>> m_subscribers;
+};
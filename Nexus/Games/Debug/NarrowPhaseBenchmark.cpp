@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include "NarrowPhaseBenchmark.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/PolygonColliderComponent.h"
+
+#include "src/Physics/Contact.h"
+#include "src/Physics/PhysicsEngine.h"
+#include "src/Systems/CollisionSystem.h"
+
+#include "src/Utils/Logger.h"
+
+NarrowPhaseBenchmark::Result NarrowPhaseBenchmark::Run(const size_t pairCount, const int roundCount)
+{
+	Coordinator coordinator;
+	coordinator.AddSystem<CollisionSystem>();
+
+	// Fixed seed, so every run tests the same pairs
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+	const auto createShape = [&](const Vector2 position)
+	{
+		Entity entity = coordinator.CreateEntity();
+		entity.AddComponent<TransformComponent>(position, Vector2(1.f, 1.f), unit(random) * 6.2831853f);
+		const int vertexCount = 3 + static_cast<int>(unit(random) * 6.f);
+		if (vertexCount == 4)
+		{
+			entity.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+			entity.AddComponent<BoxColliderComponent>(SHAPE_SIZE, SHAPE_SIZE * (0.5f + unit(random)));
+		}
+		else
+		{
+			// Regular polygon, anti-clockwise
+			std::vector<Vector2> vertices;
+			for (int i = 0; i < vertexCount; i++)
+			{
+				const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(vertexCount);
+				vertices.emplace_back(std::cos(angle) * SHAPE_SIZE / 2.f, std::sin(angle) * SHAPE_SIZE / 2.f);
+			}
+			entity.AddComponent<ColliderTypeComponent>(ColliderType::Polygon);
+			entity.AddComponent<PolygonColliderComponent>(vertices);
+		}
+		PhysicsEngine::UpdateColliderProperties(entity, entity.GetComponent<TransformComponent>());
+		return entity;
+	};
+
+	// The second shape of a pair is up to SHAPE_SIZE away in x and y, like pairs out of the broad phase
+	std::vector<std::pair<Entity, Entity>> pairs;
+	for (size_t i = 0; i < pairCount; i++)
+	{
+		const Vector2 position(static_cast<float>(i) * SHAPE_SIZE * 4.f, 0.f);
+		const Entity a = createShape(position);
+		const Entity b = createShape(position + Vector2((unit(random) * 2.f - 1.f) * SHAPE_SIZE, (unit(random) * 2.f - 1.f) * SHAPE_SIZE));
+		pairs.emplace_back(a, b);
+	}
+	coordinator.Update();
+
+	size_t collidingPairs = 0;
+	std::vector<Contact> contacts;
+	const auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < roundCount; round++)
+	{
+		collidingPairs = 0;
+		for (const auto& [a, b] : pairs)
+		{
+			contacts.clear();
+			if (CollisionSystem::IsColliding(a, b, a.GetComponent<ColliderTypeComponent>(), b.GetComponent<ColliderTypeComponent>(), contacts))
+			{
+				collidingPairs++;
+			}
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return { static_cast<double>(pairCount) * roundCount / seconds, collidingPairs };
+}
+
+void NarrowPhaseBenchmark::LogResults()
+{
+	const Result result = Run();
+	Logger::Log("Polygon-polygon: " + std::to_string(result.testsPerSecond / 1e6) + " M tests per second, " + std::to_string(result.collidingPairs) + " colliding pairs");
+}
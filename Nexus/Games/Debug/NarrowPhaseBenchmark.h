@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+// Times the polygon-polygon narrow phase (CollisionSystem::IsColliding() with the SAT) on fixed pairs of boxes and polygons with 3 to 8 vertices, about half of them overlapping.
+// Like StackingScene it builds its own coordinator, which becomes the current one.
+class NarrowPhaseBenchmark
+{
+public:
+	struct Result
+	{
+		double testsPerSecond;	// Polygon-polygon tests per second, contacts included
+		size_t collidingPairs;	// Pairs that collide, the same for every run with the same pairCount
+	};
+
+	// Tests every pair roundCount times. The shapes and their places are the same for every run
+	static Result Run(size_t pairCount = 1000, int roundCount = 200);
+
+	// Logs the result of Run()
+	static void LogResults();
+
+	static constexpr float SHAPE_SIZE = 40.f;
+};
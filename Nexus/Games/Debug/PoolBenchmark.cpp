@@ -0,0 +1,80 @@
+#include "stdafx.h"
+#include "PoolBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/Components/TransformComponent.h"
+#include "src/ECS/Pool.h"
+#include "src/Utils/Logger.h"
+
+#include "HashMapPool.h"
+
+template <typename TPool>
+PoolBenchmark::Times PoolBenchmark::Measure(const std::vector<size_t>& entityIds, const std::vector<size_t>& shuffledIds)
+{
+	Times times{};
+	const auto elapsedNanoseconds = [](const std::chrono::steady_clock::time_point start, const size_t count)
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(count);
+	};
+
+	// Default capacity, like the pools of the Coordinator
+	TPool pool;
+	auto start = std::chrono::steady_clock::now();
+	for (const size_t entityId : entityIds)
+	{
+		pool.Set(entityId, TransformComponent(Vector2(static_cast<float>(entityId), 0.f), Vector2(1.f, 1.f)));
+	}
+	times.insertNanoseconds = elapsedNanoseconds(start, entityIds.size());
+
+	// The sum also keeps the compiler from skipping the lookups
+	double positionSum = 0.0;
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < GET_ROUND_COUNT; round++)
+	{
+		for (const size_t entityId : shuffledIds)
+		{
+			positionSum += pool.Get(entityId).position.x;
+		}
+	}
+	times.getNanoseconds = elapsedNanoseconds(start, shuffledIds.size() * GET_ROUND_COUNT);
+	times.positionSum = positionSum;
+
+	const size_t removeCount = shuffledIds.size() / 2;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < removeCount; i++)
+	{
+		pool.Remove(shuffledIds[i]);
+	}
+	times.removeNanoseconds = elapsedNanoseconds(start, removeCount);
+
+	return times;
+}
+
+PoolBenchmark::Result PoolBenchmark::Run(const size_t entityCount)
+{
+	std::vector<size_t> entityIds(entityCount);
+	std::iota(entityIds.begin(), entityIds.end(), size_t{ 0 });
+	std::vector<size_t> shuffledIds = entityIds;
+	std::shuffle(shuffledIds.begin(), shuffledIds.end(), std::mt19937(42));
+
+	return { Measure<Pool<TransformComponent>>(entityIds, shuffledIds), Measure<HashMapPool<TransformComponent>>(entityIds, shuffledIds) };
+}
+
+void PoolBenchmark::LogResults()
+{
+	for (const size_t entityCount : { 1000, 10000, 100000 })
+	{
+		const Result result = Run(entityCount);
+		const auto toString = [](const Times& times)
+		{
+			return "insert " + std::to_string(times.insertNanoseconds) + " ns, get " + std::to_string(times.getNanoseconds) + " ns, remove " + std::to_string(times.removeNanoseconds) + " ns";
+		};
+		Logger::Log(std::to_string(entityCount) + " entities: Pool " + toString(result.pool) + ". HashMapPool " + toString(result.hashMapPool));
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Microbenchmarks of the component Pool (paged sparse set) against HashMapPool, the unordered_map pool it replaced.
+// The component is a TransformComponent. Each pool inserts the same entity ids, looks them all up in a shuffled order, then removes half of them in a shuffled order.
+class PoolBenchmark
+{
+public:
+	struct Times
+	{
+		double insertNanoseconds;	// Per Set() of a new entity
+		double getNanoseconds;		// Per Get()
+		double removeNanoseconds;	// Per Remove()
+		double positionSum;			// Sum of the positions looked up, the same for both pools
+	};
+
+	struct Result
+	{
+		Times pool;
+		Times hashMapPool;
+	};
+
+	static Result Run(size_t entityCount);
+
+	// Logs the results with 1k, 10k and 100k entities
+	static void LogResults();
+
+	// Every id is looked up this many times
+	static constexpr int GET_ROUND_COUNT = 10;
+
+private:
+	// Same steps for both pools, only the pool type changes
+	template <typename TPool>
+	static Times Measure(const std::vector<size_t>& entityIds, const std::vector<size_t>& shuffledIds);
+};
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "RayCastBenchmark.h"
+#include "BroadPhaseScene.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+
+#include "src/Physics/PhysicsQuery.h"
+#include "src/Systems/CollisionSystem.h"
+
+#include "src/Utils/Logger.h"
+
+#include "AllocationCounter.h"
+
+RayCastBenchmark::Result RayCastBenchmark::Run(const size_t bodyCount, const int frameCount)
+{
+	Coordinator coordinator;
+	coordinator.AddSystem<CollisionSystem>();
+	const PhysicsQuery& query = coordinator.GetSystem<CollisionSystem>().GetQuery();
+
+	// Same world as BroadPhaseScene: a floor of static boxes 20 px apart and circles of a few sizes, standing still here
+	constexpr float worldWidth = BroadPhaseScene::WORLD_WIDTH;
+	constexpr float worldHeight = BroadPhaseScene::WORLD_HEIGHT;
+	const float boxStride = worldWidth / static_cast<float>(BroadPhaseScene::STATIC_BOX_COUNT);
+	for (size_t i = 0; i < BroadPhaseScene::STATIC_BOX_COUNT; i++)
+	{
+		Entity box = coordinator.CreateEntity();
+		box.AddComponent<TransformComponent>(Vector2(boxStride * (static_cast<float>(i) + 0.5f), 20.f), Vector2(1.f, 1.f));
+		box.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f);
+		box.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+		box.AddComponent<BoxColliderComponent>(boxStride - 4.f, 40.f);
+	}
+
+	// Fixed seed, so every run casts the same rays at the same bodies
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> positionX(0.f, worldWidth);
+	std::uniform_real_distribution<float> positionY(0.f, worldHeight);
+	std::uniform_real_distribution<float> radius(5.f, 30.f);
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		Entity body = coordinator.CreateEntity();
+		body.AddComponent<TransformComponent>(Vector2(positionX(random), positionY(random)), Vector2(1.f, 1.f));
+		body.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 1.f);
+		body.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
+		body.AddComponent<CircleColliderComponent>(radius(random));
+	}
+	coordinator.Update();
+
+	// Rays in every direction, like lasers and the trajectory preview
+	std::uniform_real_distribution<float> angle(0.f, 2.f * 3.14159265f);
+	std::uniform_real_distribution<float> length(MAX_RAY_LENGTH * 0.1f, MAX_RAY_LENGTH);
+	std::vector<Vector2> starts(RAY_COUNT);
+	std::vector<Vector2> ends(RAY_COUNT);
+	for (size_t i = 0; i < RAY_COUNT; i++)
+	{
+		const float rayAngle = angle(random);
+		starts[i] = Vector2(positionX(random), positionY(random));
+		ends[i] = starts[i] + Vector2(std::cos(rayAngle), std::sin(rayAngle)) * length(random);
+	}
+
+	std::vector<QueryHit> hits;
+	QueryHit closestHit;
+	Result result{};
+	const auto castRays = [&]
+	{
+		result.hitCount = 0;
+		const auto rayCastStart = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < RAY_COUNT; i++)
+		{
+			result.hitCount += query.RayCast(starts[i], ends[i], hits);
+		}
+		const auto closestStart = std::chrono::steady_clock::now();
+		result.closestHitCount = 0;
+		for (size_t i = 0; i < RAY_COUNT; i++)
+		{
+			result.closestHitCount += query.RayCastClosest(starts[i], ends[i], closestHit) ? 1 : 0;
+		}
+		const auto closestEnd = std::chrono::steady_clock::now();
+		result.rayCastMilliseconds += std::chrono::duration<double, std::milli>(closestStart - rayCastStart).count();
+		result.rayCastClosestMilliseconds += std::chrono::duration<double, std::milli>(closestEnd - closestStart).count();
+	};
+
+	// Warm up: the hits vector and the candidates buffer of the query grow to their size
+	castRays();
+	result.rayCastMilliseconds = 0.0;
+	result.rayCastClosestMilliseconds = 0.0;
+
+	const size_t allocationCount = AllocationCounter::GetCount();
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		castRays();
+	}
+	result.allocationCount = AllocationCounter::GetCount() - allocationCount;
+	result.rayCastMilliseconds /= frameCount;
+	result.rayCastClosestMilliseconds /= frameCount;
+	return result;
+}
+
+void RayCastBenchmark::LogResults()
+{
+	for (const size_t bodyCount : { 500, 2000, 8000 })
+	{
+		const Result result = Run(bodyCount);
+		Logger::Log(std::to_string(bodyCount) + " bodies, " + std::to_string(RAY_COUNT) + " rays: RayCast " + std::to_string(result.rayCastMilliseconds) + " ms ("
+			+ std::to_string(result.hitCount) + " hits), RayCastClosest " + std::to_string(result.rayCastClosestMilliseconds) + " ms (" + std::to_string(result.closestHitCount)
+			+ " rays hit), " + std::to_string(result.allocationCount) + " allocations");
+	}
+}
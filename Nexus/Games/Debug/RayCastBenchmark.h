@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+// Benchmark of the PhysicsQuery ray casts: RAY_COUNT rays per frame through the world of BroadPhaseScene (circles above a floor of static boxes), with the default broad phase of the CollisionSystem.
+// The rays are cast once before the timed frames, then AllocationCounter checks that the timed frames don't allocate. Like StackingScene it builds its own coordinator, which becomes the current one.
+class RayCastBenchmark
+{
+public:
+	struct Result
+	{
+		double rayCastMilliseconds;			// Average time per frame of RAY_COUNT RayCast() (every hit, sorted)
+		double rayCastClosestMilliseconds;	// Average time per frame of RAY_COUNT RayCastClosest()
+		size_t hitCount;					// Hits of the RayCast() calls of one frame
+		size_t closestHitCount;				// Rays of one frame that hit something
+		size_t allocationCount;				// Allocations during the timed frames, 0 expected
+	};
+
+	// Cast the same RAY_COUNT rays, of up to MAX_RAY_LENGTH, for frameCount frames
+	static Result Run(size_t bodyCount, int frameCount = 20);
+
+	// Logs the results for 500, 2000 and 8000 bodies
+	static void LogResults();
+
+	static constexpr size_t RAY_COUNT = 10000;
+	static constexpr float MAX_RAY_LENGTH = 1000.f;
+};
@@ -0,0 +1,109 @@
+#include "stdafx.h"
+#include "StackingScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Games/GalaxyGolf/WorldSettings.h"
+#include "src/ECS/Coordinator.h"
+#include "src/ECS/Entity.h"
+#include "src/EventManagement/EventManager.h"
+#include "src/Events/CollisionEvent.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/BoxColliderComponent.h"
+
+#include "src/Systems/CollisionSystem.h"
+#include "src/Systems/PhysicsSystem.h"
+#include "src/Systems/ConstraintSystem.h"
+
+#include "src/Utils/Logger.h"
+
+StackingScene::Result StackingScene::Run(const int boxCount, const int solverIterations, const bool isWarmStarting, const float seconds)
+{
+	Coordinator coordinator;
+	const auto eventManager = std::make_shared<EventManager>();
+	coordinator.AddSystem<CollisionSystem>();
+	coordinator.AddSystem<PhysicsSystem>();
+	coordinator.AddSystem<ConstraintSystem>();
+
+	auto& collisionSystem = coordinator.GetSystem<CollisionSystem>();
+	auto& physicsSystem = coordinator.GetSystem<PhysicsSystem>();
+	auto& constraintSystem = coordinator.GetSystem<ConstraintSystem>();
+	constraintSystem.SetSolverIterations(solverIterations);
+	constraintSystem.SetWarmStarting(isWarmStarting);
+	constraintSystem.SubscribeToEvents(eventManager);
+
+	// Static ground, its top at y = 0
+	Entity ground = coordinator.CreateEntity();
+	ground.AddComponent<TransformComponent>(Vector2(0.f, -BOX_SIZE / 2.f), Vector2(1.f, 1.f));
+	ground.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.f, 0.f, 0.f, 0.f, 0.7f);
+	ground.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+	ground.AddComponent<BoxColliderComponent>(BOX_SIZE * 20.f, BOX_SIZE);
+
+	// The boxes start just touching, no restitution so the stack settles instead of bouncing
+	std::vector<Entity> boxes;
+	for (int i = 0; i < boxCount; i++)
+	{
+		Entity box = coordinator.CreateEntity();
+		box.AddComponent<TransformComponent>(Vector2(0.f, BOX_SIZE * (static_cast<float>(i) + 0.5f)), Vector2(1.f, 1.f));
+		box.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 1.f, 0.f, 0.f, 0.f, 0.7f);
+		box.AddComponent<ColliderTypeComponent>(ColliderType::Box);
+		box.AddComponent<BoxColliderComponent>(BOX_SIZE, BOX_SIZE);
+		boxes.push_back(box);
+	}
+
+	coordinator.Update();
+	physicsSystem.InitializeEntityPhysics();
+
+	// Same order as the physics steps of GalaxyGolf (see GalaxyGolf::AddSystemSteps())
+	const WorldSettings worldSettings;
+	const int stepCount = static_cast<int>(seconds / STEP_TIME);
+	for (int step = 0; step < stepCount; step++)
+	{
+		physicsSystem.UpdateForces(STEP_TIME, worldSettings);
+		collisionSystem.Update(eventManager);
+		eventManager->FlushEvents<CollisionEvent>();
+		constraintSystem.Update(STEP_TIME);
+		physicsSystem.UpdateVelocities(STEP_TIME);
+	}
+
+	const Vector2 topPosition = boxes.back().GetComponent<TransformComponent>().position;
+	Result result{};
+	result.topDrift = std::abs(topPosition.x);
+	result.topSag = std::max(0.f, BOX_SIZE * (static_cast<float>(boxCount) - 0.5f) - topPosition.y);
+	for (const auto& box : boxes)
+	{
+		result.maxTilt = std::max(result.maxTilt, std::abs(box.GetComponent<TransformComponent>().rotation) * 180.f / 3.14159265f);
+	}
+	result.warmStarted = constraintSystem.GetWarmStartedCount();
+	result.isStanding = result.topDrift < BOX_SIZE / 4.f && result.topSag < BOX_SIZE / 4.f && result.maxTilt < 10.f;
+	return result;
+}
+
+int StackingScene::FindIterationsNeeded(const int boxCount, const bool isWarmStarting, const int maxIterations)
+{
+	for (int iterations = 1; iterations <= maxIterations; iterations++)
+	{
+		if (Run(boxCount, iterations, isWarmStarting).isStanding)
+		{
+			return iterations;
+		}
+	}
+	return 0;
+}
+
+void StackingScene::LogIterationsNeeded()
+{
+	for (const int boxCount : { 5, 10, 20 })
+	{
+		Logger::Log("Stack of " + std::to_string(boxCount) + " boxes, solver iterations needed: "
+			+ std::to_string(FindIterationsNeeded(boxCount, true)) + " warm started, "
+			+ std::to_string(FindIterationsNeeded(boxCount, false)) + " cold (0 = never stands)");
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+// Headless scene for tuning the constraint solver: a column of boxes dropped on a static ground, simulated in fixed steps without rendering or assets.
+// It builds its own coordinator, which becomes the current one (see Coordinator::MakeCurrent()). Run it before a game is created, or make the game's coordinator current again after.
+class StackingScene
+{
+public:
+	struct Result
+	{
+		float topDrift;			// How far (in pixels) the top box ended from where it started, sideways
+		float topSag;			// How far (in pixels) the top box sank below its resting height
+		float maxTilt;			// Largest rotation (in degrees) of any box at the end
+		size_t warmStarted;		// Contacts warm started in the last step
+		bool isStanding;		// The stack kept its shape: drift and sag under a quarter of a box, tilt under 10 degrees
+	};
+
+	// Simulate the stack for 'seconds' with the given solver settings
+	static Result Run(int boxCount, int solverIterations, bool isWarmStarting, float seconds = 10.f);
+
+	// Fewest solver iterations (up to maxIterations) that keep the stack standing. 0 if none does
+	static int FindIterationsNeeded(int boxCount, bool isWarmStarting, int maxIterations = 32);
+
+	// Logs the iterations needed by stacks of a few heights, with and without warm starting
+	static void LogIterationsNeeded();
+
+	static constexpr float BOX_SIZE = 40.f;
+	static constexpr float STEP_TIME = 1.f / 60.f;
+};
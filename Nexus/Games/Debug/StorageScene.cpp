@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "StorageScene.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "src/ECS/Entity.h"
+
+#include "src/Components/TransformComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+
+#include "src/Systems/PhysicsSystem.h"
+
+#include "src/Utils/Logger.h"
+
+StorageScene::Result StorageScene::Run(const StorageMode storageMode, const bool isPerBody, const size_t bodyCount, const int stepCount)
+{
+	Coordinator coordinator(storageMode);
+	coordinator.AddSystem<PhysicsSystem>();
+	auto& physicsSystem = coordinator.GetSystem<PhysicsSystem>();
+
+	// The same bodies in the same order for both modes, with a spread of velocities so every one ends somewhere else
+	std::vector<Entity> bodies;
+	bodies.reserve(bodyCount);
+	for (size_t i = 0; i < bodyCount; i++)
+	{
+		const float x = static_cast<float>(i % 1000);
+		const float y = static_cast<float>(i / 1000);
+		const bool isKinematic = i % 10 == 0;
+		const float mass = i % 100 == 1 ? 0.f : 1.f + static_cast<float>(i % 7);
+		Entity body = coordinator.CreateEntity();
+		body.AddComponent<TransformComponent>(Vector2(x * 4.f, y * 4.f), Vector2(1.f, 1.f));
+		body.AddComponent<RigidBodyComponent>(Vector2(x - 500.f, y * 2.f), isKinematic ? Vector2(0.f, -9.8f) : Vector2(), isKinematic, mass, 0.01f * x);
+		bodies.push_back(body);
+	}
+
+	coordinator.Update();
+	physicsSystem.InitializeEntityPhysics();
+
+	// A force on every dynamic body before each step, like the weight and the wind added by UpdateForces(). Not timed
+	constexpr float stepTime = 1.f / 60.f;
+	double integrateMilliseconds = 0.0;
+	for (int step = 0; step < stepCount; step++)
+	{
+		coordinator.View<RigidBodyComponent>().ForEach([](Entity, RigidBodyComponent& rigidBody)
+		{
+			rigidBody.AddForce(Vector2(10.f, -100.f * rigidBody.mass));
+			rigidBody.AddTorque(rigidBody.mass);
+		});
+
+		const auto start = std::chrono::steady_clock::now();
+		if (isPerBody)
+		{
+			IntegratePerBody(coordinator, stepTime);
+		}
+		else
+		{
+			physicsSystem.IntegrateForces(stepTime);
+			physicsSystem.IntegrateVelocities(stepTime);
+		}
+		integrateMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// FNV-1a over the bits, in entity creation order since the two modes iterate the bodies in a different order
+	uint64_t hash = 14695981039346656037ull;
+	const auto addToHash = [&hash](const float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		hash = (hash ^ bits) * 1099511628211ull;
+	};
+	for (const auto& body : bodies)
+	{
+		const auto& transform = body.GetComponent<TransformComponent>();
+		const auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		addToHash(transform.position.x);
+		addToHash(transform.position.y);
+		addToHash(transform.rotation);
+		addToHash(rigidBody.velocity.x);
+		addToHash(rigidBody.velocity.y);
+		addToHash(rigidBody.angularVelocity);
+	}
+
+	return { integrateMilliseconds / stepCount, hash };
+}
+
+void StorageScene::LogComparison()
+{
+	for (const size_t bodyCount : { 50000, 100000 })
+	{
+		const Result pools = Run(StorageMode::Pools, false, bodyCount);
+		const Result perBody = Run(StorageMode::Archetypes, true, bodyCount);
+		const Result chunks = Run(StorageMode::Archetypes, false, bodyCount);
+		const bool isSameState = pools.stateHash == perBody.stateHash && perBody.stateHash == chunks.stateHash;
+		Logger::Log(std::to_string(bodyCount) + " bodies, integrate step: pools " + std::to_string(pools.integrateMilliseconds) + " ms, archetypes one body at a time "
+			+ std::to_string(perBody.integrateMilliseconds) + " ms, archetypes by chunk " + std::to_string(chunks.integrateMilliseconds) + " ms per step. Final state "
+			+ (isSameState ? "identical" : "DIFFERENT"));
+	}
+}
+
+void StorageScene::IntegratePerBody(Coordinator& coordinator, const float deltaTime)
+{
+	auto view = coordinator.View<TransformComponent, RigidBodyComponent>();
+	view.ForEach([deltaTime](Entity, TransformComponent&, RigidBodyComponent& rigidBody)
+	{
+		if (rigidBody.isAwake)
+		{
+			PhysicsEngine::IntegrateForces(rigidBody, deltaTime);
+		}
+	});
+	view.ForEach([deltaTime](Entity, TransformComponent& transform, RigidBodyComponent& rigidBody)
+	{
+		if (!rigidBody.isAwake)
+		{
+			return;
+		}
+		if (rigidBody.isKinematic)
+		{
+			PhysicsEngine::IntegrateKinematic(rigidBody, transform, deltaTime);
+		}
+		else
+		{
+			PhysicsEngine::IntegrateVelocities(rigidBody, transform, deltaTime);
+		}
+	});
+}
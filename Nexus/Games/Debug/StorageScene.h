@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "src/ECS/Coordinator.h"
+
+// Headless scene for the two storage modes of the Coordinator: bodies without colliders flying around, only integrated by PhysicsSystem::IntegrateForces()/IntegrateVelocities().
+// With the archetypes these integrate whole chunks with SSE2, the per body run is the scalar reference.
+// Like StackingScene it builds its own coordinator, which becomes the current one.
+class StorageScene
+{
+public:
+	struct Result
+	{
+		double integrateMilliseconds;	// Average time per step of IntegrateForces() + IntegrateVelocities()
+		uint64_t stateHash;				// Hash of the bits of every body position, rotation and velocity at the end, equal for every run
+	};
+
+	// Simulate bodyCount bodies for stepCount steps of 1/60 s. Every 10th body is kinematic and every 100th static.
+	// isPerBody integrates with the PhysicsEngine functions of one body instead of the PhysicsSystem ones
+	static Result Run(StorageMode storageMode, bool isPerBody = false, size_t bodyCount = 50000, int stepCount = 60);
+
+	// Logs the results with the pools, the archetypes one body at a time and the archetypes by chunk, for 50k and 100k bodies
+	static void LogComparison();
+
+private:
+	static void IntegratePerBody(Coordinator& coordinator, float deltaTime);
+};
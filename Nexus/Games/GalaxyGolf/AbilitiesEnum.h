@@ -5,4 +5,18 @@ enum class Ability
 	NORMAL_SHOT,
 	POWER_SHOT,
 	WEAK_SHOT
-};
\ No newline at end of file
+};
+
+// Multiplier of the launch force of each shot, shared by the GameplaySystem and the trajectory preview
+constexpr float GetShotForceScale(const Ability ability)
+{
+	switch (ability)
+	{
+	case Ability::POWER_SHOT:
+		return 2.0f;
+	case Ability::WEAK_SHOT:
+		return 0.5f;
+	default:
+		return 1.0f;
+	}
+}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "GalaxyGolf.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -9,6 +10,7 @@
 #include "Games/UI/UIEffects.h"
 #include "src/ECS/Entity.h"
 #include "src/ECS/Coordinator.h"
+#include "src/ECS/SystemScheduler.h"
 #include "src/EventManagement/EventManager.h"
 #include "src/InputManagement/InputManager.h"
 #include "src/InputManagement/InputEnums.h"
@@ -43,9 +45,11 @@
 
 #include "src/Physics/Particle.h"
 #include "src/Utils/Vector2.h"
+#include "src/Utils/JobSystem.h"
 #include "src/Utils/Logger.h"
 
 #include "src/Events/ActionChangeEvent.h"
+#include "src/Events/CollisionEvent.h"
 #include "src/Systems/GameplaySystem.h"
 #include "src/Systems/PlayerSystem.h"
 #include "src/Systems/TrajectorySystem.h"
@@ -59,6 +63,9 @@ GalaxyGolf::GalaxyGolf(WorldType worldType, std::weak_ptr<GameState> gameState,
 	m_isDebug = false;
 
 	m_coordinator = std::make_unique<Coordinator>();
+	m_gameplayScheduler = std::make_unique<SystemScheduler>();
+	m_systemScheduler = std::make_unique<SystemScheduler>();
+	m_physicsScheduler = std::make_unique<SystemScheduler>();
 	m_eventManager = std::make_shared<EventManager>();
 	m_inputManager = std::make_unique<InputManager>();
 	m_assetManager = std::make_unique<AssetManager>();
@@ -111,6 +118,15 @@ void GalaxyGolf::Initialize()
 	m_coordinator->AddSystem<GameplaySystem>(m_coordinator, m_assetManager, m_audioManager, m_gameState, m_score);
 	m_coordinator->AddSystem<PlayerSystem>();
 	m_coordinator->AddSystem<TrajectorySystem>();
+	AddSystemSteps();
+
+	//------------------------------------------------------------------------
+	// Perform the subscription of the events for all systems. The subscriptions last as long as the event manager
+	m_coordinator->GetSystem<InputSystem>().SubscribeToEvents(m_eventManager);
+	// m_coordinator->GetSystem<PhysicsSystem>().SubscribeToEvents(m_eventManager); // For collision resolution on collision
+	m_coordinator->GetSystem<ConstraintSystem>().SubscribeToEvents(m_eventManager); // To clear the penetration vector and populate it on every collision
+	m_coordinator->GetSystem<GameplaySystem>().SubscribeToEvents(m_eventManager);
+	m_coordinator->GetSystem<ParticleEffectSystem>().SubscribeToEvents(m_eventManager); // Change particles based on the shot type
 
 	LoadLevel(1);
 
@@ -189,6 +205,7 @@ void GalaxyGolf::LoadLevel(int level)
 	playerOne.AddComponent<SpriteComponent>("golf-ball", 3);
 	playerOne.AddComponent<TransformComponent>(Vector2(-100.f, 300.f), Vector2(0.5f, 0.5f), -0.3f);
 	playerOne.AddComponent<RigidBodyComponent>(Vector2(0.0f, 0.0f), Vector2(), false, 10.f, 0.f, 0.0f, 1.f, 0.7f);
+	playerOne.GetComponent<RigidBodyComponent>().isBullet = true; // Power shots are fast enough to go through the thin terrain and obstacles in one step
 	playerOne.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
 	playerOne.AddComponent<CircleColliderComponent>(m_assetManager->GetSpriteWidth("golf-ball") / 4);
 	playerOne.AddComponent<PlayerComponent>(Input::PlayerID::PLAYER_1);
@@ -225,38 +242,31 @@ void GalaxyGolf::Update(float deltaTime)
 {
 
 	ProcessInput();
-	// TODO: For event system maybe find a more performant way to just subscribing the event once instead of resetting and subscribing over and over. Maybe a buffer of subscriptions that are only added and removed at certain "events" or for a certain object ID. Example, when an entity is removed, remove all the events associated with that entity.
 
 	//------------------------------------------------------------------------
-	// Reset all event callbacks for the current frame
-	m_eventManager->Reset();
+	// Update the coordinator to process the entities that are waiting to be created/deleted
+	m_coordinator->Update();
 
 	//------------------------------------------------------------------------
-	// Perform the subscription of the events for all systems
-	m_coordinator->GetSystem<InputSystem>().SubscribeToEvents(m_eventManager);
-	// m_coordinator->GetSystem<PhysicsSystem>().SubscribeToEvents(m_eventManager); // For collision resolution on collision
-	m_coordinator->GetSystem<ConstraintSystem>().SubscribeToEvents(m_eventManager); // To clear the penetration vector and populate it on every collision
-	m_coordinator->GetSystem<GameplaySystem>().SubscribeToEvents(m_eventManager);
-	m_coordinator->GetSystem<ParticleEffectSystem>().SubscribeToEvents(m_eventManager); // Change particles based on the shot type
+	// Gameplay and animation, before the physics like they always did (see AddSystemSteps())
+	m_gameplayScheduler->Run(deltaTime);
+
 	//------------------------------------------------------------------------
-	// Update the coordinator to process the entities that are waiting to be created/deleted
-	m_coordinator->Update();
+	// Simulate the physics in fixed steps, so it doesn't depend on the frame rate. deltaTime is in milliseconds
+	auto& physicsSystem = m_coordinator->GetSystem<PhysicsSystem>();
+	const size_t physicsStepCount = m_fixedTimestep.Advance(deltaTime / 1000.0f);
+	for (size_t i = 0; i < physicsStepCount; i++)
+	{
+		physicsSystem.StorePreviousTransforms();
+		m_physicsScheduler->Run(m_fixedTimestep.GetStepTime());
+	}
 
 	//------------------------------------------------------------------------	
-	// Invoke all the systems that needs to be updated
-	m_coordinator->GetSystem<GameplaySystem>().Update(m_terrainVertices);
-	m_coordinator->GetSystem<AnimationSystem>().Update(m_assetManager, deltaTime);
-	// [Physics system Start] Order is important. First integrate the forces, then resolve the constraint(penetration due to collision and joint), then integrate the velocities
-	const float dt = deltaTime / 1000.0f; // Converting to seconds
-	m_coordinator->GetSystem<PhysicsSystem>().UpdateForces(dt, m_worldSettings);
-	m_coordinator->GetSystem<CollisionSystem>().Update(m_eventManager);
-	m_coordinator->GetSystem<ConstraintSystem>().Update(dt);
-	m_coordinator->GetSystem<PhysicsSystem>().UpdateVelocities(dt);
-	// [Physics system End]
-	m_coordinator->GetSystem<ParticleEffectSystem>().Update(dt);
-	m_coordinator->GetSystem<CameraFollowSystem>().Update(m_camera);
-	m_coordinator->GetSystem<PlayerSystem>().Update(m_eventManager);
-	m_coordinator->GetSystem<TrajectorySystem>().Update(dt); // If left click hold then store mouse position for trajectory calculations
+	// Invoke all the systems that needs to be updated once per frame after the physics (see AddSystemSteps())
+	m_systemScheduler->Run(deltaTime);
+
+	// Dispatch whatever was queued after its flush point, so no event waits until the next frame
+	m_eventManager->FlushEvents();
 
 
 	// Move background w.r.t camera for parallax effect.
@@ -265,6 +275,54 @@ void GalaxyGolf::Update(float deltaTime)
 	
 }
 
+void GalaxyGolf::AddSystemSteps()
+{
+	// The steps keep this order wherever their components conflict, the others run in parallel
+
+	// Once per frame, before the physics. deltaTime is the frame time, in milliseconds
+	// Gameplay applies the launch and explosion forces and kills the entities, the physics steps of the frame see them
+	auto& gameplaySystem = m_coordinator->GetSystem<GameplaySystem>();
+	m_gameplayScheduler->AddStep("Gameplay", gameplaySystem, [this, &gameplaySystem](float) { gameplaySystem.Update(m_terrainVertices); });
+
+	auto& animationSystem = m_coordinator->GetSystem<AnimationSystem>();
+	m_gameplayScheduler->AddStep("Animation", animationSystem, [this, &animationSystem](const float deltaTime) { animationSystem.Update(m_assetManager, deltaTime); });
+
+	// [Physics system Start] Order is important. First integrate the forces, then resolve the constraint(penetration due to collision and joint), then integrate the velocities
+	// deltaTime is the fixed step, in seconds
+	auto& physicsSystem = m_coordinator->GetSystem<PhysicsSystem>();
+	m_physicsScheduler->AddStep("Forces", physicsSystem, [this, &physicsSystem](const float deltaTime) { physicsSystem.UpdateForces(deltaTime, m_worldSettings); });
+
+	auto& collisionSystem = m_coordinator->GetSystem<CollisionSystem>();
+	// The CollisionEvents are queued during the narrow phase and dispatched in one batch once it is done
+	// The constraints need them every step. GameplaySystem::onCollision() ignores the entities an earlier step of the frame already killed
+	m_physicsScheduler->AddStep("Collision", collisionSystem, [this, &collisionSystem](float)
+	{
+		collisionSystem.Update(m_eventManager);
+		m_eventManager->FlushEvents<CollisionEvent>();
+	});
+
+	auto& constraintSystem = m_coordinator->GetSystem<ConstraintSystem>();
+	m_physicsScheduler->AddStep("Constraint", constraintSystem, [&constraintSystem](const float deltaTime) { constraintSystem.Update(deltaTime); });
+
+	m_physicsScheduler->AddStep("Velocities", physicsSystem, [&physicsSystem](const float deltaTime) { physicsSystem.UpdateVelocities(deltaTime); });
+	// [Physics system End]
+
+	// Once per frame, after the physics. deltaTime is the frame time, in milliseconds
+	auto& particleEffectSystem = m_coordinator->GetSystem<ParticleEffectSystem>();
+	m_systemScheduler->AddStep("Particles", particleEffectSystem, [&particleEffectSystem](const float deltaTime) { particleEffectSystem.Update(deltaTime / 1000.0f); });
+
+	auto& cameraFollowSystem = m_coordinator->GetSystem<CameraFollowSystem>();
+	// The physics steps of the frame are done, so the alpha is the one the frame is rendered with
+	m_systemScheduler->AddStep("Camera", cameraFollowSystem, [this, &cameraFollowSystem](float) { cameraFollowSystem.Update(m_camera, m_fixedTimestep.GetAlpha()); });
+
+	auto& playerSystem = m_coordinator->GetSystem<PlayerSystem>();
+	m_systemScheduler->AddStep("Player", playerSystem, [this, &playerSystem](float) { playerSystem.Update(m_eventManager); });
+
+	// If left click hold then simulate the trajectory preview with the same step as the physics
+	auto& trajectorySystem = m_coordinator->GetSystem<TrajectorySystem>();
+	m_systemScheduler->AddStep("Trajectory", trajectorySystem, [this, &trajectorySystem](float) { trajectorySystem.Update(m_fixedTimestep.GetStepTime(), m_worldSettings); });
+}
+
 void GalaxyGolf::ProcessInput()
 {
 	// For debug mode
@@ -315,7 +373,7 @@ void GalaxyGolf::Render()
 	PCG::RenderTerrain(m_camera, m_terrainVertices, m_worldSettings.groundColor);
 
 	// Update RenderTerrain Systems
-	m_coordinator->GetSystem<RenderSystem>().Update(m_assetManager, m_camera);
+	m_coordinator->GetSystem<RenderSystem>().Update(m_assetManager, m_camera, m_fixedTimestep.GetAlpha());
 	m_coordinator->GetSystem<ParticleEffectSystem>().Render(m_camera);
 	m_coordinator->GetSystem<RenderTextSystem>().Update(m_camera);
 	m_coordinator->GetSystem<TrajectorySystem>().Render(m_camera);
@@ -323,13 +381,60 @@ void GalaxyGolf::Render()
 	if (m_isDebug)
 	{
 		m_coordinator->GetSystem<RenderDebugSystem>().Render(m_camera);
+
+		const auto& constraintSystem = m_coordinator->GetSystem<ConstraintSystem>();
+		Graphics::PrintText(
+			"Bodies awake: " + std::to_string(constraintSystem.GetAwakeBodyCount()) +
+			"  sleeping: " + std::to_string(constraintSystem.GetSleepingBodyCount()) +
+			"  islands: " + std::to_string(constraintSystem.GetIslandCount()) +
+			"  physics steps: " + std::to_string(m_fixedTimestep.GetLastStepCount()),
+			Vector2(20.f, 20.f),
+			Color(Colors::WHITE)
+		);
+
+		RenderSystemTimeline();
 	}
-	m_coordinator->GetSystem<RenderDebugSystem>().RenderConnectedEntites(m_camera);
+	m_coordinator->GetSystem<RenderDebugSystem>().RenderConnectedEntites(m_camera, m_fixedTimestep.GetAlpha());
 
 	m_coordinator->GetSystem<RenderHUDSystem>().Update(m_camera, m_worldType, m_worldSettings, Color(Colors::WHITE));
 	m_coordinator->GetSystem<InputSystem>().RenderForce(m_camera);
 }
 
+void GalaxyGolf::RenderSystemTimeline() const
+{
+	constexpr float PIXELS_PER_MILLISECOND = 100.f;
+	constexpr float ROW_HEIGHT = 14.f;
+	constexpr float LABEL_X = 20.f;
+	constexpr float BARS_X = 150.f;
+
+	float y = Physics::SCREEN_HEIGHT - 40.f;
+	for (const auto& [title, scheduler] : { std::make_pair("Before physics", m_gameplayScheduler.get()), std::make_pair("Physics step", m_physicsScheduler.get()), std::make_pair("After physics", m_systemScheduler.get()) })
+	{
+		Graphics::PrintText(
+			std::string(title) + " timeline (stages: " + std::to_string(scheduler->GetStageCount()) +
+			", workers: " + std::to_string(JobSystem::GetWorkerCount()) + ")",
+			Vector2(LABEL_X, y),
+			Color(Colors::WHITE)
+		);
+
+		// Steps of the same stage ran at the same time, the worker threads are drawn in green
+		for (const auto& entry : scheduler->GetTimeline())
+		{
+			y -= ROW_HEIGHT;
+			Graphics::PrintText(std::to_string(entry.stage) + " " + entry.name, Vector2(LABEL_X, y), Color(Colors::LIGHT_GRAY));
+
+			const float width = std::max((entry.endTime - entry.startTime) * PIXELS_PER_MILLISECOND, 1.f);
+			Graphics::DrawFillRectangle(
+				Vector2(BARS_X + entry.startTime * PIXELS_PER_MILLISECOND, y),
+				width,
+				ROW_HEIGHT - 4.f,
+				Color(entry.isMainThread ? Colors::LIGHT_BLUE : Colors::LIGHT_GREEN)
+			);
+		}
+		y -= 2.f * ROW_HEIGHT;
+	}
+}
+
 void GalaxyGolf::Shutdown()
 {
 	if (m_audioManager->IsAudioPlaying("GameplayBG"))
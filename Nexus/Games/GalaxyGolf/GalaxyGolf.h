@@ -5,6 +5,7 @@
 
 #include "src/InputManagement/InputEnums.h"
 #include "src/Physics/Camera.h"
+#include "src/Physics/FixedTimestep.h"
 #include "WorldSettings.h"
 
 struct Score;
@@ -12,6 +13,7 @@ enum class GameState;
 enum class MapType;
 enum class ColliderType;
 class Coordinator;
+class SystemScheduler;
 class EventManager;
 class InputManager;
 class AssetManager;
@@ -33,12 +35,24 @@ public:
 	void Shutdown();
 
 private:
+	// Register the system updates in the schedulers, in the order they have to run: m_gameplayScheduler before the physics, the physics steps in m_physicsScheduler, the others in m_systemScheduler
+	void AddSystemSteps();
+	// Debug mode: one bar per system step of the last frame (and of the last physics step), showing what ran in parallel
+	void RenderSystemTimeline() const;
+
 	//------------------------------------------------------------------------
 	// Engine
 	//------------------------------------------------------------------------
 	bool m_isDebug; // Trigger debug mode using 'B' key
 
 	std::unique_ptr<Coordinator> m_coordinator;
+	// Runs once per frame before the physics, so the forces and the entities it adds or kills are in this frame's steps
+	std::unique_ptr<SystemScheduler> m_gameplayScheduler;
+	// Runs once per frame after the physics
+	std::unique_ptr<SystemScheduler> m_systemScheduler;
+	// Runs once per fixed step, zero or more times per frame (see m_fixedTimestep)
+	std::unique_ptr<SystemScheduler> m_physicsScheduler;
+	FixedTimestep m_fixedTimestep;
 	std::shared_ptr<EventManager> m_eventManager;
 	std::unique_ptr<InputManager> m_inputManager;
 	std::unique_ptr<AssetManager> m_assetManager;
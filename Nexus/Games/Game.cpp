@@ -3,10 +3,23 @@
 
 #include "App/app.h"
 
+#include "Debug/BroadPhaseScene.h"
+#include "Debug/BulletScene.h"
+#include "Debug/ConstraintBenchmark.h"
+#include "Debug/EventBenchmark.h"
+#include "Debug/GravityScene.h"
+#include "Debug/IslandScene.h"
+#include "Debug/JobSystemBenchmark.h"
+#include "Debug/NarrowPhaseBenchmark.h"
+#include "Debug/PoolBenchmark.h"
+#include "Debug/RayCastBenchmark.h"
+#include "Debug/StackingScene.h"
+#include "Debug/StorageScene.h"
 #include "GalaxyGolf/GalaxyGolf.h"
 
 #include "src/Physics/Constants.h"
 #include "src/Utils/GraphicsUtils.h"
+#include "src/Utils/JobSystem.h"
 #include "src/Utils/Logger.h"
 #include "src/Utils/Vector2.h"
 #include "UI/UIEffects.h"
@@ -15,18 +28,44 @@ Game::Game()
 {
 	m_currentGameState = std::make_shared<GameState>();
 	m_score = std::make_shared<Score>();
+	JobSystem::Initialize();
 }
 
 Game::~Game()
 {
 	m_currentGameState.reset();
 	m_score.reset();
+	JobSystem::Shutdown();
 };
 
 void Game::Initialize() const
 {
 	// For debug
 	// *m_currentGameState = GameState::PLAYING;
+	// Log the solver iterations a stack of boxes needs, with and without warm starting. Runs before any GalaxyGolf coordinator exists
+	// StackingScene::LogIterationsNeeded();
+	// Log the time per step of each broad phase
+	// BroadPhaseScene::LogComparison();
+	// Log the time per step of the island solver with 1, 2, 4 and 8 threads, and check the result is the same
+	// IslandScene::LogScaling();
+	// Log the cost of a job and of ParallelFor() with 0, 1, 3 and 7 workers
+	// JobSystemBenchmark::LogResults();
+	// Log the polygon-polygon tests per second of the narrow phase
+	// NarrowPhaseBenchmark::LogResults();
+	// Log how many fast shots go through a thin wall or the terrain, with and without the continuous collision detection
+	// BulletScene::LogTunnels();
+	// Log the constraints per second of the solver
+	// ConstraintBenchmark::LogResults();
+	// Log the cost of the component pool against the old unordered_map one
+	// PoolBenchmark::LogResults();
+	// Log the time of the integrate step with the component pools and with the archetypes, and check both give the same result
+	// StorageScene::LogComparison();
+	// Log the allocations per frame of the event subscriptions and emits and the cost of an emit, against the old event manager
+	// EventBenchmark::LogResults();
+	// Log the time of 10k ray casts per frame and check they don't allocate
+	// RayCastBenchmark::LogResults();
+	// Log the time and the error of Barnes-Hut gravity against the exact sum, from 100 to 20k bodies
+	// GravityScene::LogScaling();
 }
 
 void Game::InitializeMap(WorldType worldType, std::weak_ptr<GameState> gameState, std::weak_ptr<Score> score)
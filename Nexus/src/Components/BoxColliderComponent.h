@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "src/Utils/Vector2.h"
 
 /**
@@ -17,6 +19,10 @@ struct BoxColliderComponent
 	std::vector<Vector2> localVertices;  // Vertices in local space
 	std::vector<Vector2> globalVertices; // Transformed vertices in global space
 
+	// Normal of the edge localVertices[i] -> localVertices[i + 1], computed once. The global ones are only rotated with the vertices, not recomputed
+	std::vector<Vector2> localNormals;
+	std::vector<Vector2> globalNormals;
+
 	explicit BoxColliderComponent(const float width = 0, const float height = 0, const Vector2 offset = Vector2())
 		: width(width), height(height), offset(offset)
 	{
@@ -28,5 +34,11 @@ struct BoxColliderComponent
 			Vector2(-width / 2, height / 2)
 		};
 		globalVertices.resize(localVertices.size());
+
+		for (size_t i = 0; i < localVertices.size(); i++)
+		{
+			localNormals.push_back((localVertices[(i + 1) % localVertices.size()] - localVertices[i]).Normal());
+		}
+		globalNormals = localNormals;
 	}
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "src/Utils/Vector2.h"
+
+/**
+ * ChainColliderComponent provides a terrain (heightfield) for Collision System: a chain of segments stored once in a single entity, instead of one polygon per segment.
+ * There are no edges between the segments, so the bodies slide from one segment to the next without catching on them (ghost collisions).
+ * Only for static bodies. The chain is translated by the TransformComponent but not rotated
+ * @param localVertices (vector<Vector2>) of the chain with respect to the local space where origin is the position of entity. From left to right (increasing x), the solid side is below the chain
+ * @param depth (Float) How far below the chain the bodies are still pushed back up. 500 by default
+*/
+struct ChainColliderComponent
+{
+	// Local space Vertices
+	std::vector<Vector2> localVertices;
+	// Global space vertices, calculated by PhysicsEngine::UpdateChainColliderVertices()
+	std::vector<Vector2> globalVertices;
+	// Normal of the segment globalVertices[i] -> globalVertices[i + 1], pointing up out of the terrain. Computed once, the chain is never rotated
+	std::vector<Vector2> normals;
+	float depth;
+
+	explicit ChainColliderComponent(const std::vector<Vector2>& localVertices, const float depth = 500.0f) :
+		localVertices(localVertices), globalVertices(localVertices), depth(depth)
+	{
+		for (size_t i = 0; i + 1 < localVertices.size(); i++)
+		{
+			normals.push_back((localVertices[i] - localVertices[i + 1]).Normal());
+		}
+	}
+
+	[[nodiscard]] size_t GetSegmentCount() const { return normals.size(); }
+
+	// The segments [outBegin, outEnd) that overlap the range minX - maxX, found by binary search on the x of the vertices
+	void FindSegments(const float minX, const float maxX, size_t& outBegin, size_t& outEnd) const
+	{
+		if (normals.empty())
+		{
+			outBegin = outEnd = 0;
+			return;
+		}
+
+		// First segment ending after minX, up to the last segment starting before maxX
+		const auto firstEnd = std::lower_bound(globalVertices.begin() + 1, globalVertices.end(), minX,
+			[](const Vector2& vertex, const float x) { return vertex.x < x; });
+		const auto lastStart = std::upper_bound(globalVertices.begin(), globalVertices.end() - 1, maxX,
+			[](const float x, const Vector2& vertex) { return x < vertex.x; });
+		outBegin = static_cast<size_t>(firstEnd - globalVertices.begin()) - 1;
+		outEnd = std::max(outBegin, static_cast<size_t>(lastStart - globalVertices.begin()));
+	}
+
+	// A vertex sticking out of the terrain (a peak) can be hit on its own. The others are covered by the segments around them
+	[[nodiscard]] bool IsConvexVertex(const size_t index) const
+	{
+		if (index == 0 || index >= normals.size())
+		{
+			return true; // The ends of the chain
+		}
+		const Vector2 previousSegment = globalVertices[index] - globalVertices[index - 1];
+		const Vector2 nextSegment = globalVertices[index + 1] - globalVertices[index];
+		return previousSegment.Cross(nextSegment) < 0.0f; // Turning down
+	}
+
+	// Height of the chain at x. Returns false if x is outside the chain
+	[[nodiscard]] bool GetHeight(const float x, float& outHeight) const
+	{
+		size_t segment;
+		size_t segmentEnd;
+		FindSegments(x, x, segment, segmentEnd);
+		if (segment == segmentEnd)
+		{
+			return false;
+		}
+		const Vector2& start = globalVertices[segment];
+		const Vector2& end = globalVertices[segment + 1];
+		const float width = end.x - start.x;
+		outHeight = width > 0.0f ? start.y + (end.y - start.y) * (x - start.x) / width : std::max(start.y, end.y);
+		return true;
+	}
+};
@@ -7,11 +7,12 @@ enum class ColliderType
 	Box,
 	Circle,
 	Polygon,
+	Chain, // Static terrain, see ChainColliderComponent
 };
 
 /**
  * ColliderType Component provide the information regarding the shape of collier for Collision System
- * @param type ColliderType Enum with possible values = {Box, Circle, Polygon}
+ * @param type ColliderType Enum with possible values = {Box, Circle, Polygon, Chain}
 */
 struct ColliderTypeComponent
 {
@@ -19,6 +20,8 @@ struct ColliderTypeComponent
 
 	std::vector<Contact> contacts; // Store contact info for Render debug system
 
+	int proxyId = -1; // Broad phase proxy of the collider, managed by the CollisionSystem (-1 = no proxy)
+
 	explicit ColliderTypeComponent(const ColliderType type)
 		: type(type), contacts({})
 	{}
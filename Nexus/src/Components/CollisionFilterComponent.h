@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "src/Physics/CollisionFilter.h"
+
+/**
+ * CollisionFilter Component tells the CollisionSystem which colliders can collide with each other. Colliders without it use the default category and collide with everything.
+ * @param category (uint32_t): CollisionFilter::Category bits of the collider. The mask is resolved once from the CollisionFilter::IGNORE_RULES table
+ * @param groupIndex (int16_t): Default is 0. Colliders sharing a positive group index always collide, colliders sharing a negative group index never collide
+*/
+struct CollisionFilterComponent
+{
+	uint32_t category;
+	uint32_t mask;
+	int16_t groupIndex;
+
+	explicit CollisionFilterComponent(const uint32_t category = CollisionFilter::Category::DEFAULT, const int16_t groupIndex = 0)
+		: category(category), mask(CollisionFilter::GetMask(category)), groupIndex(groupIndex)
+	{}
+
+	[[nodiscard]] bool ShouldCollide(const CollisionFilterComponent& other) const
+	{
+		return CollisionFilter::ShouldCollide(category, mask, groupIndex, other.category, other.mask, other.groupIndex);
+	}
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * GravityComponent Component tell the PhysicsSystem which bodies attract each other (N-body gravity, see GravityField). They don't get the weight force of the world
+*/
+struct GravityComponent
+{
+	explicit GravityComponent() = default;
+};
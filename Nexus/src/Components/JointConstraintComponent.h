@@ -1,10 +1,12 @@
 #pragma once
 
 #include "src/ECS/Entity.h"
-#include "src/Utils/Matrix.h"
 #include "src/Utils/Vector2.h"
 
-// TODO: What happens if the entity of the joint is delete? Also delete the whole joint?
+class RigidBodyComponent;
+
+// If the entity a or b is killed, the ConstraintSystem skips the joint (see Entity::IsAlive()).
+// TODO: Also delete the whole joint?
 
 /**
  * JointConstraintComponent provides information for Constraint System. Always add it with ConstraintTypeComponent
@@ -19,14 +21,20 @@ struct JointConstraintComponent
 	// Values populated by ConstraintSystem
 	Vector2 anchorPointForA;	// The location of anchor point w.r.t to A's local space. Calculated by ConstraintSystem::InitializeLocalCoordinates()
 	Vector2 anchorPointForB;	// The location of anchor point w.r.t to B's local space. Calculated by ConstraintSystem::InitializeLocalCoordinates()
-	Matrix jacobian;			// Calculated by ConstraintSystem::PreSolve()
-	VectorN cachedLambda;		// Calculated by ConstraintSystem::Solve()
+
+	// Jacobian [-linear, angularA, linear, angularB] and effective mass 1 / (J M^-1 JT), calculated once per step by ConstraintSystem::PreSolve()
+	Vector2 jacobianLinear;
+	float jacobianAngularA = 0.0f;
+	float jacobianAngularB = 0.0f;
+	float effectiveMass = 0.0f;
+	// Bodies of a and b while the joint is solved, nullptr when PreSolve() skipped it
+	RigidBodyComponent* rigidBodyA = nullptr;
+	RigidBodyComponent* rigidBodyB = nullptr;
+
+	float cachedLambda = 0.0f;	// Calculated by ConstraintSystem::Solve()
 	float bias = 0.0f;			// Baumgarte stabilization factor calculated by ConstraintSystem::PreSolve()
 
 	explicit JointConstraintComponent(const Entity a, const Entity b)
-		: a(a), b(b), jacobian(1, 6), cachedLambda(1)
-	{
-		jacobian.Zero();
-		cachedLambda.Zero();
-	}
+		: a(a), b(b)
+	{}
 };
\ No newline at end of file
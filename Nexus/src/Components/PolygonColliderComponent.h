@@ -15,6 +15,9 @@ struct PolygonColliderComponent
 	std::vector<Vector2> localVertices;
 	// Global space vertices. These will be calculated by the Physics system on every update. These coordinates are the result of torque(angular velocity and angular acceleration) and offset.
 	std::vector<Vector2> globalVertices;
+	// Normal of the edge localVertices[i] -> localVertices[i + 1], computed once. The global ones are only rotated with the vertices, not recomputed
+	std::vector<Vector2> localNormals;
+	std::vector<Vector2> globalNormals;
 	Vector2 offset;
 
 	explicit PolygonColliderComponent(const std::vector<Vector2>& localVertices, const Vector2 offset = Vector2()) :
@@ -22,5 +25,11 @@ struct PolygonColliderComponent
 	{
 		// Ensure globalVertices has the same size as localVertices
 		globalVertices.resize(localVertices.size());
+
+		for (size_t i = 0; i < localVertices.size(); i++)
+		{
+			localNormals.push_back((localVertices[(i + 1) % localVertices.size()] - localVertices[i]).Normal());
+		}
+		globalNormals = localNormals;
 	}
 };
\ No newline at end of file
@@ -13,6 +13,8 @@
  * @param angularAcceleration (Float): Default value is set to 0.
  * @param restitution (Float value between 0.0 - 1.0): Elasticity. Default is 1.0f
  * @param friction (Float value between 0.0 - 1.0): Coefficient of friction. Default is 0.7f
+ * Sleeping bodies (isAwake = false) are not integrated or solved. AddForce(), AddTorque() and the ApplyImpulse functions wake the body up
+ * Bullets (isBullet = true) are fast bodies with a circle collider. They are swept against the static colliders every step and stopped at the first impact, so they can't go through thin colliders
 */
 class RigidBodyComponent
 {
@@ -42,6 +44,13 @@ public:
 	float inverseOfMass = 1.0f;			// Keeping track of 1/Mass to avoid doing this costly calculation multiple times
 	float inverseOfAngularMass = 0.0f;	// Or inverse of Moment of Inertia. Keeping track of 1/AngularMass  to avoid doing this costly calculation multiple times
 
+	// Managed by the Constraint System (islands)
+	bool isAwake = true;
+	float sleepTime = 0.0f;				// For how long (in seconds) the body has been under the sleep tolerances
+
+	// Continuous collision detection, see PhysicsSystem::SweepBullets()
+	bool isBullet = false;
+
 	explicit RigidBodyComponent(
 		const Vector2 velocity = Vector2(),
 		const Vector2 acceleration = Vector2(),
@@ -73,33 +82,52 @@ public:
 		return fabs(inverseOfMass - 0.0f) < FLT_EPSILON;
 	}
 
+	// Waking up resets the sleep timer. A sleeping body doesn't move, so its velocities and forces are cleared
+	void SetAwake(const bool awake)
+	{
+		isAwake = awake;
+		sleepTime = 0.0f;
+		if (!awake)
+		{
+			velocity = Vector2();
+			angularVelocity = 0.0f;
+			sumForces = Vector2();
+			sumTorque = 0.0f;
+		}
+	}
+
 	// Add Force
 	void AddForce(const Vector2& force)
 	{
+		if (!isAwake) SetAwake(true);
 		PhysicsEngine::AddForce(*this, force);
 	}
 
 	// Add Torque
 	void AddTorque(const float torque)
 	{
+		if (!isAwake) SetAwake(true);
 		PhysicsEngine::AddTorque(*this, torque);
 	}
 
 	// Apply linear impulse to the RigidBody's center of mass. Change in Velocity, Δv = Impulse / mass
 	void ApplyImpulseLinear(const Vector2 impulse)
 	{
+		if (!isAwake) SetAwake(true);
 		PhysicsEngine::ApplyImpulseLinear(*this, impulse);
 	}
 
 	// Apply angular impulse to the RigidBody's center of mass.
 	void ApplyImpulseAngular(const float impulse)
 	{
+		if (!isAwake) SetAwake(true);
 		PhysicsEngine::ApplyImpulseAngular(*this, impulse);
 	}
 
 	// Apply linear + angular impulse to the point at a certain distance from RigidBody's center of mass.
 	void ApplyImpulseAngular(const Vector2 impulse, const Vector2& distanceFromCenter)
 	{
+		if (!isAwake) SetAwake(true);
 		PhysicsEngine::ApplyImpulseAtPoint(*this, impulse, distanceFromCenter);
 	}
 };
\ No newline at end of file
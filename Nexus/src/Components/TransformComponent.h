@@ -1,5 +1,6 @@
 #pragma once
 
+#include "src/Utils/Math.h"
 #include "src/Utils/Vector2.h"
 
 /**
@@ -14,9 +15,19 @@ struct TransformComponent
 	Vector2 scale;
 	float rotation;
 
+	// Position and rotation before the last physics step, stored by PhysicsSystem::StorePreviousTransforms() for the render interpolation (see FixedTimestep)
+	Vector2 previousPosition;
+	float previousRotation;
+
 	explicit TransformComponent(const Vector2 position = Vector2(), const Vector2 scale = Vector2(), const float rotation = 0.0) :
 		position(position),
 		scale(scale),
-		rotation(rotation)
+		rotation(rotation),
+		previousPosition(position),
+		previousRotation(rotation)
 	{}
+
+	// alpha = 0 is the previous state, 1 the current one
+	[[nodiscard]] Vector2 GetInterpolatedPosition(const float alpha) const { return Math::Lerp(previousPosition, position, alpha); }
+	[[nodiscard]] float GetInterpolatedRotation(const float alpha) const { return Math::Lerp(previousRotation, rotation, alpha); }
 };
\ No newline at end of file
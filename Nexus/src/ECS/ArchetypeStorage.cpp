@@ -0,0 +1,199 @@
+#include "stdafx.h"
+#include "ArchetypeStorage.h"
+
+#include <algorithm>
+#include <cassert>
+
+//------------------------------------------------------------------------
+// Archetype
+//------------------------------------------------------------------------
+Archetype::Archetype(const Signature& signature, const std::vector<const ComponentTypeInfo*>& componentTypeInfos)
+	: m_signature(signature)
+{
+	// Bytes per row (entity id + one of each component) and the worst case padding between the columns
+	size_t bytesPerRow = sizeof(size_t);
+	size_t padding = 0;
+	for (size_t componentId = 0; componentId < m_signature.size(); componentId++)
+	{
+		if (m_signature.test(componentId))
+		{
+			const ComponentTypeInfo* typeInfo = componentTypeInfos[componentId];
+			m_columnIndexPerComponent[componentId] = m_columns.size();
+			m_columns.push_back({ componentId, 0, typeInfo });
+			bytesPerRow += typeInfo->size;
+			padding += typeInfo->alignment;
+		}
+	}
+	m_chunkCapacity = (CHUNK_SIZE_IN_BYTES - padding) / bytesPerRow;
+	assert(m_chunkCapacity > 0 && "Archetype: a single row doesn't fit in a chunk");
+
+	// Entity id column starts at 0, then the component columns with their alignment
+	size_t offset = sizeof(size_t) * m_chunkCapacity;
+	for (auto& column : m_columns)
+	{
+		const size_t alignment = column.typeInfo->alignment;
+		offset = (offset + alignment - 1) / alignment * alignment;
+		column.offset = offset;
+		offset += column.typeInfo->size * m_chunkCapacity;
+	}
+}
+
+Archetype::~Archetype()
+{
+	// Destroy the components that are still alive
+	for (size_t row = 0; row < m_size; row++)
+	{
+		for (const auto& column : m_columns)
+		{
+			column.typeInfo->destroy(GetComponent(column.componentId, row));
+		}
+	}
+}
+
+size_t Archetype::GetChunkSize(const size_t chunkIndex) const
+{
+	const size_t rowsBefore = chunkIndex * m_chunkCapacity;
+	return std::min(m_chunkCapacity, m_size - rowsBefore);
+}
+
+void* Archetype::GetColumn(const size_t componentId, const size_t chunkIndex) const
+{
+	return GetChunkData(chunkIndex) + m_columns[m_columnIndexPerComponent[componentId]].offset;
+}
+
+size_t* Archetype::GetEntityColumn(const size_t chunkIndex) const
+{
+	return reinterpret_cast<size_t*>(GetChunkData(chunkIndex));
+}
+
+void* Archetype::GetComponent(const size_t componentId, const size_t row) const
+{
+	const Column& column = m_columns[m_columnIndexPerComponent[componentId]];
+	return GetChunkData(row / m_chunkCapacity) + column.offset + column.typeInfo->size * (row % m_chunkCapacity);
+}
+
+size_t Archetype::GetEntityId(const size_t row) const
+{
+	return GetEntityColumn(row / m_chunkCapacity)[row % m_chunkCapacity];
+}
+
+size_t Archetype::AddRow(const size_t entityId)
+{
+	const size_t row = m_size++;
+	if (row / m_chunkCapacity >= m_chunks.size())
+	{
+		m_chunks.push_back(std::make_unique<Chunk>());
+	}
+	GetEntityColumn(row / m_chunkCapacity)[row % m_chunkCapacity] = entityId;
+	return row;
+}
+
+size_t Archetype::RemoveRow(const size_t row)
+{
+	const size_t lastRow = m_size - 1;
+	size_t movedEntityId = INVALID_ENTITY;
+
+	for (const auto& column : m_columns)
+	{
+		void* removed = GetComponent(column.componentId, row);
+		column.typeInfo->destroy(removed);
+		if (row != lastRow)
+		{
+			// Fill the hole with the last row to keep the chunks packed
+			void* last = GetComponent(column.componentId, lastRow);
+			column.typeInfo->moveConstruct(removed, last);
+			column.typeInfo->destroy(last);
+		}
+	}
+	if (row != lastRow)
+	{
+		movedEntityId = GetEntityId(lastRow);
+		GetEntityColumn(row / m_chunkCapacity)[row % m_chunkCapacity] = movedEntityId;
+	}
+
+	m_size--;
+
+	// Release the last chunk once it's empty
+	if (m_size <= (m_chunks.size() - 1) * m_chunkCapacity)
+	{
+		m_chunks.pop_back();
+	}
+	return movedEntityId;
+}
+
+//------------------------------------------------------------------------
+// ArchetypeStorage
+//------------------------------------------------------------------------
+void ArchetypeStorage::RemoveEntity(const size_t entityId)
+{
+	if (entityId < m_entityLocations.size() && m_entityLocations[entityId].archetype)
+	{
+		MoveEntity(entityId, Signature());
+	}
+}
+
+void ArchetypeStorage::GetMatchingArchetypes(const Signature& required, std::vector<const Archetype*>& outArchetypes) const
+{
+	for (const Archetype* archetype : m_archetypesInOrder)
+	{
+		if ((archetype->GetSignature() & required) == required)
+		{
+			outArchetypes.push_back(archetype);
+		}
+	}
+}
+
+Archetype& ArchetypeStorage::GetOrCreateArchetype(const Signature& signature)
+{
+	auto& archetype = m_archetypes[signature];
+	if (!archetype)
+	{
+		archetype = std::make_unique<Archetype>(signature, m_componentTypeInfos);
+		m_archetypesInOrder.push_back(archetype.get());
+	}
+	return *archetype;
+}
+
+ArchetypeStorage::EntityLocation ArchetypeStorage::MoveEntity(const size_t entityId, const Signature& newSignature)
+{
+	if (entityId >= m_entityLocations.size())
+	{
+		m_entityLocations.resize(entityId + 1);
+	}
+	const EntityLocation oldLocation = m_entityLocations[entityId];
+
+	EntityLocation newLocation;
+	if (newSignature.any())
+	{
+		newLocation.archetype = &GetOrCreateArchetype(newSignature);
+		newLocation.row = newLocation.archetype->AddRow(entityId);
+	}
+
+	if (oldLocation.archetype)
+	{
+		// Carry over the components that both archetypes have
+		if (newLocation.archetype)
+		{
+			const Signature sharedComponents = oldLocation.archetype->GetSignature() & newSignature;
+			for (size_t componentId = 0; componentId < sharedComponents.size(); componentId++)
+			{
+				if (sharedComponents.test(componentId))
+				{
+					m_componentTypeInfos[componentId]->moveConstruct(
+						newLocation.archetype->GetComponent(componentId, newLocation.row),
+						oldLocation.archetype->GetComponent(componentId, oldLocation.row));
+				}
+			}
+		}
+
+		// Destroys the (moved-from) old components and fills the hole with another entity
+		const size_t movedEntityId = oldLocation.archetype->RemoveRow(oldLocation.row);
+		if (movedEntityId != Archetype::INVALID_ENTITY)
+		{
+			m_entityLocations[movedEntityId].row = oldLocation.row;
+		}
+	}
+
+	m_entityLocations[entityId] = newLocation;
+	return newLocation;
+}
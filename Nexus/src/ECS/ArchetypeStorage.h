@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Component.h"
+#include "System.h"
+
+//------------------------------------------------------------------------
+// ComponentTypeInfo
+// Size, alignment and lifetime functions of a component type, so archetype chunks can hold any component as raw bytes
+//------------------------------------------------------------------------
+struct ComponentTypeInfo
+{
+	size_t size;
+	size_t alignment;
+	void (*moveConstruct)(void* destination, void* source);
+	void (*destroy)(void* object);
+
+	template <typename TComponent>
+	static const ComponentTypeInfo* Of()
+	{
+		static const ComponentTypeInfo info{
+			sizeof(TComponent),
+			alignof(TComponent),
+			[](void* destination, void* source) { new (destination) TComponent(std::move(*static_cast<TComponent*>(source))); },
+			[](void* object) { static_cast<TComponent*>(object)->~TComponent(); }
+		};
+		return &info;
+	}
+};
+
+//------------------------------------------------------------------------
+// Archetype
+// Stores all the entities that have the exact same component Signature.
+// The components are kept in fixed size chunks. Each chunk is SoA: one packed column of entity ids and one packed column per component type.
+// Rows stay packed across the chunks: removing a row moves the last row into the hole.
+//------------------------------------------------------------------------
+class Archetype
+{
+public:
+	static constexpr size_t CHUNK_SIZE_IN_BYTES = 16 * 1024;
+	static constexpr size_t INVALID_ENTITY = SIZE_MAX;
+
+	// componentTypeInfos is indexed by component id and must have an entry for every component in the signature
+	Archetype(const Signature& signature, const std::vector<const ComponentTypeInfo*>& componentTypeInfos);
+	~Archetype();
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	[[nodiscard]] const Signature& GetSignature() const { return m_signature; }
+	[[nodiscard]] size_t GetSize() const { return m_size; }
+	[[nodiscard]] size_t GetChunkCount() const { return m_chunks.size(); }
+	[[nodiscard]] size_t GetChunkCapacity() const { return m_chunkCapacity; }
+	[[nodiscard]] size_t GetChunkSize(size_t chunkIndex) const;
+
+	// Start of the packed column of a component (or the entity ids) in a chunk. The component must be part of the signature.
+	[[nodiscard]] void* GetColumn(size_t componentId, size_t chunkIndex) const;
+	[[nodiscard]] size_t* GetEntityColumn(size_t chunkIndex) const;
+
+	[[nodiscard]] void* GetComponent(size_t componentId, size_t row) const;
+	[[nodiscard]] size_t GetEntityId(size_t row) const;
+
+	// Reserve a row for the entity. The component memory of that row is uninitialized and has to be constructed by the caller.
+	size_t AddRow(size_t entityId);
+
+	// Destroy the components of the row and fill the hole with the last row.
+	// Returns the id of the entity that was moved into the row, or INVALID_ENTITY if the removed row was the last one.
+	size_t RemoveRow(size_t row);
+
+private:
+	struct Column
+	{
+		size_t componentId;
+		size_t offset;
+		const ComponentTypeInfo* typeInfo;
+	};
+	struct alignas(64) Chunk
+	{
+		std::byte data[CHUNK_SIZE_IN_BYTES];
+	};
+
+	[[nodiscard]] std::byte* GetChunkData(size_t chunkIndex) const { return m_chunks[chunkIndex]->data; }
+
+	Signature m_signature;
+	std::vector<Column> m_columns;
+
+	// [Array index = component id], index into m_columns
+	std::array<size_t, Signature().size()> m_columnIndexPerComponent{};
+
+	size_t m_chunkCapacity = 0;
+	size_t m_size = 0;
+	std::vector<std::unique_ptr<Chunk>> m_chunks;
+};
+
+//------------------------------------------------------------------------
+// ArchetypeStorage
+// Optional component storage of the Coordinator (see StorageMode). Groups entities by Signature into Archetypes.
+// Adding or removing a component moves the entity's row to the archetype of its new signature.
+// Note: unlike the Pool storage, a reference to any of the entity's components is invalidated when a component is added/removed on that entity.
+//------------------------------------------------------------------------
+class ArchetypeStorage
+{
+public:
+	// signature is the entity's signature before adding the component
+	template <typename TComponent>
+	void Add(size_t entityId, const Signature& signature, TComponent&& component);
+
+	// signature is the entity's signature before removing the component
+	template <typename TComponent>
+	void Remove(size_t entityId, const Signature& signature);
+
+	template <typename TComponent>
+	TComponent& Get(size_t entityId) const;
+
+	void RemoveEntity(size_t entityId);
+
+	// Collect all the archetypes that contain (at least) the required components, in creation order
+	void GetMatchingArchetypes(const Signature& required, std::vector<const Archetype*>& outArchetypes) const;
+
+private:
+	struct EntityLocation
+	{
+		Archetype* archetype = nullptr;
+		size_t row = 0;
+	};
+
+	Archetype& GetOrCreateArchetype(const Signature& signature);
+
+	// Move the entity to the archetype of newSignature, carrying over the components both signatures share. Returns the entity's new location.
+	EntityLocation MoveEntity(size_t entityId, const Signature& newSignature);
+
+	// [Vector index = entity id]
+	std::vector<EntityLocation> m_entityLocations;
+
+	std::unordered_map<Signature, std::unique_ptr<Archetype>> m_archetypes;
+
+	// Same archetypes as m_archetypes but in creation order, so queries iterate deterministically
+	std::vector<Archetype*> m_archetypesInOrder;
+
+	// [Vector index = component id]
+	std::vector<const ComponentTypeInfo*> m_componentTypeInfos;
+};
+
+template <typename TComponent>
+void ArchetypeStorage::Add(const size_t entityId, const Signature& signature, TComponent&& component)
+{
+	using TDecayed = std::decay_t<TComponent>;
+	const auto componentId = Component<TDecayed>::GetId();
+	if (componentId >= m_componentTypeInfos.size())
+	{
+		m_componentTypeInfos.resize(componentId + 1, nullptr);
+	}
+	m_componentTypeInfos[componentId] = ComponentTypeInfo::Of<TDecayed>();
+
+	Signature newSignature = signature;
+	newSignature.set(componentId);
+
+	const EntityLocation location = MoveEntity(entityId, newSignature);
+	new (location.archetype->GetComponent(componentId, location.row)) TDecayed(std::forward<TComponent>(component));
+}
+
+template <typename TComponent>
+void ArchetypeStorage::Remove(const size_t entityId, const Signature& signature)
+{
+	Signature newSignature = signature;
+	newSignature.reset(Component<TComponent>::GetId());
+	MoveEntity(entityId, newSignature);
+}
+
+template <typename TComponent>
+TComponent& ArchetypeStorage::Get(const size_t entityId) const
+{
+	const EntityLocation& location = m_entityLocations[entityId];
+	return *static_cast<TComponent*>(location.archetype->GetComponent(Component<TComponent>::GetId(), location.row));
+}
@@ -21,11 +21,18 @@ void Coordinator::Update()
 	// Processing the entities that are waiting to be killed from the active system
 	for (auto entity : m_entitiesToBeKilled)
 	{
+		// Already torn down through another handle of the same id
+		if (!IsEntityAlive(entity))
+		{
+			continue;
+		}
+
 		RemoveEntityFromSystem(entity);
 
 		m_entityComponentSignatures[entity.GetId()].reset();
 
-		// Remove the entity from the component pools
+		// Remove the entity from the component storage
+		m_archetypeStorage.RemoveEntity(entity.GetId());
 		for (const auto& pool : m_componentPools)
 		{
 			if (pool)
@@ -41,7 +48,8 @@ void Coordinator::Update()
 		// Remove all relationships
 		RemoveAllRelationships(entity);
 
-		// Make the entity id available to be reused
+		// Invalidate the handles of the entity, then make its id available to be reused
+		m_entityGenerations[entity.GetId()] = (m_entityGenerations[entity.GetId()] + 1) & Entity::GENERATION_MASK;
 		m_freeIds.push_back(entity.GetId());
 	}
 	m_entitiesToBeKilled.clear();
@@ -64,14 +72,14 @@ Entity Coordinator::CreateEntity()
 		// Logger::Warn("no free ids");
 		entityId = m_numEntities++;
 
-		// Ensure that m_entityComponentSignatures doesn't exceed the limit of INT_MAX.
-		assert(m_entityComponentSignatures.size() <= static_cast<size_t>(INT_MAX) &&
-			"m_entityComponentSignatures size exceeds INT_MAX");
+		// Ensure that the id fits in the index bits of the handle
+		assert(entityId <= Entity::INDEX_MASK && "Too many entities for Entity::INDEX_BITS");
 
-		// Make sure the entityComponentSignatures vector can accommodate the new entity
+		// Make sure the entityComponentSignatures and entityGenerations vectors can accommodate the new entity
 		if (entityId >= m_entityComponentSignatures.size())
 		{
 			m_entityComponentSignatures.resize(entityId + 1);
+			m_entityGenerations.resize(entityId + 1, 0);
 		}
 	}
 	else
@@ -82,8 +90,7 @@ Entity Coordinator::CreateEntity()
 		m_freeIds.pop_front();
 	}
 
-	Entity entity(entityId);
-	entity.coordinator = this;
+	Entity entity(entityId, m_entityGenerations[entityId]);
 	m_entitiesToBeAdded.insert(entity);
 
 	// Logger::Log("Entity created with id = " + std::to_string(entityId));
@@ -93,10 +100,21 @@ Entity Coordinator::CreateEntity()
 void Coordinator::KillEntity(const Entity entity)
 {
 	// TODO: if the entity is part of the joint then also delete the joint
+	// A stale handle would kill the entity that reuses its id
+	if (!IsEntityAlive(entity))
+	{
+		return;
+	}
 	m_entitiesToBeKilled.insert(entity);
 	Logger::Log("Entity " + std::to_string(entity.GetId()) + " was killed!");
 }
 
+bool Coordinator::IsEntityAlive(const Entity entity) const
+{
+	const size_t entityId = entity.GetId();
+	return entityId < m_entityGenerations.size() && m_entityGenerations[entityId] == entity.GetGeneration();
+}
+
 //------------------------------------------------------------------------
 // Tag Management
 //------------------------------------------------------------------------
@@ -10,10 +10,12 @@
 #include <typeindex>
 #include <utility>
 
+#include "ArchetypeStorage.h"
 #include "Component.h"
 #include "Entity.h"
 #include "System.h"
 #include "Pool.h"
+#include "View.h"
 
 #include "src/Utils/Logger.h"
 
@@ -23,17 +25,35 @@ class IPool;
 constexpr unsigned int MAX_COMPONENTS = 32;
 using Signature = std::bitset<MAX_COMPONENTS>;
 
+// How the coordinator lays out component data in memory
+enum class StorageMode
+{
+	Pools,		// One packed Pool per component type (default)
+	Archetypes	// Entities with the same signature share SoA chunks, see ArchetypeStorage
+};
+
 class Coordinator
 {
 public:
-	Coordinator()
+	explicit Coordinator(const StorageMode storageMode = StorageMode::Pools) : m_storageMode(storageMode)
 	{
 		Logger::Log("Coordinator constructor called");
+		MakeCurrent();
 	}
 	~Coordinator()
 	{
 		Logger::Log("Coordinator destructor called");
+		if (Entity::s_coordinator == this)
+		{
+			Entity::s_coordinator = nullptr;
+		}
 	}
+	Coordinator(const Coordinator&) = delete;
+	Coordinator& operator=(const Coordinator&) = delete;
+
+	// Make the Entity handles resolve against this coordinator. A new coordinator makes itself the current one.
+	// Don't switch while another thread is using entities
+	void MakeCurrent() { Entity::s_coordinator = this; }
 
 	// The m_Coordinator Update() process the entities that are waiting to be added/killed
 	void Update();
@@ -41,6 +61,10 @@ public:
 	// Entity Management
 	Entity CreateEntity();
 	void KillEntity(Entity entity);
+	// O(1): the generation of the handle still matches the generation of its id
+	[[nodiscard]] bool IsEntityAlive(Entity entity) const;
+	// Between KillEntity() and the Update() that removes the entity
+	[[nodiscard]] bool IsEntityToBeKilled(Entity entity) const { return m_entitiesToBeKilled.count(entity) > 0; }
 
 	// Tag management
 	void TagEntity(Entity entity, const std::string& tag);
@@ -54,6 +78,8 @@ public:
 	[[nodiscard]] std::vector<Entity> GetEntitiesByGroup(const std::string& group) const;
 	void RemoveEntityGroup(Entity entity);
 
+	[[nodiscard]] StorageMode GetStorageMode() const { return m_storageMode; }
+
 	// Component management
 	template <typename TComponent, typename... TArgs>
 	void AddComponent(Entity entity, TArgs&&... args);
@@ -64,6 +90,10 @@ public:
 	template <typename TComponent>
 	TComponent& GetComponent(Entity entity);
 
+	// Iterate all the entities that have every component in TComponents. See ComponentView
+	template <typename... TComponents>
+	ComponentView<TComponents...> View();
+
 	// System management
 	template <typename TSystem, typename... TArgs>
 	void AddSystem(TArgs&&... args);
@@ -84,11 +114,23 @@ public:
 	[[nodiscard]] std::vector<std::pair<Entity, std::string>> GetRelationships(Entity source) const;
 	[[nodiscard]] bool HasRelationship(Entity source, Entity target, const std::string& relationshipTag) const;
 	[[nodiscard]] std::vector<Entity> GetEntitiesByRelationshipTag(const Entity& source, const std::string& relationshipTag) const;
+	// Same without the vector, for the per-frame loops: func(Entity) for every related entity that match relationship tag
+	template <typename TFunc>
+	void ForEachEntityByRelationshipTag(const Entity& source, const std::string& relationshipTag, TFunc&& func) const;
 	void RemoveAllRelationships(Entity entity); // To remove all relationships from an entity
 
 private:
+	// Returns the raw pool of TComponent or nullptr if no entity ever had that component
+	template <typename TComponent>
+	Pool<TComponent>* GetPool() const;
+
 	size_t m_numEntities = 0;
 
+	StorageMode m_storageMode;
+
+	// Component data when m_storageMode is StorageMode::Archetypes
+	ArchetypeStorage m_archetypeStorage;
+
 	// Vector of component pools, each pool contains all the data for a certain component types
 	// [Vector index = component type id]
 	// [Pool index = entity id]
@@ -98,6 +140,10 @@ private:
 	// [Vector index = entity id]
 	std::vector<Signature> m_entityComponentSignatures;
 
+	// Current generation of every entity id, incremented when the entity of that id is killed
+	// [Vector index = entity id]
+	std::vector<uint32_t> m_entityGenerations;
+
 	// Map of active systems
 	// [Map key = system type id]
 	std::unordered_map<std::type_index, std::shared_ptr<System>> m_systems;
@@ -119,7 +165,7 @@ private:
 	std::unordered_map<size_t, std::string> m_groupPerEntity;
 	// TODO: Entity should be able to belong to multiple groups
 
-	// List of free entity ids that were previously removed
+	// List of free entity ids that were previously removed. Reused first in first out, so the generation of a single id doesn't wrap around quickly
 	std::deque<size_t> m_freeIds;
 
 	// Map to manage relationships between entities
@@ -141,6 +187,13 @@ void Coordinator::AddComponent(const Entity entity, TArgs&& ...args)
 	// Ensuring entity doesn't have this component
 	if (!m_entityComponentSignatures[entityId].test(componentId))
 	{
+		if (m_storageMode == StorageMode::Archetypes)
+		{
+			m_archetypeStorage.Add(entityId, m_entityComponentSignatures[entityId], TComponent(std::forward<TArgs>(args)...));
+			m_entityComponentSignatures[entityId].set(componentId);
+			return;
+		}
+
 		// std::cout << "Here" << std::endl;
 		// Check if the list of Pools is big enough, if not resize()
 		if (componentId >= m_componentPools.size())
@@ -211,8 +264,14 @@ void Coordinator::RemoveComponent(const Entity entity)
 	if (const auto entityId = entity.GetId(); m_entityComponentSignatures[entityId].test(componentId))
 	{
 		// Remove the component from the component list for that entity
-		std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(m_componentPools[componentId]);
-		componentPool->Remove(entityId);
+		if (m_storageMode == StorageMode::Archetypes)
+		{
+			m_archetypeStorage.Remove<TComponent>(entityId, m_entityComponentSignatures[entityId]);
+		}
+		else
+		{
+			GetPool<TComponent>()->Remove(entityId);
+		}
 
 		// Set this component signature for that entity to false
 		m_entityComponentSignatures[entityId].set(componentId, false);
@@ -236,11 +295,48 @@ bool Coordinator::HasComponent(const Entity entity) const
 
 template <typename TComponent>
 TComponent& Coordinator::GetComponent(Entity entity)
+{
+	if (m_storageMode == StorageMode::Archetypes)
+	{
+		return m_archetypeStorage.Get<TComponent>(entity.GetId());
+	}
+	return GetPool<TComponent>()->Get(entity.GetId());
+}
+
+template <typename ... TComponents>
+ComponentView<TComponents...> Coordinator::View()
+{
+	if (m_storageMode == StorageMode::Archetypes)
+	{
+		return ComponentView<TComponents...>(m_entityGenerations, m_archetypeStorage);
+	}
+	return ComponentView<TComponents...>(m_entityGenerations, m_entityComponentSignatures, GetPool<TComponents>()...);
+}
+
+template <typename TFunc>
+void Coordinator::ForEachEntityByRelationshipTag(const Entity& source, const std::string& relationshipTag, TFunc&& func) const
+{
+	const auto [first, last] = m_relationships.equal_range(source);
+	for (auto it = first; it != last; ++it)
+	{
+		// it = [entity, relationshipPair<entity, relationshipTag>] = [leader, <follower, relationship>]
+		if (it->second.second == relationshipTag)
+		{
+			func(it->second.first);
+		}
+	}
+}
+
+template <typename TComponent>
+Pool<TComponent>* Coordinator::GetPool() const
 {
 	const auto componentId = Component<TComponent>::GetId();
-	const auto entityId = entity.GetId();
-	auto componentPool = std::static_pointer_cast<Pool<TComponent>>(m_componentPools[componentId]);
-	return componentPool->Get(entityId);
+	if (componentId >= m_componentPools.size())
+	{
+		return nullptr;
+	}
+	// static_cast on the raw pointer to avoid the atomic refcount of std::static_pointer_cast
+	return static_cast<Pool<TComponent>*>(m_componentPools[componentId].get());
 }
 
 //------------------------------------------------------------------------
@@ -251,6 +347,7 @@ void Coordinator::AddSystem(TArgs&& ...args)
 {
 	// TSystem* newSystem(new TSystem(std::forward<TArgs>(args)...));
 	std::unique_ptr<TSystem> newSystem(std::make_unique<TSystem>(std::forward<TArgs>(args)...));
+	newSystem->m_owner = this;
 	m_systems.insert(std::make_pair(std::type_index(typeid(TSystem)), std::move(newSystem)));
 }
 
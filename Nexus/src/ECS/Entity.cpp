@@ -3,13 +3,26 @@
 
 #include "Coordinator.h"
 
-size_t Entity::GetId() const { return m_id; }
+bool Entity::IsAlive() const
+{
+	return s_coordinator->IsEntityAlive(*this);
+}
+
+bool Entity::IsToBeKilled() const
+{
+	return s_coordinator->IsEntityToBeKilled(*this);
+}
 
 void Entity::Kill() const
 {
-	coordinator->RemoveEntityTag(*this);
-	coordinator->RemoveEntityGroup(*this);
-	coordinator->KillEntity(*this);
+	// The tag and group maps are keyed by id, they may belong to the entity that reuses it
+	if (!IsAlive())
+	{
+		return;
+	}
+	s_coordinator->RemoveEntityTag(*this);
+	s_coordinator->RemoveEntityGroup(*this);
+	s_coordinator->KillEntity(*this);
 }
 
 //------------------------------------------------------------------------
@@ -17,22 +30,22 @@ void Entity::Kill() const
 //------------------------------------------------------------------------
 void Entity::Tag(const std::string& tag) const
 {
-	coordinator->TagEntity(*this, tag);
+	s_coordinator->TagEntity(*this, tag);
 }
 
 bool Entity::HasTag(const std::string& tag) const
 {
-	return coordinator->EntityHasTag(*this, tag);
+	return s_coordinator->EntityHasTag(*this, tag);
 }
 
 void Entity::Group(const std::string& group) const
 {
-	coordinator->GroupEntity(*this, group);
+	s_coordinator->GroupEntity(*this, group);
 }
 
 bool Entity::BelongsToGroup(const std::string& group) const
 {
-	return coordinator->EntityBelongsToGroup(*this, group);
+	return s_coordinator->EntityBelongsToGroup(*this, group);
 }
 
 //------------------------------------------------------------------------
@@ -40,25 +53,25 @@ bool Entity::BelongsToGroup(const std::string& group) const
 //------------------------------------------------------------------------
 void Entity::AddRelationship(const Entity target, const std::string& relationshipTag) const
 {
-	coordinator->AddRelationship(*this, target, relationshipTag);
+	s_coordinator->AddRelationship(*this, target, relationshipTag);
 }
 
 void Entity::RemoveRelationship(const Entity target, const std::string& relationshipTag) const
 {
-	coordinator->RemoveRelationship(*this, target, relationshipTag);
+	s_coordinator->RemoveRelationship(*this, target, relationshipTag);
 }
 
 std::vector<std::pair<Entity, std::string>> Entity::GetRelationships() const
 {
-	return coordinator->GetRelationships(*this);
+	return s_coordinator->GetRelationships(*this);
 }
 
 bool Entity::HasRelationship(const Entity target, const std::string& relationshipTag) const
 {
-	return coordinator->HasRelationship(*this, target, relationshipTag);
+	return s_coordinator->HasRelationship(*this, target, relationshipTag);
 }
 
 std::vector<Entity> Entity::GetEntitiesByRelationshipTag(const std::string& relationshipTag) const
 {
-	return coordinator->GetEntitiesByRelationshipTag(*this, relationshipTag);
+	return s_coordinator->GetEntitiesByRelationshipTag(*this, relationshipTag);
 }
@@ -1,28 +1,48 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 class Coordinator;
 
+//------------------------------------------------------------------------
+// Entity
+// A 32-bit handle: the low INDEX_BITS are the entity id (its slot in the component storage) and the high GENERATION_BITS the generation of that slot.
+// The coordinator bumps the generation of a slot every time its entity is killed, so a handle kept after the kill (ex: JointConstraintComponent::a) no longer matches once the id is reused. IsAlive() checks that in O(1).
+// Handles don't store their coordinator, they resolve against the current one (see Coordinator::MakeCurrent()).
+//------------------------------------------------------------------------
 class Entity
 {
 public:
-	// Hold a pointer to the entity's owner coordinator
-	Coordinator* coordinator{};
+	static constexpr uint32_t INDEX_BITS = 20;
+	static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+	static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
 
-	explicit Entity(const size_t id) : m_id(id) {}
+	explicit Entity(const size_t id, const uint32_t generation = 0)
+		: m_handle(static_cast<uint32_t>(id & INDEX_MASK) | (generation & GENERATION_MASK) << INDEX_BITS)
+	{}
 	Entity(const Entity& other) = default;
 
-	[[nodiscard]] size_t GetId() const;
+	// Index of the entity in the component storage, ids of killed entities are reused
+	[[nodiscard]] size_t GetId() const { return m_handle & INDEX_MASK; }
+	[[nodiscard]] uint32_t GetGeneration() const { return m_handle >> INDEX_BITS; }
+	// Id and generation packed together, unique among all the entities ever created (until the generation wraps around)
+	[[nodiscard]] uint32_t GetHandle() const { return m_handle; }
+
+	// False once the entity was killed (from the Coordinator::Update() that removes it), even if its id was reused by a new entity
+	[[nodiscard]] bool IsAlive() const;
 	void Kill() const;
+	// Killed but still alive until the next Coordinator::Update()
+	[[nodiscard]] bool IsToBeKilled() const;
 
-	// For Entity to Entity comparisons
+	// For Entity to Entity comparisons. Handles of the same id but a different generation are different entities
 	Entity& operator= (const Entity& other) = default;
-	bool operator== (const Entity& other) const { return m_id == other.GetId(); }
-	bool operator!= (const Entity& other) const { return m_id != other.GetId(); }
-	bool operator> (const Entity& other) const { return m_id > other.GetId(); }
-	bool operator< (const Entity& other) const { return m_id < other.GetId(); }
+	bool operator== (const Entity& other) const { return m_handle == other.m_handle; }
+	bool operator!= (const Entity& other) const { return m_handle != other.m_handle; }
+	bool operator> (const Entity& other) const { return m_handle > other.m_handle; }
+	bool operator< (const Entity& other) const { return m_handle < other.m_handle; }
 
 	// Manage entity tags and groups
 	void Tag(const std::string& tag) const;
@@ -36,6 +56,8 @@ public:
 	[[nodiscard]] std::vector<std::pair<Entity, std::string>> GetRelationships() const; // Returns a vector<Entity, relationshipTag> containing all the related entities
 	[[nodiscard]] bool HasRelationship(Entity target, const std::string& relationshipTag) const; // Check if there exist a relationship with target entity
 	[[nodiscard]] std::vector<Entity> GetEntitiesByRelationshipTag(const std::string& relationshipTag) const; // Return a vector of related entities that match relationship tag
+	template <typename TFunc>
+	void ForEachEntityByRelationshipTag(const std::string& relationshipTag, TFunc&& func) const; // Call func(Entity) for each of them, without the vector
 
 	// Helper functions to manage Entity to Component interactions via coordinator
 	template <typename TComponent, typename ...TArgs>
@@ -48,31 +70,42 @@ public:
 	TComponent& GetComponent() const;
 
 private:
-	size_t m_id;
+	friend class Coordinator;
+
+	// The coordinator the handles resolve against, set by Coordinator::MakeCurrent()
+	inline static Coordinator* s_coordinator = nullptr;
+
+	uint32_t m_handle;
 };
 
 template<typename TComponent, typename ...TArgs>
 void Entity::AddComponent(TArgs&& ...args)
 {
-	coordinator->AddComponent<TComponent>(*this, std::forward<TArgs>(args)...);
+	s_coordinator->AddComponent<TComponent>(*this, std::forward<TArgs>(args)...);
 }
 
 template <typename TComponent>
 void Entity::RemoveComponent() const
 {
-	coordinator->RemoveComponent<TComponent>(*this);
+	s_coordinator->RemoveComponent<TComponent>(*this);
 }
 
 template<typename TComponent>
 bool Entity::HasComponent() const
 {
-	return coordinator->HasComponent<TComponent>(*this);
+	return s_coordinator->HasComponent<TComponent>(*this);
 }
 
 template <typename TComponent>
 TComponent& Entity::GetComponent() const
 {
-	return coordinator->GetComponent<TComponent>(*this);
+	return s_coordinator->GetComponent<TComponent>(*this);
+}
+
+template <typename TFunc>
+void Entity::ForEachEntityByRelationshipTag(const std::string& relationshipTag, TFunc&& func) const
+{
+	s_coordinator->ForEachEntityByRelationshipTag(*this, relationshipTag, std::forward<TFunc>(func));
 }
 
 // Specialize std::hash for Entity so that we can use Entity as a key for unordered_multimap for entity-entity relationship
@@ -83,7 +116,7 @@ namespace std
 	{
 		std::size_t operator()(const Entity& entity) const noexcept
 		{
-			return std::hash<size_t>()(entity.GetId());
+			return std::hash<uint32_t>()(entity.GetHandle());
 		}
 	};
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <array>
+#include <limits>
+#include <memory>
 #include <vector>
-#include <unordered_map>
 
 //------------------------------------------------------------------------
-// IPool 
+// IPool
 // A interface for pool which is just a vector (contiguous data) of objects of type Component<T>
 //------------------------------------------------------------------------
 class IPool
@@ -15,14 +17,21 @@ public:
 };
 
 //------------------------------------------------------------------------
-// Pool 
+// Pool
 // A pool is just a vector (contiguous data) of objects of type Component<T>
+// It is implemented as a sparse set:
+//   - m_data and m_entities are the packed (dense) arrays, m_entities[i] is the owner of m_data[i]
+//   - m_sparsePages maps an entity id to its dense index. The ids are split in fixed size pages that are only allocated when an entity of that range gets a component, so lookups are two array reads instead of a hash.
 //------------------------------------------------------------------------
 template <typename T>
 class Pool final : public IPool
 {
 public:
-	explicit Pool(size_t capacity = 100) { m_data.reserve(capacity); }
+	explicit Pool(size_t capacity = 100)
+	{
+		m_data.reserve(capacity);
+		m_entities.reserve(capacity);
+	}
 	~Pool() override = default;
 
 	[[nodiscard]] bool IsEmpty() const { return m_data.empty(); }
@@ -32,75 +41,122 @@ public:
 		//m_data.resize(n);
 		// reserve() should be faster compared to resize(). Because it only allocates the memory and doesn't initialize it. It also doesn't change size() so we can keep using it instead of declaring a separate size variable.
 		m_data.reserve(n);
+		m_entities.reserve(n);
+	}
+	void Clear()
+	{
+		m_data.clear();
+		m_entities.clear();
+		m_sparsePages.clear();
 	}
-	void Clear() { m_data.clear(); }
 	//void Add(T object) { m_data.push_back(object); } // Use Set to add objects
 	void Set(size_t entityId, T object)
 	{
-		if (m_entityToIndex.find(entityId) != m_entityToIndex.end())
+		size_t& sparseIndex = GetOrCreateSparseIndex(entityId);
+		if (sparseIndex != INVALID_INDEX)
 		{
 			// If the element already exist, replace the component object
-			size_t index = m_entityToIndex[entityId];
-			m_data[index] = object;
+			m_data[sparseIndex] = std::move(object);
 		}
 		else
 		{
-			size_t index = m_data.size();
-			m_entityToIndex.emplace(entityId, index);
-			m_indexToEntity.emplace(index, entityId);
-			if (index >= m_data.capacity())
+			sparseIndex = m_data.size();
+			if (sparseIndex >= m_data.capacity())
 			{
 				m_data.reserve(m_data.capacity() * 2);
+				m_entities.reserve(m_data.capacity());
 			}
-			m_data.push_back(object);
+			m_data.push_back(std::move(object));
+			m_entities.push_back(entityId);
 		}
 	}
 
 	void Remove(const size_t entityId)
 	{
-		// Copy the last element to the deleted position to keep the array packed
-		size_t indexOfRemoved = m_entityToIndex[entityId];
-		size_t indexOfLast = m_data.size() - 1;
-		m_data[indexOfRemoved] = m_data[indexOfLast];
+		// Move the last element to the deleted position to keep the array packed
+		const size_t indexOfRemoved = GetIndex(entityId);
+		const size_t indexOfLast = m_data.size() - 1;
+		const size_t entityIdOfLastElement = m_entities[indexOfLast];
+		if (indexOfRemoved != indexOfLast)
+		{
+			m_data[indexOfRemoved] = std::move(m_data[indexOfLast]);
+			m_entities[indexOfRemoved] = entityIdOfLastElement;
+		}
 
-		// Update the index-entity maps to point to the correct elements
-		const size_t entityIdOfLastElement = m_indexToEntity[indexOfLast];
-		m_entityToIndex[entityIdOfLastElement] = indexOfRemoved;
-		m_indexToEntity[indexOfRemoved] = entityIdOfLastElement;
+		// Update the sparse array to point to the correct elements
+		GetSparseIndex(entityIdOfLastElement) = indexOfRemoved;
+		GetSparseIndex(entityId) = INVALID_INDEX;
 
-		// Remove the last element from the vector
+		// Remove the last element from the packed arrays
 		m_data.pop_back();
-
-		// Remove the mappings for the removed entity
-		m_entityToIndex.erase(entityId);
-		m_indexToEntity.erase(indexOfLast);
+		m_entities.pop_back();
 	}
 
 	void RemoveEntityFromPool(const size_t entityId)  override
 	{
-		if (m_entityToIndex.find(entityId) != m_entityToIndex.end())
+		if (Contains(entityId))
 		{
 			Remove(entityId);
 		}
 	}
 
-	T& Get(const size_t entityId)
+	[[nodiscard]] bool Contains(const size_t entityId) const
 	{
+		return GetIndex(entityId) != INVALID_INDEX;
+	}
 
-		size_t index = m_entityToIndex[entityId];
-		return static_cast<T&>(m_data[index]);
+	T& Get(const size_t entityId)
+	{
+		return m_data[GetIndex(entityId)];
 	}
 	T& operator [](size_t index) { return m_data[index]; }
 
+	// Entity id that owns the component stored at the packed index
+	[[nodiscard]] size_t GetEntityId(const size_t index) const { return m_entities[index]; }
+	[[nodiscard]] const std::vector<size_t>& GetEntityIds() const { return m_entities; }
+
 private:
+	static constexpr size_t PAGE_SIZE = 1024;
+	static constexpr size_t INVALID_INDEX = std::numeric_limits<size_t>::max();
+	using SparsePage = std::array<size_t, PAGE_SIZE>;
+
+	[[nodiscard]] size_t GetIndex(const size_t entityId) const
+	{
+		const size_t page = entityId / PAGE_SIZE;
+		if (page >= m_sparsePages.size() || !m_sparsePages[page])
+		{
+			return INVALID_INDEX;
+		}
+		return (*m_sparsePages[page])[entityId % PAGE_SIZE];
+	}
+
+	// Only valid for entity ids whose page already exists
+	size_t& GetSparseIndex(const size_t entityId)
+	{
+		return (*m_sparsePages[entityId / PAGE_SIZE])[entityId % PAGE_SIZE];
+	}
+
+	size_t& GetOrCreateSparseIndex(const size_t entityId)
+	{
+		const size_t page = entityId / PAGE_SIZE;
+		if (page >= m_sparsePages.size())
+		{
+			m_sparsePages.resize(page + 1);
+		}
+		if (!m_sparsePages[page])
+		{
+			m_sparsePages[page] = std::make_unique<SparsePage>();
+			m_sparsePages[page]->fill(INVALID_INDEX);
+		}
+		return (*m_sparsePages[page])[entityId % PAGE_SIZE];
+	}
+
 	// The packed dynamic array of components (of generic type T). Didn't use the static array because it's size can't be changed. But later might switch to that based on the game for performance gains.
 	std::vector<T> m_data;
 
-	// TODO: Currently using unordered_maps to map between entity id and component pool index but it does have a performance penalty since unordered_maps are not contiguous. I used this because it has handy functions like find(), insert() and delete(). Switch to array.
-
-	// Map from an entity ID to a component pool index.
-	std::unordered_map<size_t, size_t> m_entityToIndex;
+	// The packed array of entity ids, parallel to m_data. [Vector index = component pool index]
+	std::vector<size_t> m_entities;
 
-	// Map from a component pool index to an entity ID.
-	std::unordered_map<size_t, size_t> m_indexToEntity;
-};
\ No newline at end of file
+	// Paged sparse array from an entity ID to a component pool index. [Page = entity id / PAGE_SIZE]
+	std::vector<std::unique_ptr<SparsePage>> m_sparsePages;
+};
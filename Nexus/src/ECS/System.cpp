@@ -6,17 +6,29 @@
 void System::AddEntityToSystem(const Entity entity)
 {
 	m_entities.push_back(entity);
+	OnEntityAdded(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity)
 {
-	m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), [&entity](const Entity other)
+	const auto removed = std::remove_if(m_entities.begin(), m_entities.end(), [&entity](const Entity other)
 		{
 			return entity == other;
-		}), m_entities.end());
+		});
+	if (removed != m_entities.end())
+	{
+		m_entities.erase(removed, m_entities.end());
+		OnEntityRemoved(entity);
+	}
 }
 
-std::vector<Entity> System::GetSystemEntities() const
+void System::OnEntityAdded(Entity entity)
+{}
+
+void System::OnEntityRemoved(Entity entity)
+{}
+
+const std::vector<Entity>& System::GetSystemEntities() const
 {
 	return m_entities;
 }
@@ -7,22 +7,48 @@
 // TODO: Refactor the magic number from coordinator
 using Signature = std::bitset<32>;
 class Entity;
+class Coordinator;
 
 class System
 {
 public:
+	virtual ~System() = default;
+
 	void AddEntityToSystem(Entity entity);
 	void RemoveEntityFromSystem(Entity entity);
-	[[nodiscard]] std::vector<Entity> GetSystemEntities() const;
+	[[nodiscard]] const std::vector<Entity>& GetSystemEntities() const;
 	[[nodiscard]] const Signature& GetComponentSignature() const;
 
 	// Define the component type T that the entities must have to be considered by the system
 	template <typename TComponent>
 	void RequireComponent();
 
+	// Declare the component types the system's update reads or writes (for any entity, not only its own). The SystemScheduler runs the systems whose accesses don't conflict in parallel.
+	// A system that declares nothing is exclusive: it conflicts with every other system (ex: it emits events or creates entities)
+	template <typename TComponent>
+	void ReadComponent();
+	template <typename TComponent>
+	void WriteComponent();
+	[[nodiscard]] const Signature& GetReadSignature() const { return m_readSignature; }
+	[[nodiscard]] const Signature& GetWriteSignature() const { return m_writeSignature; }
+	[[nodiscard]] bool IsExclusive() const { return m_readSignature.none() && m_writeSignature.none(); }
+
+protected:
+	// Hooks called right after an entity is added to/removed from this system (during Coordinator::Update)
+	virtual void OnEntityAdded(Entity entity);
+	virtual void OnEntityRemoved(Entity entity);
+
+	// The coordinator that owns this system, e.g. to build component views
+	[[nodiscard]] Coordinator& GetCoordinator() const { return *m_owner; }
+
 private:
+	friend class Coordinator;
+
 	std::vector<Entity> m_entities;
 	Signature m_componentSignature;
+	Signature m_readSignature;
+	Signature m_writeSignature;
+	Coordinator* m_owner = nullptr;
 };
 
 template <typename TComponent>
@@ -31,3 +57,15 @@ void System::RequireComponent()
 	const auto componentId = Component<TComponent>::GetId();
 	m_componentSignature.set(componentId);
 }
+
+template <typename TComponent>
+void System::ReadComponent()
+{
+	m_readSignature.set(Component<TComponent>::GetId());
+}
+
+template <typename TComponent>
+void System::WriteComponent()
+{
+	m_writeSignature.set(Component<TComponent>::GetId());
+}
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "SystemScheduler.h"
+
+#include <algorithm>
+
+#include "System.h"
+
+#include "src/Utils/JobSystem.h"
+
+SystemScheduler::SystemScheduler() : m_mainThreadId(std::this_thread::get_id())
+{}
+
+void SystemScheduler::AddStep(const std::string& name, const System& system, StepFunction function)
+{
+	m_steps.push_back({ name, &system, std::move(function) });
+	m_timeline.push_back({ name });
+	m_areStagesDirty = true;
+}
+
+void SystemScheduler::Run(const float deltaTime)
+{
+	if (m_areStagesDirty)
+	{
+		BuildStages();
+	}
+
+	m_frameStartTime = std::chrono::steady_clock::now();
+	for (const auto& stage : m_stages)
+	{
+		JobSystem::ParallelFor(stage.size(), 1, [this, &stage, deltaTime](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				RunStep(stage[i], deltaTime);
+			}
+		});
+	}
+}
+
+bool SystemScheduler::Conflicts(const Step& a, const Step& b)
+{
+	// Steps of the same system share its member data
+	if (a.system == b.system || a.system->IsExclusive() || b.system->IsExclusive())
+	{
+		return true;
+	}
+	const auto& readsA = a.system->GetReadSignature();
+	const auto& writesA = a.system->GetWriteSignature();
+	const auto& readsB = b.system->GetReadSignature();
+	const auto& writesB = b.system->GetWriteSignature();
+	return (writesA & (readsB | writesB)).any() || (writesB & readsA).any();
+}
+
+void SystemScheduler::BuildStages()
+{
+	std::vector<size_t> stepStages(m_steps.size(), 0);
+	size_t stageCount = 0;
+	for (size_t j = 0; j < m_steps.size(); j++)
+	{
+		for (size_t i = 0; i < j; i++)
+		{
+			if (Conflicts(m_steps[i], m_steps[j]))
+			{
+				stepStages[j] = std::max(stepStages[j], stepStages[i] + 1);
+			}
+		}
+		stageCount = std::max(stageCount, stepStages[j] + 1);
+	}
+
+	m_stages.assign(stageCount, {});
+	for (size_t i = 0; i < m_steps.size(); i++)
+	{
+		m_stages[stepStages[i]].push_back(i);
+		m_timeline[i].stage = stepStages[i];
+	}
+	m_areStagesDirty = false;
+}
+
+void SystemScheduler::RunStep(const size_t stepIndex, const float deltaTime)
+{
+	using Milliseconds = std::chrono::duration<float, std::milli>;
+
+	TimelineEntry& entry = m_timeline[stepIndex];
+	entry.isMainThread = std::this_thread::get_id() == m_mainThreadId;
+	entry.startTime = Milliseconds(std::chrono::steady_clock::now() - m_frameStartTime).count();
+
+	m_steps[stepIndex].function(deltaTime);
+
+	entry.endTime = Milliseconds(std::chrono::steady_clock::now() - m_frameStartTime).count();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class System;
+
+//------------------------------------------------------------------------
+// SystemScheduler
+// Runs the per-frame system updates ("steps") in the order they were added, except that steps that don't conflict run at the same time on the JobSystem.
+// Two steps conflict if they belong to the same system, if one of them is exclusive or if one writes a component the other one reads or writes (see System::ReadComponent()/WriteComponent()).
+// Each step is put in the first stage after all the earlier steps it conflicts with, so conflicting steps keep their order. The stages run one after the other.
+//
+// Usage:
+//		scheduler.AddStep("Animation", animationSystem, [&](float deltaTime) { animationSystem.Update(assetManager, deltaTime); });
+//		scheduler.Run(deltaTime);
+//------------------------------------------------------------------------
+class SystemScheduler
+{
+public:
+	using StepFunction = std::function<void(float deltaTime)>;
+
+	// What ran, where and when during the last Run(). The times are in milliseconds since the start of Run()
+	struct TimelineEntry
+	{
+		std::string name;
+		size_t stage = 0;
+		bool isMainThread = true;
+		float startTime = 0.f;
+		float endTime = 0.f;
+	};
+
+	SystemScheduler();
+
+	// Append a step to the frame. The access sets of the system must be declared by then (usually in its constructor)
+	void AddStep(const std::string& name, const System& system, StepFunction function);
+
+	// Run every step once, deltaTime is passed to the steps as it is
+	void Run(float deltaTime);
+
+	[[nodiscard]] size_t GetStageCount() const { return m_stages.size(); }
+	// [Vector index = step index]
+	[[nodiscard]] const std::vector<TimelineEntry>& GetTimeline() const { return m_timeline; }
+
+private:
+	struct Step
+	{
+		std::string name;
+		const System* system;
+		StepFunction function;
+	};
+
+	[[nodiscard]] static bool Conflicts(const Step& a, const Step& b);
+
+	// Assign the steps to stages
+	void BuildStages();
+	void RunStep(size_t stepIndex, float deltaTime);
+
+	std::vector<Step> m_steps;
+	// Step indices per stage, the steps of a stage don't conflict with each other
+	std::vector<std::vector<size_t>> m_stages;
+	bool m_areStagesDirty = false;
+
+	std::vector<TimelineEntry> m_timeline;
+	std::chrono::steady_clock::time_point m_frameStartTime;
+	std::thread::id m_mainThreadId;
+};
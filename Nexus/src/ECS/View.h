@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "ArchetypeStorage.h"
+#include "Component.h"
+#include "Entity.h"
+#include "Pool.h"
+#include "System.h"
+
+//------------------------------------------------------------------------
+// ComponentView
+// A non-owning query over all the entities that have every component in TComponents. It yields direct references into the component storage, so there is no entity vector copy and no shared_ptr traffic per component lookup.
+//   - Pool storage: walks the packed entity array of the smallest pool and checks the entity signatures
+//   - Archetype storage: walks the chunks of every archetype that contains TComponents, no signature checks needed
+//
+// Usage:
+//		for (auto [entity, transform, rigidBody] : coordinator.View<TransformComponent, RigidBodyComponent>()) { ... }
+//		coordinator.View<TransformComponent>().ForEach([](Entity entity, TransformComponent& transform) { ... });
+//		coordinator.View<TransformComponent>().ForEachChunk([](size_t count, TransformComponent* transforms) { ... });
+//
+// Note: Views iterate the storage directly, so adding/removing components of the viewed types while iterating invalidates the view.
+//------------------------------------------------------------------------
+template <typename... TComponents>
+class ComponentView
+{
+public:
+	using Value = std::tuple<Entity, TComponents&...>;
+
+	// View over the component pools
+	ComponentView(const std::vector<uint32_t>& generations, const std::vector<Signature>& signatures, Pool<TComponents>*... pools)
+		: m_generations(&generations), m_signatures(&signatures), m_pools(pools...)
+	{
+		(m_requiredSignature.set(Component<TComponents>::GetId()), ...);
+
+		// An empty view if any of the pools was never created
+		if (((pools == nullptr) || ...))
+		{
+			return;
+		}
+
+		// Drive the iteration with the smallest pool since an entity has to be in all of them to match
+		for (const std::vector<size_t>* entityIds : { &pools->GetEntityIds()... })
+		{
+			if (!m_entityIds || entityIds->size() < m_entityIds->size())
+			{
+				m_entityIds = entityIds;
+			}
+		}
+	}
+
+	// View over the archetype storage
+	ComponentView(const std::vector<uint32_t>& generations, const ArchetypeStorage& archetypeStorage)
+		: m_generations(&generations), m_isArchetypeView(true)
+	{
+		(m_requiredSignature.set(Component<TComponents>::GetId()), ...);
+		archetypeStorage.GetMatchingArchetypes(m_requiredSignature, m_archetypes);
+	}
+
+	class Iterator
+	{
+	public:
+		Iterator(const ComponentView* view, const size_t index) : m_view(view), m_index(index) { SkipNonMatching(); }
+
+		Value operator*() const
+		{
+			if (m_view->m_isArchetypeView)
+			{
+				const Archetype* archetype = m_view->m_archetypes[m_index];
+				return m_view->MakeValue(archetype->GetEntityId(m_row), static_cast<TComponents*>(archetype->GetComponent(Component<TComponents>::GetId(), m_row))...);
+			}
+			return m_view->MakeValue((*m_view->m_entityIds)[m_index]);
+		}
+		Iterator& operator++()
+		{
+			if (m_view->m_isArchetypeView)
+			{
+				++m_row;
+			}
+			else
+			{
+				++m_index;
+			}
+			SkipNonMatching();
+			return *this;
+		}
+		bool operator==(const Iterator& other) const { return m_index == other.m_index && m_row == other.m_row; }
+		bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+	private:
+		void SkipNonMatching()
+		{
+			if (m_view->m_isArchetypeView)
+			{
+				// Step over to the next non empty archetype
+				while (m_index < m_view->m_archetypes.size() && m_row >= m_view->m_archetypes[m_index]->GetSize())
+				{
+					++m_index;
+					m_row = 0;
+				}
+				return;
+			}
+			while (m_index < m_view->GetDrivingSize() && !m_view->Matches((*m_view->m_entityIds)[m_index]))
+			{
+				++m_index;
+			}
+		}
+
+		const ComponentView* m_view;
+		size_t m_index;
+		size_t m_row = 0;
+	};
+
+	[[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+	[[nodiscard]] Iterator end() const { return Iterator(this, m_isArchetypeView ? m_archetypes.size() : GetDrivingSize()); }
+
+	// Invoke func(Entity, TComponents&...) for every matching entity
+	template <typename TFunc>
+	void ForEach(TFunc&& func) const
+	{
+		if (m_isArchetypeView)
+		{
+			// Stream each chunk column by column
+			for (const Archetype* archetype : m_archetypes)
+			{
+				for (size_t chunkIndex = 0; chunkIndex < archetype->GetChunkCount(); chunkIndex++)
+				{
+					const size_t* entityIds = archetype->GetEntityColumn(chunkIndex);
+					std::tuple<TComponents*...> columns(static_cast<TComponents*>(archetype->GetColumn(Component<TComponents>::GetId(), chunkIndex))...);
+					const size_t chunkSize = archetype->GetChunkSize(chunkIndex);
+					for (size_t i = 0; i < chunkSize; i++)
+					{
+						std::apply(func, MakeValue(entityIds[i], (std::get<TComponents*>(columns) + i)...));
+					}
+				}
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < GetDrivingSize(); ++i)
+		{
+			const size_t entityId = (*m_entityIds)[i];
+			if (Matches(entityId))
+			{
+				std::apply(func, MakeValue(entityId));
+			}
+		}
+	}
+
+	// Invoke func(count, TComponents*...) with arrays of count components, the same index being the same entity.
+	// Each chunk is one call in archetype storage. The pools don't line up the components of an entity, so there every matching entity is a call with count = 1
+	template <typename TFunc>
+	void ForEachChunk(TFunc&& func) const
+	{
+		if (m_isArchetypeView)
+		{
+			for (const Archetype* archetype : m_archetypes)
+			{
+				for (size_t chunkIndex = 0; chunkIndex < archetype->GetChunkCount(); chunkIndex++)
+				{
+					func(archetype->GetChunkSize(chunkIndex), static_cast<TComponents*>(archetype->GetColumn(Component<TComponents>::GetId(), chunkIndex))...);
+				}
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < GetDrivingSize(); ++i)
+		{
+			const size_t entityId = (*m_entityIds)[i];
+			if (Matches(entityId))
+			{
+				func(size_t{ 1 }, &std::get<Pool<TComponents>*>(m_pools)->Get(entityId)...);
+			}
+		}
+	}
+
+private:
+	[[nodiscard]] size_t GetDrivingSize() const { return m_entityIds ? m_entityIds->size() : 0; }
+
+	[[nodiscard]] bool Matches(const size_t entityId) const
+	{
+		return ((*m_signatures)[entityId] & m_requiredSignature) == m_requiredSignature;
+	}
+
+	[[nodiscard]] Entity MakeEntity(const size_t entityId) const
+	{
+		return Entity(entityId, (*m_generations)[entityId]);
+	}
+
+	[[nodiscard]] Value MakeValue(const size_t entityId) const
+	{
+		return Value(MakeEntity(entityId), std::get<Pool<TComponents>*>(m_pools)->Get(entityId)...);
+	}
+
+	[[nodiscard]] Value MakeValue(const size_t entityId, TComponents*... components) const
+	{
+		return Value(MakeEntity(entityId), *components...);
+	}
+
+	// Generation per entity id, to build the Entity handles
+	const std::vector<uint32_t>* m_generations;
+	Signature m_requiredSignature;
+
+	// Pool storage
+	const std::vector<Signature>* m_signatures = nullptr;
+	std::tuple<Pool<TComponents>*...> m_pools{};
+	// Packed entity ids of the smallest pool
+	const std::vector<size_t>* m_entityIds = nullptr;
+
+	// Archetype storage
+	bool m_isArchetypeView = false;
+	std::vector<const Archetype*> m_archetypes;
+};
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
-#include <map>
-#include <typeindex>
+#include <initializer_list>
 #include <memory>
-#include <list>
+#include <type_traits>
+#include <vector>
 
 #include "EventCallback.h"
 
@@ -12,7 +13,45 @@
 
 class EventManager
 {
-	using CallbackList = std::list<std::unique_ptr<IEventCallback>>;
+public:
+	// Returned by SubscribeToEvent() to unsubscribe later. 0 is never a valid subscription
+	using SubscriptionId = size_t;
+	static constexpr SubscriptionId INVALID_SUBSCRIPTION = 0;
+
+private:
+	// Type erased call: instance is the owner (member function) or the std::function callback, data is the TEvent (or the std::vector<TEvent> of a batch)
+	using Thunk = void (*)(void* instance, void* data);
+
+	struct Subscription
+	{
+		SubscriptionId id;
+		const void* owner;
+		void* instance;
+		Thunk thunk;
+		// Only for the std::function subscriptions, the instance points to it
+		std::unique_ptr<IEventCallback> callback;
+		// Set when it is unsubscribed during a dispatch, it is erased once the dispatch is over
+		bool isRemoved = false;
+	};
+	using SubscriptionList = std::vector<Subscription>;
+
+	// Events queued by QueueEvent() until the next flush
+	struct IEventQueue
+	{
+		virtual ~IEventQueue() = default;
+		virtual void Flush(EventManager& eventManager) = 0;
+	};
+
+	template <typename TEvent>
+	struct EventQueue final : IEventQueue
+	{
+		std::vector<TEvent> events;
+		// The events being flushed. The two vectors are swapped, so the events queued by the callbacks go to the next flush and both keep their capacity
+		std::vector<TEvent> flushingEvents;
+		bool isFlushing = false;
+
+		void Flush(EventManager& eventManager) override { eventManager.FlushQueue(*this); }
+	};
 
 public:
 	EventManager()
@@ -28,57 +67,254 @@ public:
 	// Clears the subscribers list
 	void Reset()
 	{
-		m_subscribers.clear();
+		ForEachSubscription([this](Subscription& subscription) { Remove(subscription); });
+		EraseRemovedSubscriptions();
 	}
 
 	//------------------------------------------------------------------------
 	// Subscribe to an event type <T>
-	// A listener subscribe to an event
-	// Example : eventManager->SubscribeToEvent<CollisionEvent>(this, &System::OnCollision);
+	// A listener subscribe to an event. The subscription lasts until it is unsubscribed, so subscribe once (e.g. when the system is initialized), not every frame
+	// Callback is a member function of the owner (or a static function) taking the event, it is called directly without any allocation
+	// Example : eventManager->SubscribeToEvent<CollisionEvent, &GameplaySystem::onCollision>(this);
 	// ------------------------------------------------------------------------
+	template <typename TEvent, auto Callback, typename TOwner>
+	SubscriptionId SubscribeToEvent(TOwner* ownerInstance)
+	{
+		return AddSubscription(m_subscribers, IEvent::GetId<TEvent>(), ownerInstance, ownerInstance, &Invoke<TOwner, TEvent, Callback>, nullptr);
+	}
+
+	// Receive the queued events of a flush all at once instead of one call per event (see QueueEvent()). Events emitted with EmitEvent() are not batched
+	// Callback takes a const std::vector<TEvent>&, in queue order
+	// Example : eventManager->SubscribeToEventBatch<CollisionEvent, &ConstraintSystem::OnCollisions>(this);
+	template <typename TEvent, auto Callback, typename TOwner>
+	SubscriptionId SubscribeToEventBatch(TOwner* ownerInstance)
+	{
+		return AddSubscription(m_batchSubscribers, IEvent::GetId<TEvent>(), ownerInstance, ownerInstance, &Invoke<TOwner, const std::vector<TEvent>, Callback>, nullptr);
+	}
+
+	// Same with any callable. Slower: the std::function is allocated on the heap and called through IEventCallback
+	// Example : eventManager->SubscribeToEvent<CollisionEvent>(this, callback);
 	template <typename TEvent, typename TOwner>
-	void SubscribeToEvent(TOwner* ownerInstance, std::function<void(TOwner*, TEvent&)> callbackFunction)
+	SubscriptionId SubscribeToEvent(TOwner* ownerInstance, std::function<void(TOwner*, TEvent&)> callbackFunction)
+	{
+		auto callback = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, std::move(callbackFunction));
+		const Thunk thunk = [](void* instance, void* event) { static_cast<IEventCallback*>(instance)->Execute(*static_cast<TEvent*>(event)); };
+		void* instance = callback.get();
+		return AddSubscription(m_subscribers, IEvent::GetId<TEvent>(), ownerInstance, instance, thunk, std::move(callback));
+	}
+
+	// Safe to call from a callback, the removed callback is not called anymore (even by the event being dispatched)
+	void Unsubscribe(const SubscriptionId id)
 	{
-		if (!m_subscribers[typeid(TEvent)].get())
+		ForEachSubscription([this, id](Subscription& subscription)
 		{
-			m_subscribers[typeid(TEvent)] = std::make_unique<CallbackList>();
-		}
-		auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction);
+			if (subscription.id == id)
+			{
+				Remove(subscription);
+			}
+		});
+		EraseRemovedSubscriptions();
+	}
 
-		// Since the subscriber is a unique pointer, we need to use std::move when we want to push it to a map. We use std::move to change the ownership of an object from one unique_ptr to another unique_ptr.
-		m_subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+	// Remove every subscription of the owner, e.g. when a system is removed. Safe to call from a callback
+	void UnsubscribeAll(const void* ownerInstance)
+	{
+		ForEachSubscription([this, ownerInstance](Subscription& subscription)
+		{
+			if (subscription.owner == ownerInstance)
+			{
+				Remove(subscription);
+			}
+		});
+		EraseRemovedSubscriptions();
 	}
 
 	//------------------------------------------------------------------------
 	// Emit an event type <T>
 	// As soon as something emits an event the game is blocked until all the listener callbacks are executed first
+	// The event is constructed once and every listener gets the same instance (by reference)
+	// The callbacks subscribed while the event is dispatched only receive the next events
 	// Example: eventManager->EmitEvent<CollisionEvent>(player, enemy);
 	// Bug: Try to always pass the concerned entities with events, The callback function are unable to retrieve system entities using GetSystemEntities().
 	//------------------------------------------------------------------------
 	template<typename TEvent, typename ...TArgs>
 	void EmitEvent(TArgs&& ...args)
 	{
+		const size_t eventId = IEvent::GetId<TEvent>();
+		if (eventId >= m_subscribers.size() || m_subscribers[eventId].empty())
+		{
+			Logger::Warn("No callbacks for event type!");
+			return;
+		}
+
+		TEvent event(std::forward<TArgs>(args)...);
+		Dispatch(m_subscribers, eventId, &event);
+	}
 
-		if (const auto eventCallbacks = m_subscribers[typeid(TEvent)].get())
+	//------------------------------------------------------------------------
+	// Queue an event type <T>
+	// Deferred version of EmitEvent(): the event is appended to the queue of its type and the listeners only get it at the next FlushEvents().
+	// Use it for the events emitted in bulk from the middle of a system update (collisions), keep EmitEvent() for the ones that must be handled right away (input)
+	// Example: eventManager->QueueEvent<CollisionEvent>(a, b, contacts);
+	//------------------------------------------------------------------------
+	template<typename TEvent, typename ...TArgs>
+	void QueueEvent(TArgs&& ...args)
+	{
+		const size_t eventId = IEvent::GetId<TEvent>();
+		if (eventId >= m_queues.size())
+		{
+			m_queues.resize(eventId + 1);
+		}
+		if (!m_queues[eventId])
 		{
-			for (auto& callback : *eventCallbacks)
+			m_queues[eventId] = std::make_unique<EventQueue<TEvent>>();
+		}
+		static_cast<EventQueue<TEvent>&>(*m_queues[eventId]).events.emplace_back(std::forward<TArgs>(args)...);
+	}
+
+	// Flush point: dispatch the queued events of type <T>. The batch listeners get all of them first, then every event goes to the other listeners in queue order
+	template<typename TEvent>
+	void FlushEvents()
+	{
+		const size_t eventId = IEvent::GetId<TEvent>();
+		if (eventId < m_queues.size() && m_queues[eventId])
+		{
+			m_queues[eventId]->Flush(*this);
+		}
+	}
+
+	// Flush point for every event type, in event id order
+	void FlushEvents()
+	{
+		// Indices: a callback can queue an event of a new type
+		for (size_t eventId = 0; eventId < m_queues.size(); eventId++)
+		{
+			if (m_queues[eventId])
 			{
-				TEvent event(std::forward<TArgs>(args)...);
-				callback->Execute(event);
+				m_queues[eventId]->Flush(*this);
 			}
 		}
+	}
+
+private:
+	template <typename TOwner, typename TData, auto Callback>
+	static void Invoke(void* instance, void* data)
+	{
+		if constexpr (std::is_member_function_pointer_v<decltype(Callback)>)
+		{
+			(static_cast<TOwner*>(instance)->*Callback)(*static_cast<TData*>(data));
+		}
 		else
 		{
-			Logger::Warn("No callbacks for event type!");
+			Callback(*static_cast<TData*>(data));
 		}
 	}
 
-private:
+	SubscriptionId AddSubscription(std::vector<SubscriptionList>& subscribers, const size_t eventId, const void* owner, void* instance, const Thunk thunk, std::unique_ptr<IEventCallback> callback)
+	{
+		if (eventId >= subscribers.size())
+		{
+			subscribers.resize(eventId + 1);
+		}
+		const SubscriptionId id = m_nextSubscriptionId++;
+		subscribers[eventId].push_back({ id, owner, instance, thunk, std::move(callback) });
+		return id;
+	}
+
+	void Dispatch(std::vector<SubscriptionList>& subscribers, const size_t eventId, void* data)
+	{
+		if (eventId >= subscribers.size())
+		{
+			return;
+		}
+
+		// Indices, not iterators: a callback can subscribe and reallocate the vector. The removed subscriptions stay until the outermost dispatch is over
+		m_dispatchDepth++;
+		const size_t count = subscribers[eventId].size();
+		for (size_t i = 0; i < count; i++)
+		{
+			const Subscription& subscription = subscribers[eventId][i];
+			if (!subscription.isRemoved)
+			{
+				subscription.thunk(subscription.instance, data);
+			}
+		}
+		m_dispatchDepth--;
+		EraseRemovedSubscriptions();
+	}
+
+	template <typename TEvent>
+	void FlushQueue(EventQueue<TEvent>& queue)
+	{
+		// A callback flushing the same queue again would swap the vectors being iterated, its events wait for the next flush instead
+		if (queue.isFlushing || queue.events.empty())
+		{
+			return;
+		}
+		queue.isFlushing = true;
+		queue.flushingEvents.swap(queue.events);
+
+		const size_t eventId = IEvent::GetId<TEvent>();
+		Dispatch(m_batchSubscribers, eventId, &queue.flushingEvents);
+		for (auto& event : queue.flushingEvents)
+		{
+			Dispatch(m_subscribers, eventId, &event);
+		}
+
+		queue.flushingEvents.clear();
+		queue.isFlushing = false;
+	}
+
+	template <typename TFunction>
+	void ForEachSubscription(const TFunction& function)
+	{
+		for (auto* subscribers : { &m_subscribers, &m_batchSubscribers })
+		{
+			for (auto& subscriptions : *subscribers)
+			{
+				for (auto& subscription : subscriptions)
+				{
+					function(subscription);
+				}
+			}
+		}
+	}
+
+	void Remove(Subscription& subscription)
+	{
+		subscription.isRemoved = true;
+		m_hasRemovedSubscriptions = true;
+	}
+
+	// Erase the removed subscriptions, unless an event is being dispatched
+	void EraseRemovedSubscriptions()
+	{
+		if (m_dispatchDepth > 0 || !m_hasRemovedSubscriptions)
+		{
+			return;
+		}
+		for (auto* subscribers : { &m_subscribers, &m_batchSubscribers })
+		{
+			for (auto& subscriptions : *subscribers)
+			{
+				subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(), [](const Subscription& subscription) { return subscription.isRemoved; }), subscriptions.end());
+			}
+		}
+		m_hasRemovedSubscriptions = false;
+	}
+
 	//------------------------------------------------------------------------
-	// This map will contain event as key and a list of callback functions as Value
-	// Example: <Key, Value> = <CollisionEvent, [subscriberCallback*, subscriberCallback*]
+	// [Vector index = event id (IEvent::GetId<TEvent>())] The subscriptions of each event type, stored contiguously in subscription order
+	// Example: m_subscribers[CollisionEvent id] = [subscription, subscription]
 	//------------------------------------------------------------------------
-	std::map<std::type_index, std::unique_ptr<CallbackList>> m_subscribers;
+	std::vector<SubscriptionList> m_subscribers;
+	// [Vector index = event id] Listeners of SubscribeToEventBatch()
+	std::vector<SubscriptionList> m_batchSubscribers;
+	// [Vector index = event id] Queued events, EventQueue<TEvent>
+	std::vector<std::unique_ptr<IEventQueue>> m_queues;
 
-	// TODO: Compare the performance of std::map vs std::unordered_map for subscribers. Decided to go with std::map because of cache friendliness as it is contiguous. But std::unordered_map has an average search complexity of O(1) compared to O(log N) for std::map.
-};
\ No newline at end of file
+	SubscriptionId m_nextSubscriptionId = INVALID_SUBSCRIPTION + 1;
+	// Number of EmitEvent() calls in progress, callbacks can emit events too
+	size_t m_dispatchDepth = 0;
+	bool m_hasRemovedSubscriptions = false;
+};
@@ -0,0 +1,5 @@
+#include "stdafx.h"
+#include "IEvent.h"
+
+/// Allocating memory for the static variable
+size_t IEvent::m_nextId = 0;
\ No newline at end of file
@@ -4,4 +4,16 @@ class IEvent
 {
 public:
 	IEvent() = default;
-};
\ No newline at end of file
+
+	/* Same as Component<T>::GetId(): the first time GetId() is called for an event type, it'll create a unique id which will remain same for each subsequent calls since id is also static.
+	 * The EventManager uses it to index its subscriptions */
+	template <typename TEvent>
+	static size_t GetId()
+	{
+		static auto id = m_nextId++;
+		return id;
+	}
+
+private:
+	static size_t m_nextId;
+};
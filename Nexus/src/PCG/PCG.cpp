@@ -8,11 +8,13 @@
 #include "src/ECS/Entity.h"
 
 #include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/CollisionFilterComponent.h"
 #include "src/Components/PolygonColliderComponent.h"
 #include "src/Components/RigidBodyComponent.h"
 #include "src/Components/SpriteComponent.h"
 #include "src/Components/TransformComponent.h"
 #include "src/Components/BoxColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
 #include "src/Components/CircleColliderComponent.h"
 #include "src/Components/ConstraintTypeComponent.h"
 #include "src/Components/JointConstraintComponent.h"
@@ -126,6 +128,7 @@ void PCG::SpawnHole(const std::unique_ptr<Coordinator>& coordinator, const std::
 		Vector2(0.f, -25.f) // offset
 	);
 	hole.Tag("Hole");
+	hole.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::HOLE);
 
 
 	Entity flag = coordinator->CreateEntity();
@@ -140,37 +143,15 @@ void PCG::SpawnHole(const std::unique_ptr<Coordinator>& coordinator, const std::
 
 void PCG::AddTerrain(const std::unique_ptr<Coordinator>& coordinator, const std::vector<Vector2>& terrainVertices, const float elasticity, const float friction)
 {
-	for (size_t i = 0; i < terrainVertices.size() - 1; i++)
-	{
-		const Vector2& currentPos = terrainVertices[i];
-		const Vector2& nextPos = terrainVertices[i + 1];
-		float xDifference = nextPos.x - currentPos.x;
-		float yDifference = nextPos.y - currentPos.y;
-		constexpr float colliderDepth = 500.f;
-
-		// Terrain entity will be a point with polygon collider stretching till the next point
-		Entity terrain = coordinator->CreateEntity();
-		terrain.AddComponent<TransformComponent>(currentPos, Vector2(1.f, 1.f));
-
-		// Add collider type
-		terrain.AddComponent<ColliderTypeComponent>(ColliderType::Polygon);
-		std::vector<Vector2> polygonVertices;
-		polygonVertices.emplace_back(0.f, -colliderDepth); // Bottom left
-		polygonVertices.emplace_back(xDifference, yDifference - colliderDepth);    // Bottom right
-		polygonVertices.emplace_back(xDifference, yDifference);    // Top right
-		polygonVertices.emplace_back(0.f, 0.f); // Top left
-		terrain.AddComponent<PolygonColliderComponent>(polygonVertices);
-		terrain.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.0f, 0.0f, 0.0f, elasticity, friction);
-		terrain.Group("Terrain");
-
-		// Adding a circle collider between 2 points because the collision resolution b/w circle and polygon vertex is not stable
-		// Entity terrainConnector = m_coordinator->CreateEntity();
-		// terrainConnector.AddComponent<TransformComponent>(nextPos, Vector2(1.f, 1.f));
-		// terrainConnector.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.0f, 0.0f, 0.0f, elasticity, friction);
-		// terrainConnector.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
-		// terrainConnector.AddComponent<CircleColliderComponent>(1.f);
-		// terrainConnector.Group("Terrain");
-	}
+	// A single entity with a chain collider along the ground surface, the solid side is below the points
+	constexpr float colliderDepth = 500.f;
+	Entity terrain = coordinator->CreateEntity();
+	terrain.AddComponent<TransformComponent>(Vector2(), Vector2(1.f, 1.f));
+	terrain.AddComponent<ColliderTypeComponent>(ColliderType::Chain);
+	terrain.AddComponent<ChainColliderComponent>(terrainVertices, colliderDepth);
+	terrain.AddComponent<RigidBodyComponent>(Vector2(), Vector2(), false, 0.0f, 0.0f, 0.0f, elasticity, friction);
+	terrain.Group("Terrain");
+	terrain.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::TERRAIN);
 }
 
 void PCG::AddObstacles(const std::unique_ptr<Coordinator>& coordinator, const std::unique_ptr<AssetManager>& assetManager, std::vector<Vector2>& terrainVertices)
@@ -240,6 +221,7 @@ void PCG::SpawnLaser(const std::unique_ptr<Coordinator>& coordinator, const std:
 	shooter1.AddComponent<CircleColliderComponent>(assetManager->GetSpriteHeight("laser_shooter") * 0.42f);
 	shooter1.AddComponent<RigidBodyComponent>(Vector2(0.0f, 0.0f), Vector2(), false, 0.f, 0.f, 0.0f, 0.1f, 0.1f);
 	shooter1.Group("LaserShooter");
+	shooter1.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::LASER_SHOOTER);
 
 	// Create the laser entity
 	Entity laser = coordinator->CreateEntity();
@@ -262,6 +244,7 @@ void PCG::SpawnLaser(const std::unique_ptr<Coordinator>& coordinator, const std:
 	laser.AddComponent<ColliderTypeComponent>(ColliderType::Box);
 	laser.AddComponent<BoxColliderComponent>(assetManager->GetSpriteWidth("laser"), assetManager->GetSpriteHeight("laser") * 0.9f);
 	laser.Group("StaticKillers");
+	laser.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::STATIC_KILLERS);
 }
 
 void PCG::SpawnPendulum(const std::unique_ptr<Coordinator>& coordinator,
@@ -278,6 +261,7 @@ void PCG::SpawnPendulum(const std::unique_ptr<Coordinator>& coordinator,
 	anchor.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
 	anchor.AddComponent<CircleColliderComponent>(assetManager->GetSpriteWidth("star") / 2);
 	anchor.Group("Anchor");
+	anchor.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::ANCHOR);
 
 	Entity ball = coordinator->CreateEntity();
 	ball.AddComponent<TransformComponent>(Vector2(terrainPoint.x, terrainPoint.y + 100.f), Vector2(1.f, 1.0f));
@@ -286,6 +270,7 @@ void PCG::SpawnPendulum(const std::unique_ptr<Coordinator>& coordinator,
 	ball.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
 	ball.AddComponent<CircleColliderComponent>(assetManager->GetSpriteWidth("ball_blue") / 2);
 	ball.Group("Spring");
+	ball.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::SPRING);
 	anchor.AddRelationship(ball, "Spring");
 
 }
@@ -313,6 +298,7 @@ void PCG::SpawnConnectedBeads(const std::unique_ptr<Coordinator>& coordinator,
 	bead.AddComponent<ColliderTypeComponent>(ColliderType::Circle);
 	bead.AddComponent<CircleColliderComponent>(assetManager->GetSpriteWidth("ball_blue2") / 2);
 	bead.Group("Spring");
+	bead.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::SPRING);
 	anchor.AddRelationship(bead, "Spring");
 
 	std::vector<Entity> joinedEntities;
@@ -328,6 +314,7 @@ void PCG::SpawnConnectedBeads(const std::unique_ptr<Coordinator>& coordinator,
 		beadSubsequent.AddComponent<CircleColliderComponent>(assetManager->GetSpriteWidth("ball_blue2") / 2);
 		beadSubsequent.AddComponent<SpriteComponent>("ball_blue2");
 		beadSubsequent.Group("Bead");
+		beadSubsequent.AddComponent<CollisionFilterComponent>(CollisionFilter::Category::BEAD);
 		joinedEntities.push_back(beadSubsequent);
 	}
 
@@ -26,7 +26,7 @@ public:
 	// Spawn win hole near the end. It also modifies the terrain vertices to make sure the hole is on the level ground
 	static void SpawnHole(const std::unique_ptr<Coordinator>& coordinator, const std::unique_ptr<AssetManager>& assetManager, Vector2 position);
 
-	// Spawn polygon colliders based on the terrain vertices.
+	// Spawn a chain collider along the terrain vertices.
 	static void AddTerrain(const std::unique_ptr<Coordinator>& coordinator, const std::vector<Vector2>& terrainVertices, const float elasticity, const float friction);
 	// Spawn random obstacles based on the terrain vertices
 	static void AddObstacles(const std::unique_ptr<Coordinator>& coordinator, const std::unique_ptr<AssetManager>& assetManager, std::vector<Vector2>& terrainVertices);
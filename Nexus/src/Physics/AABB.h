@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "src/Utils/Vector2.h"
+
+/**
+ * AABB (Axis-Aligned Bounding Box) used by the collision broad phase
+ * @param min (Vector2): Bottom left corner
+ * @param max (Vector2): Top right corner
+*/
+struct AABB
+{
+	Vector2 min;
+	Vector2 max;
+
+	AABB() = default;
+	AABB(const Vector2& min, const Vector2& max) : min(min), max(max) {}
+
+	[[nodiscard]] bool Overlaps(const AABB& other) const
+	{
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y;
+	}
+
+	// Returns true if the other box is completely inside this box
+	[[nodiscard]] bool Contains(const AABB& other) const
+	{
+		return min.x <= other.min.x && min.y <= other.min.y &&
+			other.max.x <= max.x && other.max.y <= max.y;
+	}
+
+	// Returns true if the segment start -> end crosses the box (slab test)
+	[[nodiscard]] bool IntersectsSegment(const Vector2& start, const Vector2& end) const
+	{
+		float tMin = 0.f;
+		float tMax = 1.f;
+
+		const float direction[2] = { end.x - start.x, end.y - start.y };
+		const float origin[2] = { start.x, start.y };
+		const float boxMin[2] = { min.x, min.y };
+		const float boxMax[2] = { max.x, max.y };
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (std::abs(direction[axis]) < 1e-8f)
+			{
+				// Parallel to the slab, the origin has to be inside it
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+				{
+					return false;
+				}
+				continue;
+			}
+			float t1 = (boxMin[axis] - origin[axis]) / direction[axis];
+			float t2 = (boxMax[axis] - origin[axis]) / direction[axis];
+			if (t1 > t2)
+			{
+				std::swap(t1, t2);
+			}
+			tMin = std::max(tMin, t1);
+			tMax = std::min(tMax, t2);
+			if (tMin > tMax)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] float Perimeter() const
+	{
+		return 2.f * ((max.x - min.x) + (max.y - min.y));
+	}
+
+	// Grow the box by margin on every side
+	[[nodiscard]] AABB Fattened(const float margin) const
+	{
+		return { Vector2(min.x - margin, min.y - margin), Vector2(max.x + margin, max.y + margin) };
+	}
+
+	[[nodiscard]] static AABB Union(const AABB& a, const AABB& b)
+	{
+		return {
+			Vector2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+			Vector2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y))
+		};
+	}
+};
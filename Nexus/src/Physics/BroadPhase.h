@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "src/ECS/Entity.h"
+#include "src/Physics/AABB.h"
+
+// Candidate pair of entities whose bounding boxes overlap
+struct BroadPhasePair
+{
+	Entity a;
+	Entity b;
+};
+
+//------------------------------------------------------------------------
+// IBroadPhase
+// Interface for the collision broad phase. It keeps one proxy (an AABB) per collider and reports the pairs of proxies that overlap, so the CollisionSystem only runs the narrow phase (IsColliding) on those.
+// Static proxies (terrain, obstacles...) never move, so pairs between two static proxies are never reported.
+//------------------------------------------------------------------------
+class IBroadPhase
+{
+public:
+	static constexpr int NULL_PROXY = -1;
+
+	virtual ~IBroadPhase() = default;
+
+	// Returns the proxy id that is used to move/destroy the proxy later
+	virtual int CreateProxy(const AABB& aabb, Entity entity, bool isStatic) = 0;
+	virtual void DestroyProxy(int proxyId) = 0;
+
+	// Update the bounds of a (non-static) proxy. Displacement is the expected movement of the collider in the next step
+	virtual void MoveProxy(int proxyId, const AABB& aabb, const Vector2& displacement) = 0;
+
+	// Clear the outPairs vector and fill it with all the pairs of proxies whose AABBs overlap. Each pair is reported once.
+	virtual void FindPairs(std::vector<BroadPhasePair>& outPairs) = 0;
+
+	// Clear the outEntities vector and fill it with the entities whose AABB overlaps the region
+	virtual void QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const = 0;
+
+	// Clear the outEntities vector and fill it with the entities whose AABB is crossed by the segment start -> end. The order is not sorted by distance.
+	virtual void RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const = 0;
+
+	[[nodiscard]] virtual size_t GetProxyCount() const = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+//------------------------------------------------------------------------
+// CollisionFilter
+// Every collider belongs to one or more categories (bits) and has a mask of the categories it can collide with. Two colliders are only tested when each one's category is in the other's mask.
+// The mask of a category is not written by hand, it is derived from the IGNORE_RULES table below.
+//------------------------------------------------------------------------
+namespace CollisionFilter
+{
+	namespace Category
+	{
+		constexpr uint32_t DEFAULT = 1u << 0;
+		constexpr uint32_t TERRAIN = 1u << 1;
+		constexpr uint32_t LASER_SHOOTER = 1u << 2;
+		constexpr uint32_t STATIC_KILLERS = 1u << 3;
+		constexpr uint32_t ANCHOR = 1u << 4;
+		constexpr uint32_t SPRING = 1u << 5;
+		constexpr uint32_t BEAD = 1u << 6;
+		constexpr uint32_t HOLE = 1u << 7;
+
+		constexpr uint32_t ALL = 0xFFFFFFFFu;
+	}
+
+	struct IgnoreRule
+	{
+		uint32_t category;
+		uint32_t ignoredCategories;
+	};
+
+	// The obstacles don't collide with their own kind (ex: terrain segments touching each other) and the hole ignores all of them, only the balls and shapes can fall in
+	constexpr uint32_t HOLE_IGNORED = Category::TERRAIN | Category::LASER_SHOOTER | Category::STATIC_KILLERS | Category::ANCHOR | Category::SPRING | Category::BEAD | Category::HOLE;
+	constexpr IgnoreRule IGNORE_RULES[] = {
+		{ Category::TERRAIN,		Category::TERRAIN | Category::HOLE },
+		{ Category::LASER_SHOOTER,	Category::LASER_SHOOTER | Category::HOLE },
+		{ Category::STATIC_KILLERS,	Category::STATIC_KILLERS | Category::HOLE },
+		{ Category::ANCHOR,			Category::ANCHOR | Category::HOLE },
+		{ Category::SPRING,			Category::SPRING | Category::HOLE },
+		{ Category::BEAD,			Category::BEAD | Category::HOLE },
+		{ Category::HOLE,			HOLE_IGNORED },
+	};
+
+	// Mask of the categories that the given categories (one or more bits) can collide with
+	constexpr uint32_t GetMask(const uint32_t categories)
+	{
+		uint32_t mask = Category::ALL;
+		for (const auto& rule : IGNORE_RULES)
+		{
+			if (categories & rule.category)
+			{
+				mask &= ~rule.ignoredCategories;
+			}
+		}
+		return mask;
+	}
+
+	// Same as Box2D: colliders sharing a positive group index always collide and colliders sharing a negative group index never collide, regardless of their categories
+	constexpr bool ShouldCollide(const uint32_t aCategory, const uint32_t aMask, const int16_t aGroupIndex,
+		const uint32_t bCategory, const uint32_t bMask, const int16_t bGroupIndex)
+	{
+		if (aGroupIndex != 0 && aGroupIndex == bGroupIndex)
+		{
+			return aGroupIndex > 0;
+		}
+		return (aCategory & bMask) != 0 && (bCategory & aMask) != 0;
+	}
+
+	static_assert(!(GetMask(Category::TERRAIN) & Category::TERRAIN), "Terrain segments shouldn't collide with each other");
+	static_assert(GetMask(Category::TERRAIN) & Category::DEFAULT, "Terrain should collide with the default colliders");
+}
@@ -9,4 +9,12 @@ namespace Physics
 	constexpr int SCREEN_HEIGHT = APP_VIRTUAL_HEIGHT; // 768 : effective Y resolution regardless of actual screen/window res
 
 	constexpr float gravity = 9.8f;
+
+	// Sleeping: an island goes to sleep when all its bodies stayed under these speeds for TIME_TO_SLEEP seconds
+	constexpr float LINEAR_SLEEP_TOLERANCE = 0.05f * PIXEL_PER_METER; // Pixels per second
+	constexpr float ANGULAR_SLEEP_TOLERANCE = 0.035f; // Radians per second (~2 degrees)
+	constexpr float TIME_TO_SLEEP = 0.5f; // Seconds
+
+	// Continuous collision detection: a bullet stopped at its first impact is moved this far into the surface, so the next collision step finds the contact
+	constexpr float CCD_TARGET_PENETRATION = 0.01f * PIXEL_PER_METER; // Pixels
 }
\ No newline at end of file
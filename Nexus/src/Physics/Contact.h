@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "src/Utils/Vector2.h"
 
 /**
@@ -8,6 +10,7 @@
  * @param endContactPoint (Vector2): End contact point (From "a" to "b")
  * @param collisionNormal (Vector2): Normal Direction from "a" to "b"
  * @param penetrationDepth (Float): The penetration length of the collision
+ * @param featureId (uint32_t): Identifies the features (edges/vertices) that generated the contact, so that the same contact can be recognised in the next frame. 0 for circle-circle
 */
 struct Contact
 {
@@ -15,8 +18,9 @@ struct Contact
 	Vector2 endContactPoint;
 	Vector2 collisionNormal;
 	float penetrationDepth;
+	uint32_t featureId;
 
-	Contact(const Vector2& startContactPoint = Vector2(), const Vector2& endContactPoint = Vector2(), const Vector2& collisionNormal = Vector2(), float penetrationDepth = 0.0f) :
-		startContactPoint(startContactPoint), endContactPoint(endContactPoint), collisionNormal(collisionNormal), penetrationDepth(penetrationDepth)
+	Contact(const Vector2& startContactPoint = Vector2(), const Vector2& endContactPoint = Vector2(), const Vector2& collisionNormal = Vector2(), float penetrationDepth = 0.0f, const uint32_t featureId = 0) :
+		startContactPoint(startContactPoint), endContactPoint(endContactPoint), collisionNormal(collisionNormal), penetrationDepth(penetrationDepth), featureId(featureId)
 	{}
 };
\ No newline at end of file
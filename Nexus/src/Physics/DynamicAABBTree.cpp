@@ -0,0 +1,455 @@
+#include "stdafx.h"
+#include "DynamicAABBTree.h"
+
+#include <algorithm>
+
+int DynamicAABBTree::CreateProxy(const AABB& aabb, const Entity entity, const bool isStatic)
+{
+	const int proxyId = AllocateNode();
+	TreeNode& node = m_nodes[proxyId];
+	node.aabb = aabb.Fattened(AABB_MARGIN);
+	node.tightAABB = aabb;
+	node.entity = entity;
+	node.isStatic = isStatic;
+	node.height = 0;
+
+	InsertLeaf(proxyId);
+
+	if (!isStatic)
+	{
+		m_dynamicLeaves.push_back(proxyId);
+	}
+	++m_proxyCount;
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(const int proxyId)
+{
+	// Only leaves are proxies
+	if (proxyId < 0 || proxyId >= static_cast<int>(m_nodes.size()) || m_nodes[proxyId].height != 0)
+	{
+		return;
+	}
+
+	if (!m_nodes[proxyId].isStatic)
+	{
+		const auto it = std::find(m_dynamicLeaves.begin(), m_dynamicLeaves.end(), proxyId);
+		*it = m_dynamicLeaves.back();
+		m_dynamicLeaves.pop_back();
+	}
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	--m_proxyCount;
+}
+
+void DynamicAABBTree::MoveProxy(const int proxyId, const AABB& aabb, const Vector2& displacement)
+{
+	TreeNode& node = m_nodes[proxyId];
+
+	// Static proxies are never reinserted
+	if (node.isStatic)
+	{
+		return;
+	}
+	node.tightAABB = aabb;
+
+	// Fat AABB grown by the margin and stretched along the expected displacement
+	AABB fatAABB = aabb.Fattened(AABB_MARGIN);
+	const Vector2 stretch = displacement * DISPLACEMENT_MULTIPLIER;
+	(stretch.x < 0.f ? fatAABB.min.x : fatAABB.max.x) += stretch.x;
+	(stretch.y < 0.f ? fatAABB.min.y : fatAABB.max.y) += stretch.y;
+
+	if (node.aabb.Contains(aabb))
+	{
+		// Still inside its fat AABB. Keep it unless the fat AABB became too large (e.g. a fast body that stopped)
+		const AABB largeAABB = fatAABB.Fattened(4.f * AABB_MARGIN);
+		if (largeAABB.Contains(node.aabb))
+		{
+			return;
+		}
+	}
+
+	RemoveLeaf(proxyId);
+	m_nodes[proxyId].aabb = fatAABB;
+	InsertLeaf(proxyId);
+}
+
+void DynamicAABBTree::FindPairs(std::vector<BroadPhasePair>& outPairs)
+{
+	outPairs.clear();
+
+	// Only the moving proxies query the tree. Static-static pairs are never needed
+	for (const int leaf : m_dynamicLeaves)
+	{
+		const TreeNode& node = m_nodes[leaf];
+
+		m_stack.clear();
+		m_stack.push_back(m_root);
+		while (!m_stack.empty())
+		{
+			const int nodeId = m_stack.back();
+			m_stack.pop_back();
+			if (nodeId == NULL_PROXY)
+			{
+				continue;
+			}
+
+			const TreeNode& other = m_nodes[nodeId];
+			if (!other.aabb.Overlaps(node.aabb))
+			{
+				continue;
+			}
+
+			if (!other.IsLeaf())
+			{
+				m_stack.push_back(other.child1);
+				m_stack.push_back(other.child2);
+				continue;
+			}
+
+			// A pair of moving proxies is found from both sides, keep only one of them
+			if (nodeId == leaf || (!other.isStatic && nodeId < leaf))
+			{
+				continue;
+			}
+
+			// The fat AABBs overlap, the actual bounds have to overlap too
+			if (node.tightAABB.Overlaps(other.tightAABB))
+			{
+				outPairs.push_back({ node.entity, other.entity });
+			}
+		}
+	}
+}
+
+void DynamicAABBTree::QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty())
+	{
+		const int nodeId = m_stack.back();
+		m_stack.pop_back();
+		if (nodeId == NULL_PROXY)
+		{
+			continue;
+		}
+
+		const TreeNode& node = m_nodes[nodeId];
+		if (!node.aabb.Overlaps(region))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			if (node.tightAABB.Overlaps(region))
+			{
+				outEntities.push_back(node.entity);
+			}
+		}
+		else
+		{
+			m_stack.push_back(node.child1);
+			m_stack.push_back(node.child2);
+		}
+	}
+}
+
+void DynamicAABBTree::RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+
+	m_stack.clear();
+	m_stack.push_back(m_root);
+	while (!m_stack.empty())
+	{
+		const int nodeId = m_stack.back();
+		m_stack.pop_back();
+		if (nodeId == NULL_PROXY)
+		{
+			continue;
+		}
+
+		const TreeNode& node = m_nodes[nodeId];
+		if (!node.aabb.IntersectsSegment(start, end))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			if (node.tightAABB.IntersectsSegment(start, end))
+			{
+				outEntities.push_back(node.entity);
+			}
+		}
+		else
+		{
+			m_stack.push_back(node.child1);
+			m_stack.push_back(node.child2);
+		}
+	}
+}
+
+int DynamicAABBTree::GetHeight() const
+{
+	return m_root == NULL_PROXY ? 0 : m_nodes[m_root].height;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	int nodeId;
+	if (m_freeList == NULL_PROXY)
+	{
+		nodeId = static_cast<int>(m_nodes.size());
+		m_nodes.emplace_back();
+	}
+	else
+	{
+		nodeId = m_freeList;
+		m_freeList = m_nodes[nodeId].parent;
+		m_nodes[nodeId] = TreeNode();
+	}
+	m_nodes[nodeId].height = 0;
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(const int nodeId)
+{
+	m_nodes[nodeId].parent = m_freeList;
+	m_nodes[nodeId].height = -1;
+	m_freeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(const int leaf)
+{
+	if (m_root == NULL_PROXY)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NULL_PROXY;
+		return;
+	}
+
+	//------------------------------------------------------------------------
+	// Find the best sibling for the leaf using the surface area heuristic (perimeter in 2D)
+	const AABB leafAABB = m_nodes[leaf].aabb;
+	int index = m_root;
+	while (!m_nodes[index].IsLeaf())
+	{
+		const TreeNode& node = m_nodes[index];
+		const float combinedPerimeter = AABB::Union(node.aabb, leafAABB).Perimeter();
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.f * combinedPerimeter;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.f * (combinedPerimeter - node.aabb.Perimeter());
+
+		auto descendCost = [&](const int childId)
+			{
+				const TreeNode& child = m_nodes[childId];
+				const float perimeter = AABB::Union(leafAABB, child.aabb).Perimeter();
+				return child.IsLeaf() ? perimeter + inheritanceCost : (perimeter - child.aabb.Perimeter()) + inheritanceCost;
+			};
+		const float cost1 = descendCost(node.child1);
+		const float cost2 = descendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+	const int sibling = index;
+
+	//------------------------------------------------------------------------
+	// Create a new parent for the sibling and the leaf
+	const int oldParent = m_nodes[sibling].parent;
+	const int newParent = AllocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].aabb = AABB::Union(leafAABB, m_nodes[sibling].aabb);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_PROXY)
+	{
+		m_root = newParent;
+	}
+	else if (m_nodes[oldParent].child1 == sibling)
+	{
+		m_nodes[oldParent].child1 = newParent;
+	}
+	else
+	{
+		m_nodes[oldParent].child2 = newParent;
+	}
+
+	RefitAncestors(m_nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(const int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NULL_PROXY;
+		return;
+	}
+
+	const int parent = m_nodes[leaf].parent;
+	const int grandParent = m_nodes[parent].parent;
+	const int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	// The sibling takes the place of the parent
+	m_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NULL_PROXY)
+	{
+		m_root = sibling;
+		return;
+	}
+
+	if (m_nodes[grandParent].child1 == parent)
+	{
+		m_nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		m_nodes[grandParent].child2 = sibling;
+	}
+	RefitAncestors(grandParent);
+}
+
+void DynamicAABBTree::RefitAncestors(int nodeId)
+{
+	while (nodeId != NULL_PROXY)
+	{
+		nodeId = Balance(nodeId);
+
+		TreeNode& node = m_nodes[nodeId];
+		const TreeNode& child1 = m_nodes[node.child1];
+		const TreeNode& child2 = m_nodes[node.child2];
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.aabb = AABB::Union(child1.aabb, child2.aabb);
+
+		nodeId = node.parent;
+	}
+}
+
+int DynamicAABBTree::Balance(const int nodeId)
+{
+	// A is the node, B and C are its children, D and E the children of B, F and G the children of C.
+	// If one child of A is more than one level taller than the other, the taller child is rotated up to take the place of A
+	const int iA = nodeId;
+	TreeNode& a = m_nodes[iA];
+	if (a.IsLeaf() || a.height < 2)
+	{
+		return iA;
+	}
+
+	const int iB = a.child1;
+	const int iC = a.child2;
+	TreeNode& b = m_nodes[iB];
+	TreeNode& c = m_nodes[iC];
+
+	// Point A's old parent (or the root) to the node that replaces A
+	auto replaceChild = [this](const int parent, const int oldChild, const int newChild)
+		{
+			if (parent == NULL_PROXY)
+			{
+				m_root = newChild;
+			}
+			else if (m_nodes[parent].child1 == oldChild)
+			{
+				m_nodes[parent].child1 = newChild;
+			}
+			else
+			{
+				m_nodes[parent].child2 = newChild;
+			}
+		};
+
+	const int balance = c.height - b.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		const int iF = c.child1;
+		const int iG = c.child2;
+		TreeNode& f = m_nodes[iF];
+		TreeNode& g = m_nodes[iG];
+
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+		replaceChild(c.parent, iA, iC);
+
+		// The shorter child of C goes to A
+		if (f.height > g.height)
+		{
+			c.child2 = iF;
+			a.child2 = iG;
+			g.parent = iA;
+			a.aabb = AABB::Union(b.aabb, g.aabb);
+			c.aabb = AABB::Union(a.aabb, f.aabb);
+			a.height = 1 + std::max(b.height, g.height);
+			c.height = 1 + std::max(a.height, f.height);
+		}
+		else
+		{
+			c.child2 = iG;
+			a.child2 = iF;
+			f.parent = iA;
+			a.aabb = AABB::Union(b.aabb, f.aabb);
+			c.aabb = AABB::Union(a.aabb, g.aabb);
+			a.height = 1 + std::max(b.height, f.height);
+			c.height = 1 + std::max(a.height, g.height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		const int iD = b.child1;
+		const int iE = b.child2;
+		TreeNode& d = m_nodes[iD];
+		TreeNode& e = m_nodes[iE];
+
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+		replaceChild(b.parent, iA, iB);
+
+		// The shorter child of B goes to A
+		if (d.height > e.height)
+		{
+			b.child2 = iD;
+			a.child1 = iE;
+			e.parent = iA;
+			a.aabb = AABB::Union(c.aabb, e.aabb);
+			b.aabb = AABB::Union(a.aabb, d.aabb);
+			a.height = 1 + std::max(c.height, e.height);
+			b.height = 1 + std::max(a.height, d.height);
+		}
+		else
+		{
+			b.child2 = iE;
+			a.child1 = iD;
+			d.parent = iA;
+			a.aabb = AABB::Union(c.aabb, d.aabb);
+			b.aabb = AABB::Union(a.aabb, e.aabb);
+			a.height = 1 + std::max(c.height, d.height);
+			b.height = 1 + std::max(a.height, e.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
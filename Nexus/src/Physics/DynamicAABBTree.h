@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+#include "BroadPhase.h"
+#include "Constants.h"
+
+//------------------------------------------------------------------------
+// DynamicAABBTree
+// Broad phase that stores the proxies as leaves of a balanced bounding volume hierarchy (each internal node holds the union of its children).
+// Every leaf stores a "fat" AABB, the collider bounds grown by AABB_MARGIN and stretched along the expected displacement. A moving proxy is only reinserted when its collider leaves its fat AABB, and static proxies (terrain) are never reinserted.
+// FindPairs() only queries the tree for the non-static proxies, so the static colliders never drive any query.
+//------------------------------------------------------------------------
+class DynamicAABBTree final : public IBroadPhase
+{
+public:
+	// Fattening of the leaf AABBs (in pixels)
+	static constexpr float AABB_MARGIN = 0.1f * Physics::PIXEL_PER_METER;
+	// How far ahead (in multiples of the displacement) the fat AABB is stretched for moving proxies
+	static constexpr float DISPLACEMENT_MULTIPLIER = 2.f;
+
+	int CreateProxy(const AABB& aabb, Entity entity, bool isStatic) override;
+	void DestroyProxy(int proxyId) override;
+	void MoveProxy(int proxyId, const AABB& aabb, const Vector2& displacement) override;
+	void FindPairs(std::vector<BroadPhasePair>& outPairs) override;
+	void QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const override;
+	void RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const override;
+
+	[[nodiscard]] size_t GetProxyCount() const override { return m_proxyCount; }
+
+	// Height of the tree (0 for a single leaf), useful to debug the balancing
+	[[nodiscard]] int GetHeight() const;
+	// The fat AABB of a proxy
+	[[nodiscard]] const AABB& GetFatAABB(int proxyId) const { return m_nodes[proxyId].aabb; }
+
+private:
+	struct TreeNode
+	{
+		AABB aabb;				// Fat AABB for leaves, union of the children for internal nodes
+		AABB tightAABB;			// Leaves only: the actual collider bounds, used to filter the candidate pairs
+		Entity entity = Entity(0);
+
+		int parent = NULL_PROXY; // Also used as the "next" link of the free list
+		int child1 = NULL_PROXY;
+		int child2 = NULL_PROXY;
+
+		int height = -1;		// 0 for leaves, -1 for free nodes
+		bool isStatic = false;
+
+		[[nodiscard]] bool IsLeaf() const { return child1 == NULL_PROXY; }
+	};
+
+	int AllocateNode();
+	void FreeNode(int nodeId);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+
+	// Perform a left or right rotation if the node is imbalanced. Returns the new root of the subtree
+	int Balance(int nodeId);
+
+	// Fix the AABB and height of the ancestors of nodeId up to the root, balancing on the way
+	void RefitAncestors(int nodeId);
+
+	std::vector<TreeNode> m_nodes;
+	int m_root = NULL_PROXY;
+	int m_freeList = NULL_PROXY;
+	size_t m_proxyCount = 0;
+
+	// Leaves that are not static, FindPairs() only queries for those
+	std::vector<int> m_dynamicLeaves;
+
+	// Traversal stack reused by the queries
+	mutable std::vector<int> m_stack;
+};
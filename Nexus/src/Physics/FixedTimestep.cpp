@@ -0,0 +1,43 @@
+#include "stdafx.h"
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(const float stepTime, const size_t maxStepCount)
+	: m_stepTime(stepTime), m_maxStepCount(std::max<size_t>(maxStepCount, 1))
+{}
+
+size_t FixedTimestep::Advance(const float frameTime)
+{
+	m_frameTime = std::max(frameTime, 0.f);
+	if (!m_isFixed)
+	{
+		m_lastStepCount = 1;
+		return m_lastStepCount;
+	}
+
+	m_accumulator += m_frameTime;
+	const float maxTime = m_stepTime * static_cast<float>(m_maxStepCount);
+	if (m_accumulator > maxTime)
+	{
+		// Keep less than a step in the accumulator, as if the frame was exactly maxStepCount steps long
+		const float keptTime = std::fmod(m_accumulator, m_stepTime);
+		m_droppedTime += m_accumulator - maxTime - keptTime;
+		m_accumulator = maxTime + keptTime;
+	}
+
+	m_lastStepCount = 0;
+	while (m_accumulator >= m_stepTime && m_lastStepCount < m_maxStepCount)
+	{
+		m_accumulator -= m_stepTime;
+		m_lastStepCount++;
+	}
+	return m_lastStepCount;
+}
+
+void FixedTimestep::SetFixed(const bool isFixed)
+{
+	m_isFixed = isFixed;
+	m_accumulator = 0.f;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+//------------------------------------------------------------------------
+// FixedTimestep
+// Accumulator that turns the variable frame times into a whole number of simulation steps of the same length, so the simulation doesn't depend on the frame rate.
+// The time that doesn't fill a step stays in the accumulator for the next frame, GetAlpha() tells how far the render is between the last two steps.
+// Spiral of death guard: at most maxStepCount steps per frame. A longer frame drops the extra time (the game slows down) instead of simulating more and more steps every frame.
+// In variable mode (SetFixed(false)) every frame is exactly one step of the frame time, like before.
+//
+// Usage:
+//		const size_t stepCount = timestep.Advance(frameTime);
+//		for (size_t i = 0; i < stepCount; i++) { Simulate(timestep.GetStepTime()); }
+//		Render(timestep.GetAlpha());
+//------------------------------------------------------------------------
+class FixedTimestep
+{
+public:
+	// Times are in seconds
+	explicit FixedTimestep(float stepTime = 1.f / 60.f, size_t maxStepCount = 5);
+
+	// Add the frame time to the accumulator and return the number of steps to simulate this frame
+	size_t Advance(float frameTime);
+
+	// Length of every step of the frame
+	[[nodiscard]] float GetStepTime() const { return m_isFixed ? m_stepTime : m_frameTime; }
+	// Time left in the accumulator, as a fraction of a step in [0, 1). Always 1 in variable mode
+	[[nodiscard]] float GetAlpha() const { return m_isFixed ? m_accumulator / m_stepTime : 1.f; }
+
+	[[nodiscard]] size_t GetLastStepCount() const { return m_lastStepCount; }
+	// Total time dropped by the spiral of death guard
+	[[nodiscard]] float GetDroppedTime() const { return m_droppedTime; }
+
+	void SetFixed(bool isFixed);
+	[[nodiscard]] bool IsFixed() const { return m_isFixed; }
+
+private:
+	float m_stepTime;
+	size_t m_maxStepCount;
+	bool m_isFixed = true;
+
+	float m_accumulator = 0.f;
+	float m_frameTime = 0.f;
+	size_t m_lastStepCount = 0;
+	float m_droppedTime = 0.f;
+};
@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include "GravityField.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "src/Utils/JobSystem.h"
+
+void GravityField::Clear()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_mass.clear();
+}
+
+size_t GravityField::Add(const Vector2& position, const float mass)
+{
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_mass.push_back(mass);
+	return m_mass.size() - 1;
+}
+
+void GravityField::ComputeForces()
+{
+	if (GetSize() <= m_exactBodyCount)
+	{
+		ComputeForcesExact();
+	}
+	else
+	{
+		ComputeForcesBarnesHut();
+	}
+}
+
+void GravityField::ComputeForcesExact()
+{
+	m_nodes.clear();
+	m_forces.assign(GetSize(), Vector2());
+
+	// Each pair once, equal and opposite forces
+	for (size_t a = 0; a < GetSize(); a++)
+	{
+		for (size_t b = a + 1; b < GetSize(); b++)
+		{
+			const Vector2 force = Attraction(m_positionX[a], m_positionY[a], m_mass[a], m_positionX[b], m_positionY[b], m_mass[b]);
+			m_forces[a] += force;
+			m_forces[b] -= force;
+		}
+	}
+}
+
+void GravityField::ComputeForcesBarnesHut()
+{
+	const size_t bodyCount = GetSize();
+	m_forces.resize(bodyCount);
+	m_nodes.clear();
+	if (bodyCount == 0)
+	{
+		return;
+	}
+
+	// Root cell: the square around all the bodies
+	const auto [minX, maxX] = std::minmax_element(m_positionX.begin(), m_positionX.end());
+	const auto [minY, maxY] = std::minmax_element(m_positionY.begin(), m_positionY.end());
+	// Slightly bigger, so the bodies on the max side are inside the cell
+	const float size = std::max({ *maxX - *minX, *maxY - *minY, 1.0f }) * 1.0001f;
+
+	m_order.resize(bodyCount);
+	for (uint32_t i = 0; i < bodyCount; i++)
+	{
+		m_order[i] = i;
+	}
+	m_nodes.emplace_back();
+	Build(0, 0, static_cast<uint32_t>(bodyCount), *minX, *minY, size, 0);
+
+	// The tree is only read from here, each body writes its own force
+	JobSystem::ParallelFor(bodyCount, 64, [this](const size_t begin, const size_t end)
+	{
+		for (size_t body = begin; body < end; body++)
+		{
+			m_forces[body] = ComputeTreeForce(body);
+		}
+	});
+}
+
+void GravityField::Build(const int nodeIndex, const uint32_t begin, const uint32_t end, const float minX, const float minY, const float size, const int depth)
+{
+	// Total mass and center of mass
+	float mass = 0.0f;
+	float weightedX = 0.0f;
+	float weightedY = 0.0f;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		const uint32_t body = m_order[i];
+		mass += m_mass[body];
+		weightedX += m_positionX[body] * m_mass[body];
+		weightedY += m_positionY[body] * m_mass[body];
+	}
+
+	// No reference kept: the children are appended to m_nodes
+	Node node;
+	node.mass = mass;
+	node.centerX = mass > 0.0f ? weightedX / mass : minX;
+	node.centerY = mass > 0.0f ? weightedY / mass : minY;
+	node.minX = minX;
+	node.minY = minY;
+	node.size = size;
+	node.begin = begin;
+	node.end = end;
+
+	if (end - begin <= LEAF_SIZE || depth == MAX_DEPTH)
+	{
+		m_nodes[nodeIndex] = node;
+		return;
+	}
+
+	// Split the bodies in 4 quadrants: bottom/top, then left/right of each half
+	const float halfSize = size * 0.5f;
+	const float midX = minX + halfSize;
+	const float midY = minY + halfSize;
+	auto isBelow = [this, midY](const uint32_t body) { return m_positionY[body] < midY; };
+	auto isLeft = [this, midX](const uint32_t body) { return m_positionX[body] < midX; };
+	const uint32_t top = static_cast<uint32_t>(std::partition(m_order.begin() + begin, m_order.begin() + end, isBelow) - m_order.begin());
+	const uint32_t bottomRight = static_cast<uint32_t>(std::partition(m_order.begin() + begin, m_order.begin() + top, isLeft) - m_order.begin());
+	const uint32_t topRight = static_cast<uint32_t>(std::partition(m_order.begin() + top, m_order.begin() + end, isLeft) - m_order.begin());
+
+	node.firstChild = static_cast<int>(m_nodes.size());
+	m_nodes[nodeIndex] = node;
+	m_nodes.resize(m_nodes.size() + 4);
+	Build(node.firstChild + 0, begin, bottomRight, minX, minY, halfSize, depth + 1);
+	Build(node.firstChild + 1, bottomRight, top, midX, minY, halfSize, depth + 1);
+	Build(node.firstChild + 2, top, topRight, minX, midY, halfSize, depth + 1);
+	Build(node.firstChild + 3, topRight, end, midX, midY, halfSize, depth + 1);
+}
+
+Vector2 GravityField::ComputeTreeForce(const size_t body) const
+{
+	const float x = m_positionX[body];
+	const float y = m_positionY[body];
+	const float mass = m_mass[body];
+	const float openingAngleSquared = m_openingAngle * m_openingAngle;
+
+	Vector2 force;
+	// Each level pushes at most 4 children in place of its node
+	int stack[MAX_DEPTH * 3 + 4];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if (node.mass <= 0.0f)
+		{
+			continue;
+		}
+
+		if (node.firstChild == NULL_NODE)
+		{
+			for (uint32_t i = node.begin; i < node.end; i++)
+			{
+				const uint32_t other = m_order[i];
+				if (other != body)
+				{
+					force += Attraction(x, y, mass, m_positionX[other], m_positionY[other], m_mass[other]);
+				}
+			}
+			continue;
+		}
+
+		// Far enough (and not the cell of the body): the whole cell attracts from its center of mass
+		const float dx = node.centerX - x;
+		const float dy = node.centerY - y;
+		const bool isInside = x >= node.minX && x < node.minX + node.size && y >= node.minY && y < node.minY + node.size;
+		if (!isInside && node.size * node.size < openingAngleSquared * (dx * dx + dy * dy))
+		{
+			force += Attraction(x, y, mass, node.centerX, node.centerY, node.mass);
+			continue;
+		}
+
+		for (int child = 0; child < 4; child++)
+		{
+			stack[stackSize++] = node.firstChild + child;
+		}
+	}
+	return force;
+}
+
+Vector2 GravityField::Attraction(const float x, const float y, const float mass, const float otherX, const float otherY, const float otherMass) const
+{
+	const float dx = otherX - x;
+	const float dy = otherY - y;
+	const float distanceSquared = dx * dx + dy * dy;
+	if (distanceSquared <= 0.0f)
+	{
+		return {};
+	}
+
+	// Same as PhysicsEngine::GenerateGravitationalForce()
+	const float clampedDistanceSquared = std::clamp(distanceSquared, m_minDistanceSquared, m_maxDistanceSquared);
+	const float magnitude = m_strength * mass * otherMass / clampedDistanceSquared;
+	const float inverseDistance = 1.0f / std::sqrt(distanceSquared);
+	return Vector2(dx * inverseDistance * magnitude, dy * inverseDistance * magnitude);
+}
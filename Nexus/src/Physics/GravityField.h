@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "src/Utils/Vector2.h"
+
+//------------------------------------------------------------------------
+// GravityField
+// N-body gravity: every body added attracts all the others, with the same force as PhysicsEngine::GenerateGravitationalForce() (strength * ma * mb / distance², distance² clamped).
+// Up to GetExactBodyCount() bodies every pair is computed (O(n²)). Above it the bodies are put in a quadtree and the far away cells act as one body at their center of mass (Barnes-Hut, O(n log n)).
+// The opening angle sets the tradeoff: a cell of size s at distance d is used as a whole when s / d < angle. 0 opens every cell (exact), 0.5 is accurate to about 1%, 1 is fast but rough.
+// The forces of the bodies are computed in parallel on the JobSystem.
+//
+// Usage:
+//		field.Clear();
+//		for (...) field.Add(position, mass);
+//		field.ComputeForces();
+//		for (...) rigidBody.AddForce(field.GetForce(index));
+//------------------------------------------------------------------------
+class GravityField
+{
+public:
+	static constexpr size_t DEFAULT_EXACT_BODY_COUNT = 64;
+
+	void Clear();
+	// Returns the index of the body, in Add() order
+	size_t Add(const Vector2& position, float mass);
+	[[nodiscard]] size_t GetSize() const { return m_mass.size(); }
+
+	// Force on every body from all the others, using the exact sum or the quadtree depending on the body count
+	void ComputeForces();
+	void ComputeForcesExact();
+	void ComputeForcesBarnesHut();
+	// Result of the last ComputeForces()
+	[[nodiscard]] const Vector2& GetForce(const size_t index) const { return m_forces[index]; }
+
+	void SetOpeningAngle(const float angle) { m_openingAngle = angle; }
+	[[nodiscard]] float GetOpeningAngle() const { return m_openingAngle; }
+	// Building the quadtree isn't worth it for a few bodies
+	void SetExactBodyCount(const size_t count) { m_exactBodyCount = count; }
+	[[nodiscard]] size_t GetExactBodyCount() const { return m_exactBodyCount; }
+	// Gravitational constant of the world
+	void SetStrength(const float strength) { m_strength = strength; }
+	// The distance² between two bodies is clamped to this range, the minimum keeps close bodies from getting huge forces
+	void SetDistanceSquaredRange(const float minDistanceSquared, const float maxDistanceSquared) { m_minDistanceSquared = minDistanceSquared; m_maxDistanceSquared = maxDistanceSquared; }
+
+	// Number of nodes of the last quadtree (0 when the exact sum was used)
+	[[nodiscard]] size_t GetNodeCount() const { return m_nodes.size(); }
+
+private:
+	// Bodies per leaf: they are summed one by one, splitting further costs more than it saves
+	static constexpr uint32_t LEAF_SIZE = 8;
+	// Deeper cells only happen for bodies (almost) at the same position, they stay together in one leaf
+	static constexpr int MAX_DEPTH = 24;
+
+	struct Node
+	{
+		// Center of mass and total mass of the bodies in the cell
+		float centerX = 0.0f;
+		float centerY = 0.0f;
+		float mass = 0.0f;
+		// Square cell
+		float minX = 0.0f;
+		float minY = 0.0f;
+		float size = 0.0f;
+		// The 4 children are stored next to each other. NULL_NODE for a leaf
+		int firstChild = NULL_NODE;
+		// Bodies of the cell: m_order[begin, end)
+		uint32_t begin = 0;
+		uint32_t end = 0;
+	};
+	static constexpr int NULL_NODE = -1;
+
+	void Build(int nodeIndex, uint32_t begin, uint32_t end, float minX, float minY, float size, int depth);
+	[[nodiscard]] Vector2 ComputeTreeForce(size_t body) const;
+	// Attraction of a point mass (other) on the body
+	[[nodiscard]] Vector2 Attraction(float x, float y, float mass, float otherX, float otherY, float otherMass) const;
+
+	// Bodies, structure of arrays
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_mass;
+	std::vector<Vector2> m_forces;
+
+	// Quadtree, kept between the steps to reuse the memory
+	std::vector<Node> m_nodes;
+	// Body indices, grouped by cell
+	std::vector<uint32_t> m_order;
+
+	float m_openingAngle = 0.5f;
+	size_t m_exactBodyCount = DEFAULT_EXACT_BODY_COUNT;
+	float m_strength = 10000.0f;
+	float m_minDistanceSquared = 50.0f;
+	float m_maxDistanceSquared = std::numeric_limits<float>::max();
+};
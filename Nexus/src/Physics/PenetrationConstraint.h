@@ -2,7 +2,7 @@
 
 #include "src/ECS/Entity.h"
 #include "src/Physics/PhysicsEngine.h"
-#include "src/Utils/Matrix.h"
+#include "src/Utils/Vec.h"
 #include "src/Utils/Vector2.h"
 
 /**
@@ -13,6 +13,7 @@
  * @param aCollisionPoint (Vector2) The location of the collision point in world space.
  * @param bCollisionPoint (Vector2) The location of the collision point in world space.
  * @param collisionNormal (Vector2) The collision normal vector in world space.
+ * @param featureId (uint32_t) Contact::featureId, used with the entities to find the same contact in the next frame.
 */
 class PenetrationConstraint
 {
@@ -22,10 +23,25 @@ public:
 	Vector2 aCollisionPoint;	// The location of the collision point w.r.t to A's local space.
 	Vector2 bCollisionPoint;	// The location of the collision point w.r.t to B's local space.
 	Vector2 collisionNormal;	// The collision normal vector w.r.t to A's local space.
+	uint32_t featureId;			// Same contact in consecutive frames = same a, b and featureId
 
-	// Values populated by ConstraintSystem
-	Matrix jacobian;			// Calculated by ConstraintSystem::PreSolve()
-	VectorN cachedLambda;		// Calculated by ConstraintSystem::Solve()
+	// Values populated by ConstraintSystem::PreSolvePenetration(), once per step
+	// Jacobian row 0 (normal) = [-normal, -(rA x normal), normal, rB x normal], row 1 (tangent, friction) is the same with the tangent
+	Vector2 normal;				// World space
+	Vector2 tangent;			// World space, zero without friction
+	float rACrossNormal = 0.0f;
+	float rBCrossNormal = 0.0f;
+	float rACrossTangent = 0.0f;
+	float rBCrossTangent = 0.0f;
+	// The 2x2 block K = J M^-1 JT: the effective masses are the inverse of its diagonal, coupling is K[0][1] = K[1][0]
+	float normalMass = 0.0f;
+	float tangentMass = 0.0f;	// 0 without friction
+	float coupling = 0.0f;
+	// Bodies of a and b while the contact is solved, nullptr when PreSolve skipped it
+	RigidBodyComponent* rigidBodyA = nullptr;
+	RigidBodyComponent* rigidBodyB = nullptr;
+
+	Vec<2> cachedLambda;		// Calculated by ConstraintSystem::Solve(). Carried over from the previous frame if the contact persists (warm starting)
 	float bias;					// Baumgarte stabilization factor calculated by ConstraintSystem::PreSolve()
 	float friction;				// Friction coefficient between the two penetrating bodies
 
@@ -37,13 +53,12 @@ public:
 		Entity b,
 		const Vector2& aCollisionPoint,
 		const Vector2& bCollisionPoint,
-		const Vector2& collisionNormal)
-		: a(a), b(b), jacobian(2, 6), cachedLambda(2), bias(0.0f), friction(0.0f)
+		const Vector2& collisionNormal,
+		const uint32_t featureId = 0)
+		: a(a), b(b), featureId(featureId), bias(0.0f), friction(0.0f)
 	{
 		this->aCollisionPoint = PhysicsEngine::WorldSpaceToLocalSpace(a.GetComponent<TransformComponent>(), aCollisionPoint);
 		this->bCollisionPoint = PhysicsEngine::WorldSpaceToLocalSpace(b.GetComponent<TransformComponent>(), bCollisionPoint);
 		this->collisionNormal = PhysicsEngine::WorldSpaceToLocalSpace(a.GetComponent<TransformComponent>(), collisionNormal);
-		jacobian.Zero();
-		cachedLambda.Zero();
 	}
 };
@@ -2,6 +2,8 @@
 #include "PhysicsEngine.h"
 
 #include <algorithm>
+#include <cmath>
+#include <initializer_list>
 #include <iostream>
 
 #include "src/ECS/Entity.h"
@@ -13,11 +15,20 @@
 #include "src/Components/BoxColliderComponent.h"
 #include "src/Components/CircleColliderComponent.h"
 #include "src/Components/PolygonColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
+
+#include "src/Physics/AABB.h"
+#include "src/Physics/BroadPhase.h"
+#include "src/Physics/PolygonSpan.h"
 
 #include "src/Utils/Vector2.h"
 #include "src/Utils/Logger.h"
-#include "src/Utils/Matrix.h"
-#include "src/Utils/VectorN.h"
+
+// SSE2 is always there on x64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NEXUS_SSE2
+#endif
 
 float PhysicsEngine::CalculateMomentOfInertia(const Entity& entity)
 {
@@ -71,6 +82,10 @@ float PhysicsEngine::CalculateMomentOfInertia(const Entity& entity)
 				}
 				return accumulatedInertia / (6.0f * accumulatedArea);
 			}
+			break;
+		case ColliderType::Chain:
+			// Chains are only used by static bodies, they never rotate
+			return 0.0f;
 	}
 	Logger::Err("Couldn't calculate the Moment Of Inertia!");
 	return 0.0f;
@@ -126,6 +141,161 @@ void PhysicsEngine::IntegrateVelocities(const RigidBodyComponent& rigidBodyCompo
 	transformComponent.rotation += rigidBodyComponent.angularVelocity * dt;
 }
 
+void PhysicsEngine::IntegrateKinematic(RigidBodyComponent& rigidBodyComponent, TransformComponent& transformComponent, float dt)
+{
+	rigidBodyComponent.velocity += rigidBodyComponent.acceleration * dt;
+	transformComponent.position += rigidBodyComponent.velocity * dt;
+	rigidBodyComponent.angularVelocity += rigidBodyComponent.angularAcceleration * dt;
+	transformComponent.rotation += rigidBodyComponent.angularVelocity * dt;
+}
+
+void PhysicsEngine::IntegrateForces(RigidBodyComponent* rigidBodies, const size_t count, const float dt)
+{
+	size_t i = 0;
+
+#if defined(NEXUS_SSE2)
+	// The Vector2 terms are {x, y} pairs, two bodies per register. The float terms are gathered, one body per lane
+	const __m128 dt4 = _mm_set1_ps(dt);
+	for (; i + 4 <= count; i += 4)
+	{
+		RigidBodyComponent* bodies = rigidBodies + i;
+		if (!(bodies[0].isAwake && bodies[1].isAwake && bodies[2].isAwake && bodies[3].isAwake)
+			|| bodies[0].IsStatic() || bodies[1].IsStatic() || bodies[2].IsStatic() || bodies[3].IsStatic())
+		{
+			// A group with a sleeping or static body goes one body at a time
+			for (size_t j = 0; j < 4; j++)
+			{
+				if (bodies[j].isAwake)
+				{
+					IntegrateForces(bodies[j], dt);
+				}
+			}
+			continue;
+		}
+
+		for (size_t pair = 0; pair < 4; pair += 2)
+		{
+			RigidBodyComponent& first = bodies[pair];
+			RigidBodyComponent& second = bodies[pair + 1];
+			const __m128 sumForces = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&first.sumForces)), reinterpret_cast<const __m64*>(&second.sumForces));
+			const __m128 velocity = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&first.velocity)), reinterpret_cast<const __m64*>(&second.velocity));
+			const __m128 inverseOfMass = _mm_set_ps(second.inverseOfMass, second.inverseOfMass, first.inverseOfMass, first.inverseOfMass);
+
+			const __m128 acceleration = _mm_mul_ps(sumForces, inverseOfMass);
+			const __m128 newVelocity = _mm_add_ps(velocity, _mm_mul_ps(acceleration, dt4));
+			_mm_storel_pi(reinterpret_cast<__m64*>(&first.acceleration), acceleration);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(&second.acceleration), acceleration);
+			_mm_storel_pi(reinterpret_cast<__m64*>(&first.velocity), newVelocity);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(&second.velocity), newVelocity);
+		}
+
+		const __m128 sumTorque = _mm_set_ps(bodies[3].sumTorque, bodies[2].sumTorque, bodies[1].sumTorque, bodies[0].sumTorque);
+		const __m128 inverseOfAngularMass = _mm_set_ps(bodies[3].inverseOfAngularMass, bodies[2].inverseOfAngularMass, bodies[1].inverseOfAngularMass, bodies[0].inverseOfAngularMass);
+		const __m128 angularAcceleration = _mm_add_ps(
+			_mm_set_ps(bodies[3].angularAcceleration, bodies[2].angularAcceleration, bodies[1].angularAcceleration, bodies[0].angularAcceleration),
+			_mm_mul_ps(sumTorque, inverseOfAngularMass));
+		const __m128 angularVelocity = _mm_add_ps(
+			_mm_set_ps(bodies[3].angularVelocity, bodies[2].angularVelocity, bodies[1].angularVelocity, bodies[0].angularVelocity),
+			_mm_mul_ps(angularAcceleration, dt4));
+
+		float angularAccelerations[4];
+		float angularVelocities[4];
+		_mm_storeu_ps(angularAccelerations, angularAcceleration);
+		_mm_storeu_ps(angularVelocities, angularVelocity);
+		for (size_t j = 0; j < 4; j++)
+		{
+			bodies[j].angularAcceleration = angularAccelerations[j];
+			bodies[j].angularVelocity = angularVelocities[j];
+			ClearForces(bodies[j]);
+			ClearTorque(bodies[j]);
+		}
+	}
+#endif
+
+	// Remaining bodies (all of them without SSE2)
+	for (; i < count; i++)
+	{
+		if (rigidBodies[i].isAwake)
+		{
+			IntegrateForces(rigidBodies[i], dt);
+		}
+	}
+}
+
+void PhysicsEngine::IntegrateVelocities(RigidBodyComponent* rigidBodies, TransformComponent* transforms, const size_t count, const float dt)
+{
+	size_t i = 0;
+
+#if defined(NEXUS_SSE2)
+	const __m128 dt4 = _mm_set1_ps(dt);
+	for (; i + 4 <= count; i += 4)
+	{
+		RigidBodyComponent* bodies = rigidBodies + i;
+		TransformComponent* bodyTransforms = transforms + i;
+		if (!(bodies[0].isAwake && bodies[1].isAwake && bodies[2].isAwake && bodies[3].isAwake)
+			|| bodies[0].isKinematic || bodies[1].isKinematic || bodies[2].isKinematic || bodies[3].isKinematic
+			|| bodies[0].IsStatic() || bodies[1].IsStatic() || bodies[2].IsStatic() || bodies[3].IsStatic())
+		{
+			// A group with a sleeping, kinematic or static body goes one body at a time
+			for (size_t j = 0; j < 4; j++)
+			{
+				if (!bodies[j].isAwake)
+				{
+					continue;
+				}
+				if (bodies[j].isKinematic)
+				{
+					IntegrateKinematic(bodies[j], bodyTransforms[j], dt);
+				}
+				else
+				{
+					IntegrateVelocities(bodies[j], bodyTransforms[j], dt);
+				}
+			}
+			continue;
+		}
+
+		for (size_t pair = 0; pair < 4; pair += 2)
+		{
+			TransformComponent& first = bodyTransforms[pair];
+			TransformComponent& second = bodyTransforms[pair + 1];
+			const __m128 position = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&first.position)), reinterpret_cast<const __m64*>(&second.position));
+			const __m128 velocity = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&bodies[pair].velocity)), reinterpret_cast<const __m64*>(&bodies[pair + 1].velocity));
+			const __m128 newPosition = _mm_add_ps(position, _mm_mul_ps(velocity, dt4));
+			_mm_storel_pi(reinterpret_cast<__m64*>(&first.position), newPosition);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(&second.position), newPosition);
+		}
+
+		const __m128 rotation = _mm_add_ps(
+			_mm_set_ps(bodyTransforms[3].rotation, bodyTransforms[2].rotation, bodyTransforms[1].rotation, bodyTransforms[0].rotation),
+			_mm_mul_ps(_mm_set_ps(bodies[3].angularVelocity, bodies[2].angularVelocity, bodies[1].angularVelocity, bodies[0].angularVelocity), dt4));
+		float rotations[4];
+		_mm_storeu_ps(rotations, rotation);
+		for (size_t j = 0; j < 4; j++)
+		{
+			bodyTransforms[j].rotation = rotations[j];
+		}
+	}
+#endif
+
+	// Remaining bodies (all of them without SSE2)
+	for (; i < count; i++)
+	{
+		if (!rigidBodies[i].isAwake)
+		{
+			continue;
+		}
+		if (rigidBodies[i].isKinematic)
+		{
+			IntegrateKinematic(rigidBodies[i], transforms[i], dt);
+		}
+		else
+		{
+			IntegrateVelocities(rigidBodies[i], transforms[i], dt);
+		}
+	}
+}
+
 void PhysicsEngine::UpdateColliderProperties(const Entity& entity, TransformComponent& transform)
 {
 	if (entity.HasComponent<BoxColliderComponent>())
@@ -140,6 +310,24 @@ void PhysicsEngine::UpdateColliderProperties(const Entity& entity, TransformComp
 	{
 		UpdateCircleColliderCenter(entity.GetComponent<CircleColliderComponent>(), transform);
 	}
+	else if (entity.HasComponent<ChainColliderComponent>())
+	{
+		UpdateChainColliderVertices(entity.GetComponent<ChainColliderComponent>(), transform);
+	}
+}
+
+void PhysicsEngine::UpdateColliderProperties(const Entity& entity, TransformComponent& transform, IBroadPhase& broadPhase, const Vector2& displacement)
+{
+	UpdateColliderProperties(entity, transform);
+
+	if (entity.HasComponent<ColliderTypeComponent>())
+	{
+		// The broad phase decides if the proxy has to be reinserted (static proxies and small movements are ignored)
+		if (const int proxyId = entity.GetComponent<ColliderTypeComponent>().proxyId; proxyId != IBroadPhase::NULL_PROXY)
+		{
+			broadPhase.MoveProxy(proxyId, GetColliderAABB(entity), displacement);
+		}
+	}
 }
 
 void PhysicsEngine::UpdateCircleColliderCenter(CircleColliderComponent& circleCollider, const TransformComponent& transform)
@@ -156,7 +344,7 @@ void PhysicsEngine::UpdateBoxColliderVertices(BoxColliderComponent& collider, co
 	const float cosAngle = std::cos(transform.rotation);
 	const float sinAngle = std::sin(transform.rotation);
 
-	// Rotate and translate each vertex
+	// Rotate and translate each vertex, the edge normals are only rotated
 	for (size_t i = 0; i < collider.localVertices.size(); ++i)
 	{
 		const Vector2& localVertex = collider.localVertices[i];
@@ -164,6 +352,12 @@ void PhysicsEngine::UpdateBoxColliderVertices(BoxColliderComponent& collider, co
 			localVertex.x * cosAngle - localVertex.y * sinAngle,
 			localVertex.x * sinAngle + localVertex.y * cosAngle
 		) + globalOffset;
+
+		const Vector2& localNormal = collider.localNormals[i];
+		collider.globalNormals[i] = Vector2(
+			localNormal.x * cosAngle - localNormal.y * sinAngle,
+			localNormal.x * sinAngle + localNormal.y * cosAngle
+		);
 	}
 }
 
@@ -176,7 +370,7 @@ void PhysicsEngine::UpdatePolygonColliderVertices(PolygonColliderComponent& coll
 	const float cosAngle = std::cos(transform.rotation);
 	const float sinAngle = std::sin(transform.rotation);
 
-	// Rotate and translate each vertex
+	// Rotate and translate each vertex, the edge normals are only rotated
 	for (size_t i = 0; i < collider.localVertices.size(); ++i)
 	{
 		const Vector2& localVertex = collider.localVertices[i];
@@ -184,7 +378,82 @@ void PhysicsEngine::UpdatePolygonColliderVertices(PolygonColliderComponent& coll
 			localVertex.x * cosAngle - localVertex.y * sinAngle,
 			localVertex.x * sinAngle + localVertex.y * cosAngle
 		) + globalOffset;
+
+		const Vector2& localNormal = collider.localNormals[i];
+		collider.globalNormals[i] = Vector2(
+			localNormal.x * cosAngle - localNormal.y * sinAngle,
+			localNormal.x * sinAngle + localNormal.y * cosAngle
+		);
+	}
+}
+
+void PhysicsEngine::UpdateChainColliderVertices(ChainColliderComponent& collider, const TransformComponent& transform)
+{
+	for (size_t i = 0; i < collider.localVertices.size(); ++i)
+	{
+		collider.globalVertices[i] = collider.localVertices[i] + transform.position;
+	}
+}
+
+PolygonSpan PhysicsEngine::GetPolygonSpan(const Entity& entity)
+{
+	if (entity.HasComponent<BoxColliderComponent>())
+	{
+		const auto& collider = entity.GetComponent<BoxColliderComponent>();
+		return PolygonSpan(collider.globalVertices, collider.globalNormals);
+	}
+	if (entity.HasComponent<PolygonColliderComponent>())
+	{
+		const auto& collider = entity.GetComponent<PolygonColliderComponent>();
+		return PolygonSpan(collider.globalVertices, collider.globalNormals);
+	}
+	return PolygonSpan();
+}
+
+AABB PhysicsEngine::GetColliderAABB(const Entity& entity)
+{
+	const std::vector<Vector2>* vertices = nullptr;
+	if (entity.HasComponent<BoxColliderComponent>())
+	{
+		vertices = &entity.GetComponent<BoxColliderComponent>().globalVertices;
+	}
+	else if (entity.HasComponent<PolygonColliderComponent>())
+	{
+		vertices = &entity.GetComponent<PolygonColliderComponent>().globalVertices;
+	}
+	else if (entity.HasComponent<CircleColliderComponent>())
+	{
+		const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+		const Vector2 extents(circleCollider.radius, circleCollider.radius);
+		return { circleCollider.globalCenter - extents, circleCollider.globalCenter + extents };
+	}
+	else if (entity.HasComponent<ChainColliderComponent>())
+	{
+		vertices = &entity.GetComponent<ChainColliderComponent>().globalVertices;
 	}
+
+	if (!vertices || vertices->empty())
+	{
+		// No collider shape, use the entity position as a point
+		const Vector2& position = entity.GetComponent<TransformComponent>().position;
+		return { position, position };
+	}
+
+	AABB aabb((*vertices)[0], (*vertices)[0]);
+	for (const auto& vertex : *vertices)
+	{
+		aabb.min.x = std::min(aabb.min.x, vertex.x);
+		aabb.min.y = std::min(aabb.min.y, vertex.y);
+		aabb.max.x = std::max(aabb.max.x, vertex.x);
+		aabb.max.y = std::max(aabb.max.y, vertex.y);
+	}
+
+	// The bodies below the chain are still pushed up
+	if (entity.HasComponent<ChainColliderComponent>())
+	{
+		aabb.min.y -= entity.GetComponent<ChainColliderComponent>().depth;
+	}
+	return aabb;
 }
 
 void PhysicsEngine::AddForce(RigidBodyComponent& rigidBodyComponent, const Vector2& force)
@@ -324,7 +593,7 @@ bool PhysicsEngine::IsAABBCollision(const double aX, const double aY, const doub
 	return 	isOverlappingX && isOverlappingY;
 }
 
-bool PhysicsEngine::IsSATCollision(const std::vector<Vector2>& verticesA, const std::vector<Vector2>& verticesB, std::vector<Contact>& outContactPoints)
+bool PhysicsEngine::IsSATCollision(const PolygonSpan& verticesA, const PolygonSpan& verticesB, std::vector<Contact>& outContactPoints)
 {
 	// Check if there is a Separating Axis Theorem (SAT) collision between two polygons.
 	// If there exists an axis along which the projections of the polygons are separated, there is no collision.
@@ -348,51 +617,63 @@ bool PhysicsEngine::IsSATCollision(const std::vector<Vector2>& verticesA, const
 
 	// if abSeparation > baSeparation then Polygon A is the reference shape, and Polygon B is the incident shape
 	// else, Polygon B is the reference shape, and Polygon A is the incident shape
-	const std::vector<Vector2>& referenceShape = (abSeparation > baSeparation) ? verticesA : verticesB;
-	const std::vector<Vector2>& incidentShape = (abSeparation > baSeparation) ? verticesB : verticesA;
+	const PolygonSpan& referenceShape = (abSeparation > baSeparation) ? verticesA : verticesB;
+	const PolygonSpan& incidentShape = (abSeparation > baSeparation) ? verticesB : verticesA;
 	const size_t referenceEdgeIdx = (abSeparation > baSeparation) ? referenceEdgeIdxA : referenceEdgeIdxB;
 
-	// Find the reference edge of the reference shape
-	const Vector2 referenceEdge = referenceShape[(referenceEdgeIdx + 1) % referenceShape.size()] - referenceShape[referenceEdgeIdx];
+	// Normal of the reference edge of the reference shape
+	const Vector2 referenceNormal = referenceShape.normals[referenceEdgeIdx];
 
 	//------------------------------------------------------------------------
 	// Clipping
 
 	// Find the incident edge(vertex) on the incident shape that is most perpendicular to the reference edge
-	const size_t incidentEdgeIndex = FindIncidentEdge(incidentShape, referenceEdge.Normal());
-	const size_t incidentNextIndex = (incidentEdgeIndex + 1) % incidentShape.size();
+	const size_t incidentEdgeIndex = FindIncidentEdge(incidentShape, referenceNormal);
 
-	const Vector2 vertex0 = incidentShape[incidentEdgeIndex];
-	const Vector2 vertex1 = incidentShape[incidentNextIndex];
+	const Vector2 vertex0 = incidentShape.Vertex(incidentEdgeIndex);
+	const Vector2 vertex1 = incidentShape.Vertex(incidentEdgeIndex + 1);
 
 	// Perform edge clipping to calculate contact points
 	std::vector<Vector2> contactPoints = { vertex0, vertex1 };
 	std::vector<Vector2> clippedPoints = { vertex0, vertex1 }; // Holds points after clipping
-	for (size_t i = 0; i < referenceShape.size(); i++) // To find the two clipping planes
+	for (size_t i = 0; i < referenceShape.count; i++) // To find the two clipping planes
 	{
 		if (i == referenceEdgeIdx) continue;
 		// Vertex of the reference shape which comprises the clipping plane
-		Vector2 clipVertexStart = referenceShape[i];
-		Vector2 clipVertexEnd = referenceShape[(i + 1) % referenceShape.size()];
+		Vector2 clipVertexStart = referenceShape.Vertex(i);
+		Vector2 clipVertexEnd = referenceShape.Vertex(i + 1);
 
 		// Clip the segment and update the contact points
 		if (ClipSegmentToLine(contactPoints, clippedPoints, clipVertexStart, clipVertexEnd) < 2) break;
 		contactPoints = clippedPoints;
 	}
 
-	const auto referenceVertex = referenceShape[referenceEdgeIdx];
+	const auto referenceVertex = referenceShape.vertices[referenceEdgeIdx];
+
+	// The clipping can reorder the points, so they are told apart by their position along the incident edge instead of their index
+	const Vector2 incidentEdge = vertex1 - vertex0;
+	const float clipPosition0 = (clippedPoints[0] - vertex0).Dot(incidentEdge);
+	const float clipPosition1 = (clippedPoints[1] - vertex0).Dot(incidentEdge);
 
 	// Process the clipped points and calculate contact points for collision
-	for (auto& clipVertex : clippedPoints)
+	for (size_t i = 0; i < clippedPoints.size(); i++)
 	{
-		const float separation = (clipVertex - referenceVertex).Dot(referenceEdge.Normal()); // negative separation means the objects are penetrating each other
+		const Vector2& clipVertex = clippedPoints[i];
+		const float separation = (clipVertex - referenceVertex).Dot(referenceNormal); // negative separation means the objects are penetrating each other
 		if (separation <= 0) // Include only points with penetration
 		{
 			Contact contact;
-			contact.collisionNormal = referenceEdge.Normal();
+			contact.collisionNormal = referenceNormal;
 			contact.startContactPoint = clipVertex;
 			contact.endContactPoint = clipVertex + contact.collisionNormal * -separation;
 
+			// Feature id = reference edge | incident edge | end of the incident edge | which polygon is the reference
+			const bool isFirstAlongIncidentEdge = (i == 0) ? clipPosition0 <= clipPosition1 : clipPosition1 < clipPosition0;
+			contact.featureId = (static_cast<uint32_t>(referenceEdgeIdx & 0xFFFF) << 16) |
+				(static_cast<uint32_t>(incidentEdgeIndex & 0x7FFF) << 2) |
+				(isFirstAlongIncidentEdge ? 0u : 2u) |
+				(abSeparation > baSeparation ? 0u : 1u);
+
 			// Ensure the contact normal and points are consistently directed from 'A' to 'B'
 			if (baSeparation >= abSeparation)
 			{
@@ -407,6 +688,111 @@ bool PhysicsEngine::IsSATCollision(const std::vector<Vector2>& verticesA, const
 	return true; // No separating axis found, collision occurs
 }
 
+bool PhysicsEngine::SweepCirclePolygon(const Vector2& center, const float radius, const Vector2& displacement, const PolygonSpan& polygon, float& outTimeOfImpact, Vector2& outNormal)
+{
+	outTimeOfImpact = 1.0f;
+	bool isHit = false;
+	for (size_t i = 0; i < polygon.count; i++)
+	{
+		// The circle can only hit the edges facing the movement
+		if (displacement.Dot(polygon.normals[i]) >= 0.0f)
+		{
+			continue;
+		}
+		isHit |= SweepCircleEdge(center, radius, displacement, polygon.vertices[i], polygon.Vertex(i + 1), polygon.normals[i], outTimeOfImpact, outNormal);
+	}
+	return isHit;
+}
+
+bool PhysicsEngine::SweepCircleSegment(const Vector2& center, const float radius, const Vector2& displacement, const Vector2& segmentStart, const Vector2& segmentEnd, float& outTimeOfImpact, Vector2& outNormal)
+{
+	// The side of the segment facing the circle
+	Vector2 normal = (segmentEnd - segmentStart).Normal();
+	if ((center - segmentStart).Dot(normal) < 0.0f)
+	{
+		normal = -normal;
+	}
+
+	outTimeOfImpact = 1.0f;
+	return SweepCircleEdge(center, radius, displacement, segmentStart, segmentEnd, normal, outTimeOfImpact, outNormal);
+}
+
+bool PhysicsEngine::SweepCircleChain(const Vector2& center, const float radius, const Vector2& displacement, const ChainColliderComponent& chain, float& outTimeOfImpact, Vector2& outNormal)
+{
+	const float endX = center.x + displacement.x;
+	size_t begin;
+	size_t end;
+	chain.FindSegments(std::min(center.x, endX) - radius, std::max(center.x, endX) + radius, begin, end);
+
+	outTimeOfImpact = 1.0f;
+	bool isHit = false;
+	for (size_t i = begin; i < end; i++)
+	{
+		// One sided: the circle can only hit the segments from above
+		if (displacement.Dot(chain.normals[i]) >= 0.0f)
+		{
+			continue;
+		}
+		isHit |= SweepCircleEdge(center, radius, displacement, chain.globalVertices[i], chain.globalVertices[i + 1], chain.normals[i], outTimeOfImpact, outNormal);
+	}
+	return isHit;
+}
+
+bool PhysicsEngine::SweepCircleEdge(const Vector2& center, const float radius, const Vector2& displacement, const Vector2& edgeStart, const Vector2& edgeEnd, const Vector2& edgeNormal, float& inOutTimeOfImpact, Vector2& outNormal)
+{
+	bool isHit = false;
+
+	// Face: the center crosses the edge moved by the radius along its normal
+	const float approachSpeed = displacement.Dot(edgeNormal);
+	const float startDistance = (center - edgeStart).Dot(edgeNormal) - radius;
+	if (approachSpeed < 0.0f && startDistance >= 0.0f)
+	{
+		const float timeOfImpact = -startDistance / approachSpeed;
+		if (timeOfImpact < inOutTimeOfImpact)
+		{
+			// The touching point has to be between the two vertices
+			const Vector2 edge = edgeEnd - edgeStart;
+			const float along = (center + displacement * timeOfImpact - edgeStart).Dot(edge);
+			if (along >= 0.0f && along <= edge.MagnitudeSquared())
+			{
+				inOutTimeOfImpact = timeOfImpact;
+				outNormal = edgeNormal;
+				return true; // The vertices can't be hit before the face
+			}
+		}
+	}
+
+	// Vertices: the center enters the circle of the same radius around the vertex, |center + displacement * t - vertex| = radius
+	const float a = displacement.MagnitudeSquared();
+	if (a <= 0.0f)
+	{
+		return false;
+	}
+	for (const Vector2& vertex : { edgeStart, edgeEnd })
+	{
+		const Vector2 toCenter = center - vertex;
+		const float b = toCenter.Dot(displacement);
+		const float c = toCenter.MagnitudeSquared() - radius * radius;
+		if (c < 0.0f || b >= 0.0f) // Already overlapping or moving away
+		{
+			continue;
+		}
+		const float discriminant = b * b - a * c;
+		if (discriminant < 0.0f)
+		{
+			continue;
+		}
+		const float timeOfImpact = (-b - std::sqrt(discriminant)) / a;
+		if (timeOfImpact < inOutTimeOfImpact)
+		{
+			inOutTimeOfImpact = timeOfImpact;
+			outNormal = (toCenter + displacement * timeOfImpact).UnitVector();
+			isHit = true;
+		}
+	}
+	return isHit;
+}
+
 void PhysicsEngine::ResolvePenetration(const float depth, const Vector2 collisionNormal, const RigidBodyComponent& aRigidbody, const RigidBodyComponent& bRigidbody, TransformComponent& aTransform, TransformComponent& bTransform)
 {
 	if (aRigidbody.IsStatic() && bRigidbody.IsStatic())
@@ -494,82 +880,95 @@ Vector2 PhysicsEngine::WorldSpaceToLocalSpace(const TransformComponent& newLocal
 	return { rotatedX, rotatedY };
 }
 
-Matrix PhysicsEngine::GetInverseMassMatrix(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB)
-{
-	Matrix inverseMass(6, 6);
-	inverseMass.Zero();
-	inverseMass.rowVectors[0][0] = rigidBodyA.inverseOfMass;
-	inverseMass.rowVectors[1][1] = rigidBodyA.inverseOfMass;
-	inverseMass.rowVectors[2][2] = rigidBodyA.inverseOfAngularMass;
-	inverseMass.rowVectors[3][3] = rigidBodyB.inverseOfMass;
-	inverseMass.rowVectors[4][4] = rigidBodyB.inverseOfMass;
-	inverseMass.rowVectors[5][5] = rigidBodyB.inverseOfAngularMass;
-	return inverseMass;
-}
-
-VectorN PhysicsEngine::GetVelocitiesVector(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB)
-{
-	VectorN velocitiesVector(6);
-	velocitiesVector.Zero();
-	velocitiesVector[0] = rigidBodyA.velocity.x;
-	velocitiesVector[1] = rigidBodyA.velocity.y;
-	velocitiesVector[2] = rigidBodyA.angularVelocity;
-	velocitiesVector[3] = rigidBodyB.velocity.x;
-	velocitiesVector[4] = rigidBodyB.velocity.y;
-	velocitiesVector[5] = rigidBodyB.angularVelocity;
-	return velocitiesVector;
-}
-
-float PhysicsEngine::FindMinSeparation(const std::vector<Vector2>& primaryVertices,
-	const std::vector<Vector2>& secondaryVertices, size_t& outIndexReferenceEdge, Vector2& outSupportPoint)
+float PhysicsEngine::FindMinSeparation(const PolygonSpan& primaryShape, const PolygonSpan& secondaryShape, size_t& outIndexReferenceEdge, Vector2& outSupportPoint)
 {
 	float maxSeparation = std::numeric_limits<float>::lowest();
+	size_t edgeIndex = 0;
+
+#if defined(NEXUS_SSE2)
+	// 4 edges of the primary polygon at a time: the vertices and normals are {x, y} pairs, shuffled into one register of x and one of y.
+	// Same operations as the scalar loop ((vertex - edgeStart).Dot(edgeNormal)), so the result is the same
+	const float* primaryVertices = &primaryShape.vertices[0].x;
+	const float* primaryNormals = &primaryShape.normals[0].x;
+	for (; edgeIndex + 4 <= primaryShape.count; edgeIndex += 4)
+	{
+		const __m128 vertices01 = _mm_loadu_ps(primaryVertices + 2 * edgeIndex);
+		const __m128 vertices23 = _mm_loadu_ps(primaryVertices + 2 * edgeIndex + 4);
+		const __m128 normals01 = _mm_loadu_ps(primaryNormals + 2 * edgeIndex);
+		const __m128 normals23 = _mm_loadu_ps(primaryNormals + 2 * edgeIndex + 4);
+		const __m128 startX = _mm_shuffle_ps(vertices01, vertices23, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 startY = _mm_shuffle_ps(vertices01, vertices23, _MM_SHUFFLE(3, 1, 3, 1));
+		const __m128 normalX = _mm_shuffle_ps(normals01, normals23, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 normalY = _mm_shuffle_ps(normals01, normals23, _MM_SHUFFLE(3, 1, 3, 1));
+
+		// Minimum projection of the secondary vertices on each of the 4 normals
+		__m128 minProjection = _mm_set1_ps(std::numeric_limits<float>::max());
+		for (size_t j = 0; j < secondaryShape.count; j++)
+		{
+			const __m128 toVertexX = _mm_sub_ps(_mm_set1_ps(secondaryShape.vertices[j].x), startX);
+			const __m128 toVertexY = _mm_sub_ps(_mm_set1_ps(secondaryShape.vertices[j].y), startY);
+			const __m128 projection = _mm_add_ps(_mm_mul_ps(toVertexX, normalX), _mm_mul_ps(toVertexY, normalY));
+			minProjection = _mm_min_ps(minProjection, projection);
+		}
 
-	const size_t primarySize = primaryVertices.size();
+		float minProjections[4];
+		_mm_storeu_ps(minProjections, minProjection);
+		for (size_t lane = 0; lane < 4; lane++)
+		{
+			if (minProjections[lane] > maxSeparation)
+			{
+				maxSeparation = minProjections[lane];
+				outIndexReferenceEdge = edgeIndex + lane;
+			}
+		}
+	}
+#endif
 
-	// Loop through all edges of the primary polygon.
-	for (size_t i = 0; i < primarySize; i++)
+	// Remaining edges (all of them without SSE2)
+	for (; edgeIndex < primaryShape.count; edgeIndex++)
 	{
-		Vector2 primaryVertexStart = primaryVertices[i];
-		Vector2 primaryVertexEnd = primaryVertices[(i + 1) % primarySize];
-		Vector2 edgeNormal = (primaryVertexEnd - primaryVertexStart).Normal();  // Get perpendicular (normal) to the edge
+		const Vector2 primaryVertexStart = primaryShape.vertices[edgeIndex];
+		const Vector2 edgeNormal = primaryShape.normals[edgeIndex];
 
 		// Find the minimum projection distance for the secondary polygon onto this edge normal.
 		float minProjection = std::numeric_limits<float>::max();
-		Vector2 closestVertex;
-
-		// Loop through all the vertices of the secondary polygon.
-		for (auto secondaryVertex : secondaryVertices)
+		for (size_t j = 0; j < secondaryShape.count; j++)
 		{
-			// Project the secondary vertex onto the current edge's normal.
-			const float projection = (secondaryVertex - primaryVertexStart).Dot(edgeNormal);
-			if (projection < minProjection)
-			{
-				minProjection = projection;
-				closestVertex = secondaryVertex; // Store the vertex causing the minimum projection.
-			}
+			minProjection = std::min(minProjection, (secondaryShape.vertices[j] - primaryVertexStart).Dot(edgeNormal));
 		}
 
 		// Update the maximum separation if this edge normal has the highest separation.
 		if (minProjection > maxSeparation)
 		{
 			maxSeparation = minProjection;
-			outIndexReferenceEdge = i;
-			outSupportPoint = closestVertex;
+			outIndexReferenceEdge = edgeIndex;
+		}
+	}
+
+	// Support point: the secondary vertex causing the minimum projection on the reference edge
+	const Vector2 referenceVertex = primaryShape.vertices[outIndexReferenceEdge];
+	const Vector2 referenceNormal = primaryShape.normals[outIndexReferenceEdge];
+	float minProjection = std::numeric_limits<float>::max();
+	for (size_t j = 0; j < secondaryShape.count; j++)
+	{
+		const float projection = (secondaryShape.vertices[j] - referenceVertex).Dot(referenceNormal);
+		if (projection < minProjection)
+		{
+			minProjection = projection;
+			outSupportPoint = secondaryShape.vertices[j];
 		}
 	}
 	return maxSeparation;
 }
 
-size_t PhysicsEngine::FindIncidentEdge(const std::vector<Vector2>& verticesIncidentShape, const Vector2& outReferenceNormal)
+size_t PhysicsEngine::FindIncidentEdge(const PolygonSpan& incidentShape, const Vector2& referenceNormal)
 {
 	// To track the incident edge with the smallest projection.
 	size_t indexIncidentEdge = 0;
 	float minProjection = std::numeric_limits<float>::max();
-	for (size_t i = 0; i < verticesIncidentShape.size(); ++i)
+	for (size_t i = 0; i < incidentShape.count; ++i)
 	{
-		auto edge = verticesIncidentShape[(i + 1) % verticesIncidentShape.size()] - verticesIncidentShape[i];
-		const auto projection = edge.Normal().Dot(outReferenceNormal);
+		const float projection = incidentShape.normals[i].Dot(referenceNormal);
 		if (projection < minProjection)
 		{
 			minProjection = projection;
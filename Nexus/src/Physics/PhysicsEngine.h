@@ -1,10 +1,12 @@
 #pragma once
 #include <vector>
 
+class IBroadPhase;
+struct AABB;
 struct Contact;
-struct VectorN;
-struct Matrix;
+struct PolygonSpan;
 struct PolygonColliderComponent;
+struct ChainColliderComponent;
 struct BoxColliderComponent;
 struct CircleColliderComponent;
 struct TransformComponent;
@@ -37,6 +39,14 @@ public:
 	// Integrate linear and angular velocities to change the transform's position and rotation. Make sure to update the properties of collider based on the new values of the transform.
 	static void IntegrateVelocities(const RigidBodyComponent& rigidBodyComponent, TransformComponent& transformComponent, float dt);
 
+	// Kinematic bodies keep their acceleration: it changes the velocity, which changes the position
+	static void IntegrateKinematic(RigidBodyComponent& rigidBodyComponent, TransformComponent& transformComponent, float dt);
+
+	// Same as above for count bodies stored next to each other (ex: a chunk of the archetype storage), in place. Sleeping bodies are skipped and the kinematic ones go through IntegrateKinematic().
+	// With SSE2, 4 bodies at a time. Same operations in the same order as the functions above, so the result is the same
+	static void IntegrateForces(RigidBodyComponent* rigidBodies, size_t count, float dt);
+	static void IntegrateVelocities(RigidBodyComponent* rigidBodies, TransformComponent* transforms, size_t count, float dt);
+
 
 	//------------------------------------------------------------------------
 	// Update Collider w.r.t the transform component
@@ -44,12 +54,20 @@ public:
 
 	// Update the properties like globalCenter(circle) and globalVertices(polygon) of the collider w.r.t. the transform component
 	static void UpdateColliderProperties(const Entity& entity, TransformComponent& transform);
+	// Same as above and also move the collider's broad phase proxy. Displacement is the expected movement in the next step (velocity * dt)
+	static void UpdateColliderProperties(const Entity& entity, TransformComponent& transform, IBroadPhase& broadPhase, const Vector2& displacement);
 	// Function to update Circle-Collider's center
 	static void UpdateCircleColliderCenter(CircleColliderComponent& circleCollider, const TransformComponent& transform);
 	// Function to update Box-Collider's Vertices based on transform rotation
 	static void UpdateBoxColliderVertices(BoxColliderComponent& collider, const TransformComponent& transform);
 	// Function to update Polygon-Collider's Vertices based on transform rotation
 	static void UpdatePolygonColliderVertices(PolygonColliderComponent& collider, const TransformComponent& transform);
+	// Function to update Chain-Collider's Vertices, only translated by the transform
+	static void UpdateChainColliderVertices(ChainColliderComponent& collider, const TransformComponent& transform);
+	// Axis-aligned bounding box of the entity's collider (globalCenter/globalVertices), used by the collision broad phase
+	static AABB GetColliderAABB(const Entity& entity);
+	// Global vertices and edge normals of the entity's box or polygon collider, without copying them. Empty for the other colliders
+	static PolygonSpan GetPolygonSpan(const Entity& entity);
 
 
 	//------------------------------------------------------------------------
@@ -101,9 +119,18 @@ public:
 	// Axis-Aligned Bounding Box for Collision Detection. Input is the bottom left point of each rectangle along with width and height. Returns true if the two rectangles are colliding.
 	static bool IsAABBCollision(const double aX, const double aY, const double aW, const double aH, const double bX, const double bY, const double bW, const double bH);
 
-	// Separating Axis Theorem for Collision Detection between two convex polygon. Input are the list of vertices for each polygon. Returns true if the two polygons are colliding.
+	// Separating Axis Theorem for Collision Detection between two convex polygon. Input are the vertices and edge normals of each polygon (see GetPolygonSpan()). Returns true if the two polygons are colliding.
 	// It also update the outContactPoints vector<Contact> by returning a single contact point for circles and more than one contact points for polygons
-	static bool IsSATCollision(const std::vector<Vector2>& verticesA, const std::vector<Vector2>& verticesB, std::vector<Contact>& outContactPoints);
+	static bool IsSATCollision(const PolygonSpan& verticesA, const PolygonSpan& verticesB, std::vector<Contact>& outContactPoints);
+
+	// Continuous collision detection (time of impact) of a circle moving by displacement against a fixed polygon, for the bodies that move more than their size in one step.
+	// Returns true if the circle hits the polygon during the move. outTimeOfImpact is the fraction of displacement (0 - 1) before the first impact and outNormal the surface normal at the impact, pointing towards the circle.
+	// A circle that already overlaps the polygon at the start is not reported, the discrete collision detection handles it
+	static bool SweepCirclePolygon(const Vector2& center, const float radius, const Vector2& displacement, const PolygonSpan& polygon, float& outTimeOfImpact, Vector2& outNormal);
+	// Same against a two sided segment (e.g. a terrain edge)
+	static bool SweepCircleSegment(const Vector2& center, const float radius, const Vector2& displacement, const Vector2& segmentStart, const Vector2& segmentEnd, float& outTimeOfImpact, Vector2& outNormal);
+	// Same against the top side of a chain (terrain). Only the segments under the move are tested
+	static bool SweepCircleChain(const Vector2& center, const float radius, const Vector2& displacement, const ChainColliderComponent& chain, float& outTimeOfImpact, Vector2& outNormal);
 
 
 	//------------------------------------------------------------------------
@@ -130,57 +157,29 @@ public:
 	// Convert World position and rotation to local position and rotation
 	static Vector2 WorldSpaceToLocalSpace(const TransformComponent& newLocalOrigin, const Vector2 pointToConvert);
 
-
-	//------------------------------------------------------------------------
-	// Constraint Resolution
-	//------------------------------------------------------------------------
-
-	//---------------------------------------------
-	// Matrix6x6 with the all inverse mass and inverse I (angular Mass) of bodies "a" and "b"
-	//---------------------------------------------
-	//  [ 1/ma  0     0     0     0     0    ]
-	//  [ 0     1/ma  0     0     0     0    ]
-	//  [ 0     0     1/Ia  0     0     0    ]
-	//  [ 0     0     0     1/mb  0     0    ]
-	//  [ 0     0     0     0     1/mb  0    ]
-	//  [ 0     0     0     0     0     1/Ib ]
-	//---------------------------------------------
-	static Matrix GetInverseMassMatrix(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB);
-
-	//---------------------------------------------
-	// VecN with the all linear and angular velocities of bodies "a" and "b"
-	//---------------------------------------------
-	//  [ va.x ]
-	//  [ va.y ]
-	//  [ ωa   ]
-	//  [ vb.x ]
-	//  [ vb.y ]
-	//  [ ωb   ]
-	//---------------------------------------------
-	static VectorN GetVelocitiesVector(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB);
-
 	/**
 	* @brief Finds the maximum separation between two polygons.
 	* Determines the edge of the primary polygon with the largest separation
 	* from the secondary polygon along its normal.
-	* @param primaryVertices Vertices of the primary polygon.
-	* @param secondaryVertices Vertices of the secondary polygon.
+	* The edges are tested 4 at a time with SSE2 when it is available.
+	* @param primaryShape Vertices and edge normals of the primary polygon.
+	* @param secondaryShape Vertices of the secondary polygon.
 	* @param[out] outIndexReferenceEdge Index of the edge with the largest separation.
 	* @param[out] outSupportPoint Closest vertex of the secondary polygon.
 	* @return Maximum separation value.
 	*/
-	static float FindMinSeparation(const std::vector<Vector2>& primaryVertices, const std::vector<Vector2>& secondaryVertices, size_t& outIndexReferenceEdge, Vector2& outSupportPoint);
+	static float FindMinSeparation(const PolygonSpan& primaryShape, const PolygonSpan& secondaryShape, size_t& outIndexReferenceEdge, Vector2& outSupportPoint);
 
 	/**
 	 * @brief Finds the edge of the incident polygon closest to the reference 'other' normal.
 	 *
 	 * Identifies the edge whose normal has the smallest projection onto the reference normal.
 	 *
-	 * @param verticesIncidentShape Vertices of the incident polygon.
-	 * @param outReferenceNormal Reference normal for comparison.
+	 * @param incidentShape Vertices and edge normals of the incident polygon.
+	 * @param referenceNormal Reference normal for comparison.
 	 * @return Index of the closest edge.
 	 */
-	static size_t FindIncidentEdge(const std::vector<Vector2>& verticesIncidentShape, const Vector2& outReferenceNormal);
+	static size_t FindIncidentEdge(const PolygonSpan& incidentShape, const Vector2& referenceNormal);
 
 	/**
 	 * @brief Clips a line segment against a given line.
@@ -194,4 +193,21 @@ public:
 	 * @return Number of clipped points.
 	 */
 	static int ClipSegmentToLine(const std::vector<Vector2>& inContacts, std::vector<Vector2>& outContacts, const Vector2& clipVertex0, const Vector2& clipVertex1);
+
+	/**
+	 * @brief Time of impact of a moving circle against one side of an edge.
+	 *
+	 * The circle hits either the edge moved by the radius along its normal, or one of the two end vertices (a ray cast against the rounded edge).
+	 *
+	 * @param center Center of the circle at the start of the move.
+	 * @param radius Radius of the circle.
+	 * @param displacement Movement of the circle.
+	 * @param edgeStart Start of the edge.
+	 * @param edgeEnd End of the edge.
+	 * @param edgeNormal Unit normal of the side of the edge that can be hit.
+	 * @param[in, out] inOutTimeOfImpact Only the impacts before this fraction of the displacement are kept, updated with the new impact.
+	 * @param[out] outNormal Surface normal at the impact.
+	 * @return True if an earlier impact was found.
+	 */
+	static bool SweepCircleEdge(const Vector2& center, const float radius, const Vector2& displacement, const Vector2& edgeStart, const Vector2& edgeEnd, const Vector2& edgeNormal, float& inOutTimeOfImpact, Vector2& outNormal);
 };
\ No newline at end of file
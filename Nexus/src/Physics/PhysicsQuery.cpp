@@ -0,0 +1,380 @@
+#include "stdafx.h"
+#include "PhysicsQuery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+#include "src/ECS/Entity.h"
+#include "src/ECS/Coordinator.h"
+#include "src/Components/ChainColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Physics/BroadPhase.h"
+#include "src/Physics/PhysicsEngine.h"
+#include "src/Physics/PolygonSpan.h"
+
+size_t PhysicsQuery::RayCast(const Vector2& start, const Vector2& end, std::vector<QueryHit>& outHits, const CollisionFilterComponent& filter) const
+{
+	outHits.clear();
+	m_broadPhase->RayCast(start, end, m_candidates);
+	for (const auto& entity : m_candidates)
+	{
+		float fraction;
+		Vector2 normal;
+		if (IsAccepted(entity, filter) && RayCastCollider(entity, start, end, fraction, normal))
+		{
+			outHits.emplace_back(entity, start + (end - start) * fraction, normal, fraction);
+		}
+	}
+	std::sort(outHits.begin(), outHits.end(), [](const QueryHit& a, const QueryHit& b) { return a.fraction < b.fraction; });
+	return outHits.size();
+}
+
+bool PhysicsQuery::RayCastClosest(const Vector2& start, const Vector2& end, QueryHit& outHit, const CollisionFilterComponent& filter) const
+{
+	m_broadPhase->RayCast(start, end, m_candidates);
+	bool isHit = false;
+	for (const auto& entity : m_candidates)
+	{
+		float fraction;
+		Vector2 normal;
+		if (IsAccepted(entity, filter) && RayCastCollider(entity, start, end, fraction, normal) && (!isHit || fraction < outHit.fraction))
+		{
+			outHit = QueryHit(entity, start + (end - start) * fraction, normal, fraction);
+			isHit = true;
+		}
+	}
+	return isHit;
+}
+
+size_t PhysicsQuery::CircleCast(const Vector2& center, const float radius, const Vector2& displacement, std::vector<QueryHit>& outHits, const CollisionFilterComponent& filter) const
+{
+	outHits.clear();
+
+	// Bounds of the whole move
+	const Vector2 end = center + displacement;
+	const AABB sweptBounds(
+		Vector2(std::min(center.x, end.x) - radius, std::min(center.y, end.y) - radius),
+		Vector2(std::max(center.x, end.x) + radius, std::max(center.y, end.y) + radius)
+	);
+	m_broadPhase->QueryRegion(sweptBounds, m_candidates);
+	for (const auto& entity : m_candidates)
+	{
+		float fraction;
+		Vector2 normal;
+		if (IsAccepted(entity, filter) && CircleCastCollider(entity, center, radius, displacement, fraction, normal))
+		{
+			// The circle touches the collider on its side facing the normal
+			outHits.emplace_back(entity, center + displacement * fraction - normal * radius, normal, fraction);
+		}
+	}
+	std::sort(outHits.begin(), outHits.end(), [](const QueryHit& a, const QueryHit& b) { return a.fraction < b.fraction; });
+	return outHits.size();
+}
+
+size_t PhysicsQuery::OverlapAABB(const AABB& region, std::vector<Entity>& outEntities, const CollisionFilterComponent& filter) const
+{
+	outEntities.clear();
+	m_broadPhase->QueryRegion(region, m_candidates);
+	for (const auto& entity : m_candidates)
+	{
+		if (IsAccepted(entity, filter) && OverlapsAABB(entity, region))
+		{
+			outEntities.push_back(entity);
+		}
+	}
+	return outEntities.size();
+}
+
+size_t PhysicsQuery::OverlapCircle(const Vector2& center, const float radius, std::vector<Entity>& outEntities, const CollisionFilterComponent& filter) const
+{
+	outEntities.clear();
+	m_broadPhase->QueryRegion(AABB(center - Vector2(radius, radius), center + Vector2(radius, radius)), m_candidates);
+	for (const auto& entity : m_candidates)
+	{
+		if (IsAccepted(entity, filter) && OverlapsCircle(entity, center, radius))
+		{
+			outEntities.push_back(entity);
+		}
+	}
+	return outEntities.size();
+}
+
+bool PhysicsQuery::RayCastCollider(const Entity& entity, const Vector2& start, const Vector2& end, float& outFraction, Vector2& outNormal)
+{
+	const Vector2 direction = end - start;
+
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Circle)
+	{
+		// |start + direction * t - center| = radius
+		const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+		const Vector2 toStart = start - circleCollider.globalCenter;
+		const float c = toStart.MagnitudeSquared() - circleCollider.radius * circleCollider.radius;
+		if (c <= 0.0f) // Starts inside
+		{
+			outFraction = 0.0f;
+			outNormal = -direction.UnitVector();
+			return true;
+		}
+		const float a = direction.MagnitudeSquared();
+		const float b = toStart.Dot(direction);
+		const float discriminant = b * b - a * c;
+		if (b >= 0.0f || discriminant < 0.0f) // Moving away or missing the circle
+		{
+			return false;
+		}
+		outFraction = (-b - std::sqrt(discriminant)) / a;
+		if (outFraction > 1.0f)
+		{
+			return false;
+		}
+		outNormal = (toStart + direction * outFraction).UnitVector();
+		return true;
+	}
+
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Chain)
+	{
+		// Starting below the chain is a hit at the start, else the first segment crossed from above
+		const auto& chain = entity.GetComponent<ChainColliderComponent>();
+		float startHeight;
+		if (chain.GetHeight(start.x, startHeight) && start.y < startHeight && start.y > startHeight - chain.depth)
+		{
+			outFraction = 0.0f;
+			outNormal = -direction.UnitVector();
+			return true;
+		}
+
+		size_t begin;
+		size_t segmentEnd;
+		chain.FindSegments(std::min(start.x, end.x), std::max(start.x, end.x), begin, segmentEnd);
+		bool isHit = false;
+		for (size_t i = begin; i < segmentEnd; i++)
+		{
+			const Vector2& normal = chain.normals[i];
+			const float speed = direction.Dot(normal);
+			const float distance = (start - chain.globalVertices[i]).Dot(normal);
+			if (speed >= 0.0f || distance < 0.0f) // Moving away from or starting behind the segment
+			{
+				continue;
+			}
+			const float fraction = distance / -speed;
+			if (fraction > 1.0f || (isHit && fraction >= outFraction))
+			{
+				continue;
+			}
+			const Vector2 segment = chain.globalVertices[i + 1] - chain.globalVertices[i];
+			const float along = (start + direction * fraction - chain.globalVertices[i]).Dot(segment);
+			if (along >= 0.0f && along <= segment.MagnitudeSquared())
+			{
+				outFraction = fraction;
+				outNormal = normal;
+				isHit = true;
+			}
+		}
+		return isHit;
+	}
+
+	// Convex polygon: clip the segment with the half plane behind every edge (Cyrus-Beck)
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(entity);
+	if (polygon.IsEmpty())
+	{
+		return false;
+	}
+	float enterFraction = 0.0f;
+	float exitFraction = 1.0f;
+	bool isEntering = false;
+	for (size_t i = 0; i < polygon.count; i++)
+	{
+		const float distance = (polygon.vertices[i] - start).Dot(polygon.normals[i]); // Negative when the start is in front of the edge
+		const float speed = direction.Dot(polygon.normals[i]);
+		if (speed == 0.0f)
+		{
+			if (distance < 0.0f) // Parallel to the edge and in front of it
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const float fraction = distance / speed;
+		if (speed < 0.0f && fraction > enterFraction)
+		{
+			enterFraction = fraction;
+			outNormal = polygon.normals[i];
+			isEntering = true;
+		}
+		else if (speed > 0.0f && fraction < exitFraction)
+		{
+			exitFraction = fraction;
+		}
+		if (enterFraction > exitFraction)
+		{
+			return false;
+		}
+	}
+
+	if (!isEntering) // Starts inside
+	{
+		outNormal = -direction.UnitVector();
+	}
+	outFraction = enterFraction;
+	return true;
+}
+
+bool PhysicsQuery::CircleCastCollider(const Entity& entity, const Vector2& center, const float radius, const Vector2& displacement, float& outFraction, Vector2& outNormal)
+{
+	// PhysicsEngine's sweeps skip what is already overlapping at the start
+	if (OverlapsCircle(entity, center, radius))
+	{
+		outFraction = 0.0f;
+		outNormal = -displacement.UnitVector();
+		return true;
+	}
+
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Circle)
+	{
+		// A circle is its center inflated by its radius: sweep the sum of the radii against a zero length segment
+		const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+		return PhysicsEngine::SweepCircleSegment(center, radius + circleCollider.radius, displacement, circleCollider.globalCenter, circleCollider.globalCenter, outFraction, outNormal);
+	}
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Chain)
+	{
+		return PhysicsEngine::SweepCircleChain(center, radius, displacement, entity.GetComponent<ChainColliderComponent>(), outFraction, outNormal);
+	}
+
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(entity);
+	return !polygon.IsEmpty() && PhysicsEngine::SweepCirclePolygon(center, radius, displacement, polygon, outFraction, outNormal);
+}
+
+bool PhysicsQuery::OverlapsAABB(const Entity& entity, const AABB& region)
+{
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Circle)
+	{
+		// Closest point of the box to the center
+		const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+		const Vector2 closestPoint(
+			std::clamp(circleCollider.globalCenter.x, region.min.x, region.max.x),
+			std::clamp(circleCollider.globalCenter.y, region.min.y, region.max.y)
+		);
+		return (circleCollider.globalCenter - closestPoint).MagnitudeSquared() <= circleCollider.radius * circleCollider.radius;
+	}
+
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Chain)
+	{
+		// The box overlaps the terrain between the lowest and the highest point of the chain across it: at its sides or at a vertex in between
+		const auto& chain = entity.GetComponent<ChainColliderComponent>();
+		float minHeight = std::numeric_limits<float>::max();
+		float maxHeight = std::numeric_limits<float>::lowest();
+		for (const float x : { region.min.x, region.max.x })
+		{
+			float height;
+			if (chain.GetHeight(x, height))
+			{
+				minHeight = std::min(minHeight, height);
+				maxHeight = std::max(maxHeight, height);
+			}
+		}
+		size_t begin;
+		size_t end;
+		chain.FindSegments(region.min.x, region.max.x, begin, end);
+		for (size_t i = begin; i <= end && i < chain.globalVertices.size(); i++)
+		{
+			const Vector2& vertex = chain.globalVertices[i];
+			if (vertex.x >= region.min.x && vertex.x <= region.max.x)
+			{
+				minHeight = std::min(minHeight, vertex.y);
+				maxHeight = std::max(maxHeight, vertex.y);
+			}
+		}
+		return region.min.y <= maxHeight && region.max.y >= minHeight - chain.depth;
+	}
+
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(entity);
+	if (polygon.IsEmpty())
+	{
+		return false;
+	}
+
+	// Separating axis test between the box (same winding as the colliders) and the polygon
+	const Vector2 boxVertices[4] = { region.min, Vector2(region.max.x, region.min.y), region.max, Vector2(region.min.x, region.max.y) };
+	const Vector2 boxNormals[4] = { Vector2(0.0f, -1.0f), Vector2(1.0f, 0.0f), Vector2(0.0f, 1.0f), Vector2(-1.0f, 0.0f) };
+	PolygonSpan box;
+	box.vertices = boxVertices;
+	box.normals = boxNormals;
+	box.count = 4;
+
+	size_t edgeIndex;
+	Vector2 supportPoint;
+	return PhysicsEngine::FindMinSeparation(box, polygon, edgeIndex, supportPoint) <= 0.0f
+		&& PhysicsEngine::FindMinSeparation(polygon, box, edgeIndex, supportPoint) <= 0.0f;
+}
+
+bool PhysicsQuery::OverlapsCircle(const Entity& entity, const Vector2& center, const float radius)
+{
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Circle)
+	{
+		const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+		const float radiusSum = radius + circleCollider.radius;
+		return (circleCollider.globalCenter - center).MagnitudeSquared() <= radiusSum * radiusSum;
+	}
+
+	if (entity.GetComponent<ColliderTypeComponent>().type == ColliderType::Chain)
+	{
+		// Center below the chain, or close to one of the segments under the circle
+		const auto& chain = entity.GetComponent<ChainColliderComponent>();
+		float height;
+		if (chain.GetHeight(center.x, height) && center.y <= height && center.y > height - chain.depth)
+		{
+			return true;
+		}
+		size_t begin;
+		size_t end;
+		chain.FindSegments(center.x - radius, center.x + radius, begin, end);
+		for (size_t i = begin; i < end; i++)
+		{
+			const Vector2 segment = chain.globalVertices[i + 1] - chain.globalVertices[i];
+			const Vector2 toCenter = center - chain.globalVertices[i];
+			const float segmentLengthSquared = segment.MagnitudeSquared();
+			const float along = segmentLengthSquared > 0.0f ? std::clamp(toCenter.Dot(segment) / segmentLengthSquared, 0.0f, 1.0f) : 0.0f;
+			if ((toCenter - segment * along).MagnitudeSquared() <= radius * radius)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(entity);
+	if (polygon.IsEmpty())
+	{
+		return false;
+	}
+
+	// Inside the polygon when the center is behind every edge, else compare the distance to the closest edge
+	bool isInside = true;
+	float minDistanceSquared = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < polygon.count; i++)
+	{
+		const Vector2 edgeStart = polygon.vertices[i];
+		const Vector2 edge = polygon.Vertex(i + 1) - edgeStart;
+		const Vector2 toCenter = center - edgeStart;
+		if (toCenter.Dot(polygon.normals[i]) > 0.0f)
+		{
+			isInside = false;
+		}
+
+		const float edgeLengthSquared = edge.MagnitudeSquared();
+		const float along = edgeLengthSquared > 0.0f ? std::clamp(toCenter.Dot(edge) / edgeLengthSquared, 0.0f, 1.0f) : 0.0f;
+		minDistanceSquared = std::min(minDistanceSquared, (toCenter - edge * along).MagnitudeSquared());
+	}
+	return isInside || minDistanceSquared <= radius * radius;
+}
+
+bool PhysicsQuery::IsAccepted(const Entity& entity, const CollisionFilterComponent& filter)
+{
+	static const CollisionFilterComponent defaultFilter;
+	const auto& entityFilter = entity.HasComponent<CollisionFilterComponent>() ? entity.GetComponent<CollisionFilterComponent>() : defaultFilter;
+	return filter.ShouldCollide(entityFilter);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "src/Components/CollisionFilterComponent.h"
+#include "src/ECS/Entity.h"
+#include "src/Physics/AABB.h"
+#include "src/Utils/Vector2.h"
+
+class IBroadPhase;
+
+/**
+ * QueryHit: A collider hit by a ray cast or a circle cast of the PhysicsQuery
+ * @param entity (Entity): Entity of the collider
+ * @param point (Vector2): Hit point on the surface of the collider
+ * @param normal (Vector2): Surface normal at the hit point, facing the cast
+ * @param fraction (Float value between 0.0 - 1.0): Fraction of the cast before the hit. 0 if the cast starts inside the collider
+*/
+struct QueryHit
+{
+	Entity entity = Entity(0);
+	Vector2 point;
+	Vector2 normal;
+	float fraction = 1.0f;
+
+	QueryHit() = default;
+	QueryHit(const Entity entity, const Vector2& point, const Vector2& normal, const float fraction) :
+		entity(entity), point(point), normal(normal), fraction(fraction)
+	{}
+};
+
+//------------------------------------------------------------------------
+// PhysicsQuery
+// Spatial questions about the colliders of the world: what does a ray (or a moving circle) hit, what is inside a region. The candidates come from the collision broad phase, then the actual collider shapes are tested.
+// The results go to the caller's vector: it is cleared but keeps its capacity, so a vector reused every frame doesn't allocate. The casts are sorted by fraction.
+// Only the colliders accepted by the filter are reported, with the same category/mask/group rules as the collisions. The default filter accepts every collider.
+// Not thread safe: the queries share the candidates buffer. Get it from CollisionSystem::GetQuery()
+//------------------------------------------------------------------------
+class PhysicsQuery
+{
+public:
+	explicit PhysicsQuery(const IBroadPhase& broadPhase) : m_broadPhase(&broadPhase) {}
+
+	// The CollisionSystem calls it when its broad phase is swapped
+	void SetBroadPhase(const IBroadPhase& broadPhase) { m_broadPhase = &broadPhase; }
+
+	// Every collider crossed by the segment start -> end. Returns the number of hits
+	size_t RayCast(const Vector2& start, const Vector2& end, std::vector<QueryHit>& outHits, const CollisionFilterComponent& filter = CollisionFilterComponent()) const;
+	// Only the closest collider crossed by the segment start -> end. Returns false if nothing is hit
+	bool RayCastClosest(const Vector2& start, const Vector2& end, QueryHit& outHit, const CollisionFilterComponent& filter = CollisionFilterComponent()) const;
+	// Every collider hit by a circle moving by displacement. Returns the number of hits
+	size_t CircleCast(const Vector2& center, const float radius, const Vector2& displacement, std::vector<QueryHit>& outHits, const CollisionFilterComponent& filter = CollisionFilterComponent()) const;
+
+	// Every collider overlapping the box. Returns the number of entities
+	size_t OverlapAABB(const AABB& region, std::vector<Entity>& outEntities, const CollisionFilterComponent& filter = CollisionFilterComponent()) const;
+	// Every collider overlapping the circle (ex: blast radius). Returns the number of entities
+	size_t OverlapCircle(const Vector2& center, const float radius, std::vector<Entity>& outEntities, const CollisionFilterComponent& filter = CollisionFilterComponent()) const;
+
+	//------------------------------------------------------------------------
+	// Shape tests against the collider (circle, box, polygon or chain) of one entity
+	//------------------------------------------------------------------------
+
+	static bool RayCastCollider(const Entity& entity, const Vector2& start, const Vector2& end, float& outFraction, Vector2& outNormal);
+	static bool CircleCastCollider(const Entity& entity, const Vector2& center, const float radius, const Vector2& displacement, float& outFraction, Vector2& outNormal);
+	static bool OverlapsAABB(const Entity& entity, const AABB& region);
+	static bool OverlapsCircle(const Entity& entity, const Vector2& center, const float radius);
+
+private:
+	// Colliders without a CollisionFilterComponent are in the default category
+	[[nodiscard]] static bool IsAccepted(const Entity& entity, const CollisionFilterComponent& filter);
+
+	const IBroadPhase* m_broadPhase;
+
+	// Entities reported by the broad phase, kept between the queries to reuse the memory
+	mutable std::vector<Entity> m_candidates;
+};
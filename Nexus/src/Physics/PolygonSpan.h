@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include "src/Utils/Vector2.h"
+
+//------------------------------------------------------------------------
+// PolygonSpan
+// Non-owning view of the global vertices and edge normals of a box or polygon collider (see PhysicsEngine::GetPolygonSpan()), so the narrow phase reads them in place instead of copying the vectors.
+// normals[i] is the normal of the edge vertices[i] -> vertices[(i + 1) % count]. Only valid while the collider isn't changed
+//------------------------------------------------------------------------
+struct PolygonSpan
+{
+	const Vector2* vertices = nullptr;
+	const Vector2* normals = nullptr;
+	size_t count = 0;
+
+	PolygonSpan() = default;
+	PolygonSpan(const std::vector<Vector2>& vertices, const std::vector<Vector2>& normals) :
+		vertices(vertices.data()), normals(normals.data()), count(vertices.size())
+	{}
+
+	[[nodiscard]] bool IsEmpty() const { return count == 0; }
+	[[nodiscard]] const Vector2& Vertex(const size_t index) const { return vertices[index % count]; }
+};
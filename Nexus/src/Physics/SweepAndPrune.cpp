@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+
+int SweepAndPrune::CreateProxy(const AABB& aabb, const Entity entity, const bool isStatic)
+{
+	int proxyId;
+	if (m_freeProxies.empty())
+	{
+		proxyId = static_cast<int>(m_proxies.size());
+		m_proxies.emplace_back(aabb, entity, isStatic);
+	}
+	else
+	{
+		// Reuse the slot of a destroyed proxy
+		proxyId = m_freeProxies.back();
+		m_freeProxies.pop_back();
+		m_proxies[proxyId] = Proxy(aabb, entity, isStatic);
+	}
+
+	// New proxy is added to the end, the next SortProxies() moves it to the right place
+	m_sortedProxies.push_back(proxyId);
+	return proxyId;
+}
+
+void SweepAndPrune::DestroyProxy(const int proxyId)
+{
+	const auto it = std::find(m_sortedProxies.begin(), m_sortedProxies.end(), proxyId);
+	if (it == m_sortedProxies.end())
+	{
+		return;
+	}
+	// Erase (instead of swap and pop) to keep the list sorted
+	m_sortedProxies.erase(it);
+	m_freeProxies.push_back(proxyId);
+}
+
+void SweepAndPrune::MoveProxy(const int proxyId, const AABB& aabb, const Vector2& /*displacement*/)
+{
+	m_proxies[proxyId].aabb = aabb;
+}
+
+void SweepAndPrune::FindPairs(std::vector<BroadPhasePair>& outPairs)
+{
+	outPairs.clear();
+	SortProxies();
+
+	m_activeProxies.clear();
+	for (const int proxyId : m_sortedProxies)
+	{
+		const Proxy& proxy = m_proxies[proxyId];
+
+		for (size_t i = 0; i < m_activeProxies.size();)
+		{
+			const Proxy& activeProxy = m_proxies[m_activeProxies[i]];
+
+			// The active proxy ends before the current one starts. Since the list is sorted by min.x it can't overlap any of the following proxies either
+			if (activeProxy.aabb.max.x < proxy.aabb.min.x)
+			{
+				m_activeProxies[i] = m_activeProxies.back();
+				m_activeProxies.pop_back();
+				continue;
+			}
+
+			// Overlapping on the X axis, check the Y axis
+			if (!(proxy.isStatic && activeProxy.isStatic) &&
+				proxy.aabb.min.y <= activeProxy.aabb.max.y && proxy.aabb.max.y >= activeProxy.aabb.min.y)
+			{
+				outPairs.push_back({ activeProxy.entity, proxy.entity });
+			}
+			++i;
+		}
+		m_activeProxies.push_back(proxyId);
+	}
+}
+
+void SweepAndPrune::QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const
+{
+	// Proxies may have moved since the last sort, so the sorted order can't be used to stop early
+	outEntities.clear();
+	for (const int proxyId : m_sortedProxies)
+	{
+		const Proxy& proxy = m_proxies[proxyId];
+		if (proxy.aabb.Overlaps(region))
+		{
+			outEntities.push_back(proxy.entity);
+		}
+	}
+}
+
+void SweepAndPrune::RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+	for (const int proxyId : m_sortedProxies)
+	{
+		const Proxy& proxy = m_proxies[proxyId];
+		if (proxy.aabb.IntersectsSegment(start, end))
+		{
+			outEntities.push_back(proxy.entity);
+		}
+	}
+}
+
+void SweepAndPrune::SortProxies()
+{
+	for (size_t i = 1; i < m_sortedProxies.size(); i++)
+	{
+		const int proxyId = m_sortedProxies[i];
+		const float minX = m_proxies[proxyId].aabb.min.x;
+
+		size_t j = i;
+		while (j > 0 && m_proxies[m_sortedProxies[j - 1]].aabb.min.x > minX)
+		{
+			m_sortedProxies[j] = m_sortedProxies[j - 1];
+			--j;
+		}
+		m_sortedProxies[j] = proxyId;
+	}
+}
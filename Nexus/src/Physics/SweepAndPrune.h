@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "BroadPhase.h"
+
+//------------------------------------------------------------------------
+// SweepAndPrune
+// Broad phase that keeps the proxies sorted by the left edge (min.x) of their AABB. FindPairs() sweeps that list once while keeping an "active" list of the proxies whose x-interval is still open, so only the proxies that overlap on the X axis are tested on the Y axis.
+// Bodies move a little every frame, so the sorted list is almost sorted and an insertion sort keeps it sorted in ~O(n).
+//------------------------------------------------------------------------
+class SweepAndPrune final : public IBroadPhase
+{
+public:
+	int CreateProxy(const AABB& aabb, Entity entity, bool isStatic) override;
+	void DestroyProxy(int proxyId) override;
+	void MoveProxy(int proxyId, const AABB& aabb, const Vector2& displacement) override;
+	void FindPairs(std::vector<BroadPhasePair>& outPairs) override;
+	void QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const override;
+	void RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const override;
+
+	[[nodiscard]] size_t GetProxyCount() const override { return m_sortedProxies.size(); }
+
+private:
+	struct Proxy
+	{
+		AABB aabb;
+		Entity entity;
+		bool isStatic;
+
+		Proxy(const AABB& aabb, const Entity entity, const bool isStatic) : aabb(aabb), entity(entity), isStatic(isStatic) {}
+	};
+
+	// Insertion sort of m_sortedProxies by aabb.min.x
+	void SortProxies();
+
+	// [Vector index = proxy id]
+	std::vector<Proxy> m_proxies;
+	// Proxy ids that were destroyed and can be reused
+	std::vector<int> m_freeProxies;
+
+	// Proxy ids in use, sorted by aabb.min.x
+	std::vector<int> m_sortedProxies;
+	// Scratch list used by FindPairs() for the proxies whose x-interval is open
+	std::vector<int> m_activeProxies;
+};
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "UniformGridBroadPhase.h"
+
+#include <algorithm>
+#include <cmath>
+
+int UniformGridBroadPhase::CreateProxy(const AABB& aabb, const Entity entity, const bool isStatic)
+{
+	const CellRange cells = GetCellRange(aabb);
+	int proxyId;
+	if (m_freeProxies.empty())
+	{
+		m_proxies.emplace_back(aabb, cells, entity, isStatic);
+		proxyId = static_cast<int>(m_proxies.size()) - 1;
+	}
+	else
+	{
+		// Reuse the slot of a destroyed proxy
+		proxyId = m_freeProxies.back();
+		m_freeProxies.pop_back();
+		m_proxies[proxyId] = Proxy(aabb, cells, entity, isStatic);
+	}
+
+	InsertIntoCells(proxyId, cells);
+	return proxyId;
+}
+
+void UniformGridBroadPhase::DestroyProxy(const int proxyId)
+{
+	if (!m_proxies[proxyId].isAlive)
+	{
+		return;
+	}
+	RemoveFromCells(proxyId, m_proxies[proxyId].cells);
+	m_proxies[proxyId].isAlive = false;
+	m_freeProxies.push_back(proxyId);
+}
+
+void UniformGridBroadPhase::MoveProxy(const int proxyId, const AABB& aabb, const Vector2& /*displacement*/)
+{
+	Proxy& proxy = m_proxies[proxyId];
+	proxy.aabb = aabb;
+
+	// Most moves stay within the same cells
+	const CellRange cells = GetCellRange(aabb);
+	if (cells == proxy.cells)
+	{
+		return;
+	}
+	RemoveFromCells(proxyId, proxy.cells);
+	InsertIntoCells(proxyId, cells);
+	proxy.cells = cells;
+}
+
+void UniformGridBroadPhase::FindPairs(std::vector<BroadPhasePair>& outPairs)
+{
+	outPairs.clear();
+
+	// Test the proxies sharing a cell
+	for (const auto& [key, cell] : m_cells)
+	{
+		for (size_t i = 0; i < cell.size(); i++)
+		{
+			const Proxy& a = m_proxies[cell[i]];
+			for (size_t j = i + 1; j < cell.size(); j++)
+			{
+				const Proxy& b = m_proxies[cell[j]];
+				if ((a.isStatic && b.isStatic) || !a.aabb.Overlaps(b.aabb))
+				{
+					continue;
+				}
+
+				// Report the pair only from the cell that holds the bottom left corner of the overlap, so it is reported once
+				const int overlapX = GetCellCoordinate(std::max(a.aabb.min.x, b.aabb.min.x));
+				const int overlapY = GetCellCoordinate(std::max(a.aabb.min.y, b.aabb.min.y));
+				if (GetCellKey(overlapX, overlapY) == key)
+				{
+					outPairs.push_back({ a.entity, b.entity });
+				}
+			}
+		}
+	}
+}
+
+void UniformGridBroadPhase::QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+
+	// A region covering more cells than are occupied is cheaper to test against every proxy
+	const CellRange cells = GetCellRange(region);
+	const int64_t cellCount = (static_cast<int64_t>(cells.maxX) - cells.minX + 1) * (static_cast<int64_t>(cells.maxY) - cells.minY + 1);
+	if (cellCount > static_cast<int64_t>(m_cells.size()))
+	{
+		for (const auto& proxy : m_proxies)
+		{
+			if (proxy.isAlive && proxy.aabb.Overlaps(region))
+			{
+				outEntities.push_back(proxy.entity);
+			}
+		}
+		return;
+	}
+
+	for (int x = cells.minX; x <= cells.maxX; x++)
+	{
+		for (int y = cells.minY; y <= cells.maxY; y++)
+		{
+			const auto it = m_cells.find(GetCellKey(x, y));
+			if (it == m_cells.end())
+			{
+				continue;
+			}
+			for (const int proxyId : it->second)
+			{
+				const Proxy& proxy = m_proxies[proxyId];
+				// Like FindPairs(), only the cell that holds the bottom left corner of the overlap reports the proxy
+				if (proxy.aabb.Overlaps(region) &&
+					GetCellCoordinate(std::max(proxy.aabb.min.x, region.min.x)) == x &&
+					GetCellCoordinate(std::max(proxy.aabb.min.y, region.min.y)) == y)
+				{
+					outEntities.push_back(proxy.entity);
+				}
+			}
+		}
+	}
+}
+
+void UniformGridBroadPhase::RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const
+{
+	outEntities.clear();
+	for (const auto& proxy : m_proxies)
+	{
+		if (proxy.isAlive && proxy.aabb.IntersectsSegment(start, end))
+		{
+			outEntities.push_back(proxy.entity);
+		}
+	}
+}
+
+int UniformGridBroadPhase::GetCellCoordinate(const float value) const
+{
+	return static_cast<int>(std::floor(value * m_inverseCellSize));
+}
+
+UniformGridBroadPhase::CellRange UniformGridBroadPhase::GetCellRange(const AABB& aabb) const
+{
+	return { GetCellCoordinate(aabb.min.x), GetCellCoordinate(aabb.min.y), GetCellCoordinate(aabb.max.x), GetCellCoordinate(aabb.max.y) };
+}
+
+int64_t UniformGridBroadPhase::GetCellKey(const int x, const int y)
+{
+	return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y);
+}
+
+void UniformGridBroadPhase::InsertIntoCells(const int proxyId, const CellRange& cells)
+{
+	for (int x = cells.minX; x <= cells.maxX; x++)
+	{
+		for (int y = cells.minY; y <= cells.maxY; y++)
+		{
+			m_cells[GetCellKey(x, y)].push_back(proxyId);
+		}
+	}
+}
+
+void UniformGridBroadPhase::RemoveFromCells(const int proxyId, const CellRange& cells)
+{
+	for (int x = cells.minX; x <= cells.maxX; x++)
+	{
+		for (int y = cells.minY; y <= cells.maxY; y++)
+		{
+			const auto it = m_cells.find(GetCellKey(x, y));
+			if (it == m_cells.end())
+			{
+				continue;
+			}
+
+			// The order inside a cell doesn't matter
+			std::vector<int>& cell = it->second;
+			const auto proxyIt = std::find(cell.begin(), cell.end(), proxyId);
+			if (proxyIt != cell.end())
+			{
+				*proxyIt = cell.back();
+				cell.pop_back();
+			}
+			if (cell.empty())
+			{
+				m_cells.erase(it);
+			}
+		}
+	}
+}
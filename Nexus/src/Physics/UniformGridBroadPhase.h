@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BroadPhase.h"
+
+//------------------------------------------------------------------------
+// UniformGridBroadPhase
+// Broad phase that hashes every proxy into the square cells (cellSize x cellSize) its AABB touches. Only proxies sharing a cell are tested against each other.
+// Works best when the colliders are roughly the size of a cell. A pair that shares several cells is only reported by the cell that holds the bottom left corner of their overlap.
+// The cells are kept between the steps: a proxy is only re-hashed when its AABB moves onto other cells, so the static proxies and the bodies that stay within their cells are not re-hashed.
+//------------------------------------------------------------------------
+class UniformGridBroadPhase final : public IBroadPhase
+{
+public:
+	explicit UniformGridBroadPhase(const float cellSize = 128.f) : m_inverseCellSize(1.f / cellSize) {}
+
+	int CreateProxy(const AABB& aabb, Entity entity, bool isStatic) override;
+	void DestroyProxy(int proxyId) override;
+	void MoveProxy(int proxyId, const AABB& aabb, const Vector2& displacement) override;
+	void FindPairs(std::vector<BroadPhasePair>& outPairs) override;
+	void QueryRegion(const AABB& region, std::vector<Entity>& outEntities) const override;
+	void RayCast(const Vector2& start, const Vector2& end, std::vector<Entity>& outEntities) const override;
+
+	[[nodiscard]] size_t GetProxyCount() const override { return m_proxies.size() - m_freeProxies.size(); }
+
+private:
+	// Inclusive range of the cells an AABB touches
+	struct CellRange
+	{
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+
+		bool operator==(const CellRange& other) const { return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY; }
+	};
+
+	struct Proxy
+	{
+		AABB aabb;
+		CellRange cells;
+		Entity entity;
+		bool isStatic;
+		bool isAlive;
+
+		Proxy(const AABB& aabb, const CellRange& cells, const Entity entity, const bool isStatic) : aabb(aabb), cells(cells), entity(entity), isStatic(isStatic), isAlive(true) {}
+	};
+
+	[[nodiscard]] int GetCellCoordinate(float value) const;
+	[[nodiscard]] CellRange GetCellRange(const AABB& aabb) const;
+	[[nodiscard]] static int64_t GetCellKey(int x, int y);
+
+	// Add/remove the proxy id to/from every cell of the range
+	void InsertIntoCells(int proxyId, const CellRange& cells);
+	void RemoveFromCells(int proxyId, const CellRange& cells);
+
+	// Every MoveProxy() computes the cells of the AABB, a multiplication is cheaper than a division
+	float m_inverseCellSize;
+
+	// [Vector index = proxy id]
+	std::vector<Proxy> m_proxies;
+	// Proxy ids that were destroyed and can be reused
+	std::vector<int> m_freeProxies;
+
+	// Proxy ids per cell. The cells that become empty are erased, so FindPairs() only walks the occupied ones
+	// [Map key = packed cell coordinates]
+	std::unordered_map<int64_t, std::vector<int>> m_cells;
+};
@@ -20,6 +20,9 @@ public:
 	{
 		RequireComponent<SpriteComponent>();
 		RequireComponent<AnimationComponent>();
+
+		ReadComponent<SpriteComponent>();
+		WriteComponent<AnimationComponent>();
 	}
 
 	void Update(const std::unique_ptr<AssetManager>& assetManager, const float deltaTime) const
@@ -4,6 +4,7 @@
 #include "src/ECS/Entity.h"
 
 #include "src/Components/CameraFollowComponent.h"
+#include "src/Components/RigidBodyComponent.h"
 #include "src/Components/TransformComponent.h"
 
 #include "src/Physics/Camera.h"
@@ -35,9 +36,13 @@ public:
 	{
 		RequireComponent<CameraFollowComponent>();
 		RequireComponent<TransformComponent>();
+
+		ReadComponent<CameraFollowComponent>();
+		ReadComponent<TransformComponent>();
 	}
 
-	void Update(Camera& camera) const
+	// alpha: how far the frame is between the last two physics steps (FixedTimestep::GetAlpha()). The camera follows the players where RenderSystem draws them
+	void Update(Camera& camera, const float alpha = 1.f) const
 	{
 		auto& entities = GetSystemEntities();
 		if (entities.empty()) return;
@@ -51,26 +56,25 @@ public:
 		if (isSinglePlayer)
 		{
 			// Single player: Follow the player with offset
-			const auto& transform = entities[0].GetComponent<TransformComponent>();
-			targetPos = transform.position + (m_cameraOffset / 2.f);
+			targetPos = GetDrawnPosition(entities[0], alpha) + (m_cameraOffset / 2.f);
 		}
 		else
 		{
 			// Two players: Position camera to keep both in view.
-			const auto& transform1 = entities[0].GetComponent<TransformComponent>();
-			const auto& transform2 = entities[1].GetComponent<TransformComponent>();
+			const Vector2 position1 = GetDrawnPosition(entities[0], alpha);
+			const Vector2 position2 = GetDrawnPosition(entities[1], alpha);
 
 			// Calculate distance between players
-			const float distanceX = std::abs(transform1.position.x - transform2.position.x);
-			const float distanceY = std::abs(transform1.position.y - transform2.position.y);
+			const float distanceX = std::abs(position1.x - position2.x);
+			const float distanceY = std::abs(position1.y - position2.y);
 
 			// Only move camera if players are far enough apart
 			if (distanceX > m_minPlayerDistance || distanceY > m_minPlayerDistance)
 			{
 				// Calculate midpoint between players (TODO: handle offset for 2 players)
 				targetPos = Vector2(
-					(transform1.position.x + transform2.position.x) * 0.5f,
-					(transform1.position.y + transform2.position.y) * 0.5f
+					(position1.x + position2.x) * 0.5f,
+					(position1.y + position2.y) * 0.5f
 				);
 				// targetPos = Vector2(
 				// 	(transform1.position.x + transform2.position.x) * 0.5f,
@@ -100,4 +104,12 @@ public:
 
 		camera.SetPosition(newPos);
 	}
+
+private:
+	// Same position as RenderSystem::Update(): the rigid bodies are drawn between their last two physics steps
+	static Vector2 GetDrawnPosition(const Entity& entity, const float alpha)
+	{
+		const auto& transform = entity.GetComponent<TransformComponent>();
+		return entity.HasComponent<RigidBodyComponent>() ? transform.GetInterpolatedPosition(alpha) : transform.position;
+	}
 };
@@ -2,6 +2,10 @@
 
 #include "CollisionSystem.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "src/ECS/Entity.h"
 #include "src/ECS/Coordinator.h"
 
@@ -9,91 +13,180 @@
 #include "src/Events/CollisionEvent.h"
 
 #include "src/Components/BoxColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
 #include "src/Components/CircleColliderComponent.h"
 #include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/CollisionFilterComponent.h"
 #include "src/Components/PolygonColliderComponent.h"
+#include "src/Components/RigidBodyComponent.h"
+#include "src/Components/TransformComponent.h"
 
 #include "src/Physics/PhysicsEngine.h"
+#include "src/Physics/DynamicAABBTree.h"
+#include "src/Physics/PolygonSpan.h"
 
+#include "src/Utils/JobSystem.h"
+
+CollisionSystem::CollisionSystem() : m_broadPhase(std::make_unique<DynamicAABBTree>()), m_query(*m_broadPhase)
+{
+	RequireComponent<ColliderTypeComponent>();
+	RequireComponent<TransformComponent>();
+	// No ReadComponent/WriteComponent: it emits CollisionEvents, so the SystemScheduler runs it alone
+}
 
 bool CollisionSystem::ShouldIgnoreCollision(const Entity a, const Entity b)
 {
-	// Define groups and tags to ignore collisions between
-	const std::vector<std::string> groupsToIgnore = {
-		"Terrain",
-		"LaserShooter",
-		"StaticKillers",
-		"Anchor",
-		"Spring",
-		"Bead"
-	};
-	const std::vector<std::string> tagsToIgnore = { "Hole" };
+	return !GetCollisionFilter(a).ShouldCollide(GetCollisionFilter(b));
+}
+
+const CollisionFilterComponent& CollisionSystem::GetCollisionFilter(const Entity& entity)
+{
+	// Colliders without a filter are in the default category and collide with everything
+	static const CollisionFilterComponent defaultFilter;
+	return entity.HasComponent<CollisionFilterComponent>() ? entity.GetComponent<CollisionFilterComponent>() : defaultFilter;
+}
 
-	// Check if both entities belong to groups that should ignore collision
-	for (const auto& group : groupsToIgnore)
+void CollisionSystem::Update(const std::shared_ptr<EventManager>& eventManager)
+{
+	// Colliders without a RigidBody are not updated by the PhysicsSystem, so update their bounds here
+	for (const auto& entity : GetSystemEntities())
 	{
-		if (a.BelongsToGroup(group) && b.BelongsToGroup(group))
+		if (!entity.HasComponent<RigidBodyComponent>())
 		{
-			return true;
+			m_broadPhase->MoveProxy(entity.GetComponent<ColliderTypeComponent>().proxyId, PhysicsEngine::GetColliderAABB(entity), Vector2());
 		}
 	}
 
-	// Check if both entities have tags that should ignore collision
-	for (const auto& tag : tagsToIgnore)
+	// Only the pairs whose bounding boxes overlap go through the narrow phase
+	m_broadPhase->FindPairs(m_pairs);
+
+	// The narrow phase only reads the components, so the pairs are tested in parallel. Each pair writes its own result
+	m_narrowPhaseResults.resize(m_pairs.size());
+	JobSystem::ParallelFor(m_pairs.size(), 32, [this](const size_t begin, const size_t end)
 	{
-		if (a.HasTag(tag) && b.HasTag(tag))
+		for (size_t i = begin; i < end; i++)
 		{
-			return true;
+			const auto& [a, b] = m_pairs[i];
+			auto& result = m_narrowPhaseResults[i];
+			result.contacts.clear();
+
+			// Early exit if collision should be ignored
+			result.isColliding = !ShouldIgnoreCollision(a, b)
+				&& IsColliding(a, b, a.GetComponent<ColliderTypeComponent>(), b.GetComponent<ColliderTypeComponent>(), result.contacts);
 		}
-	}
+	});
 
-	// Check collisions between specific tags and groups
-	for (const auto& tag : tagsToIgnore)
+	// Events are queued on this thread, in pair order. The listeners get them at the flush after the collision step
+	for (size_t i = 0; i < m_pairs.size(); i++)
 	{
-		for (const auto& group : groupsToIgnore)
+		const auto& [a, b] = m_pairs[i];
+		auto& result = m_narrowPhaseResults[i];
+		if (result.isColliding)
 		{
-			if ((a.HasTag(tag) && b.BelongsToGroup(group)) ||
-				(b.HasTag(tag) && a.BelongsToGroup(group)))
-			{
-				return true;
-			}
+			a.GetComponent<ColliderTypeComponent>().contacts = result.contacts; // For render debug
+			b.GetComponent<ColliderTypeComponent>().contacts = result.contacts; // For render debug
+			eventManager->QueueEvent<CollisionEvent>(a, b, result.contacts);
 		}
 	}
+}
 
-	// if (a.BelongsToGroup("Bead") && )
-	return false;
+float CollisionSystem::FindTimeOfImpact(const Entity& entity, const Vector2& displacement, Vector2& outNormal)
+{
+	const auto& circleCollider = entity.GetComponent<CircleColliderComponent>();
+	Entity other = entity;
+	return FindTimeOfImpact(circleCollider.globalCenter, circleCollider.radius, displacement, GetCollisionFilter(entity), outNormal, other);
 }
 
-void CollisionSystem::Update(const std::shared_ptr<EventManager>& eventManager) const
+float CollisionSystem::FindTimeOfImpact(const Vector2& start, const float radius, const Vector2& displacement, const CollisionFilterComponent& filter, Vector2& outNormal, Entity& outOther)
 {
-	auto entities = GetSystemEntities();
+	const Vector2 end = start + displacement;
 
-	// Loop all entities that the system is interested in
-	for (auto i = entities.begin(); i != entities.end(); ++i)
-	{
-		Entity a = *i;
-		auto& aColliderType = a.GetComponent<ColliderTypeComponent>();
+	// Bounds of the whole move
+	const AABB sweptBounds(
+		Vector2(std::min(start.x, end.x) - radius, std::min(start.y, end.y) - radius),
+		Vector2(std::max(start.x, end.x) + radius, std::max(start.y, end.y) + radius)
+	);
+	m_broadPhase->QueryRegion(sweptBounds, m_sweepCandidates);
 
-		for (auto j = i + 1; j != entities.end(); ++j)
+	float minTimeOfImpact = 1.0f;
+	for (const auto& other : m_sweepCandidates)
+	{
+		// The moving colliders are left to the discrete collision detection
+		if ((other.HasComponent<RigidBodyComponent>() && !IsStaticCollider(other)) || !filter.ShouldCollide(GetCollisionFilter(other)))
 		{
-			Entity b = *j;
-			auto& bColliderType = b.GetComponent<ColliderTypeComponent>();
+			continue;
+		}
 
-			// Early exit if collision should be ignored
-			if (ShouldIgnoreCollision(a, b))
-			{
-				continue;
-			}
+		float timeOfImpact = 1.0f;
+		Vector2 normal;
+		bool isHit = false;
+		const ColliderType otherType = other.GetComponent<ColliderTypeComponent>().type;
+		if (otherType == ColliderType::Circle)
+		{
+			// A circle is its center inflated by its radius: sweep the sum of the radii against a zero length segment
+			const auto& otherCollider = other.GetComponent<CircleColliderComponent>();
+			isHit = PhysicsEngine::SweepCircleSegment(start, radius + otherCollider.radius, displacement, otherCollider.globalCenter, otherCollider.globalCenter, timeOfImpact, normal);
+		}
+		else if (otherType == ColliderType::Chain)
+		{
+			isHit = PhysicsEngine::SweepCircleChain(start, radius, displacement, other.GetComponent<ChainColliderComponent>(), timeOfImpact, normal);
+		}
+		else
+		{
+			isHit = PhysicsEngine::SweepCirclePolygon(start, radius, displacement, PhysicsEngine::GetPolygonSpan(other), timeOfImpact, normal);
+		}
 
-			std::vector<Contact> contacts;
-			if (IsColliding(a, b, aColliderType, bColliderType, contacts))
-			{
-				aColliderType.contacts = contacts; // For render debug
-				bColliderType.contacts = contacts; // For render debug
-				eventManager->EmitEvent<CollisionEvent>(a, b, contacts);
-			}
+		if (isHit && timeOfImpact < minTimeOfImpact)
+		{
+			minTimeOfImpact = timeOfImpact;
+			outNormal = normal;
+			outOther = other;
 		}
 	}
+	return minTimeOfImpact;
+}
+
+void CollisionSystem::SetBroadPhase(std::unique_ptr<IBroadPhase> broadPhase)
+{
+	m_broadPhase = std::move(broadPhase);
+	m_query.SetBroadPhase(*m_broadPhase);
+	for (const auto& entity : GetSystemEntities())
+	{
+		CreateProxy(entity);
+	}
+}
+
+void CollisionSystem::OnEntityAdded(const Entity entity)
+{
+	CreateProxy(entity);
+}
+
+void CollisionSystem::OnEntityRemoved(const Entity entity)
+{
+	auto& colliderType = entity.GetComponent<ColliderTypeComponent>();
+	if (colliderType.proxyId != IBroadPhase::NULL_PROXY)
+	{
+		m_broadPhase->DestroyProxy(colliderType.proxyId);
+		colliderType.proxyId = IBroadPhase::NULL_PROXY;
+	}
+}
+
+bool CollisionSystem::IsStaticCollider(const Entity& entity)
+{
+	if (!entity.HasComponent<RigidBodyComponent>())
+	{
+		return false;
+	}
+	const auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+	return !rigidBody.isKinematic && rigidBody.mass == 0.0f;
+}
+
+void CollisionSystem::CreateProxy(const Entity& entity)
+{
+	// Entities are added to the system before the first physics update, so make sure the global vertices/center are up-to-date
+	PhysicsEngine::UpdateColliderProperties(entity, entity.GetComponent<TransformComponent>());
+
+	entity.GetComponent<ColliderTypeComponent>().proxyId = m_broadPhase->CreateProxy(PhysicsEngine::GetColliderAABB(entity), entity, IsStaticCollider(entity));
 }
 
 bool CollisionSystem::IsColliding(const Entity a, const Entity b, const ColliderTypeComponent& aType,
@@ -127,8 +220,15 @@ bool CollisionSystem::IsColliding(const Entity a, const Entity b, const Collider
 	// Circle-Polygon collision
 	else if (aType.type == ColliderType::Circle && (bType.type == ColliderType::Polygon || bType.type == ColliderType::Box))
 	{
+		const size_t firstContact = contacts.size();
 		if (IsCollidingCirclePolygon(a, b, contacts))
 		{
+			// The contacts are from the polygon, make them go from 'a' to 'b'. The broad phase gives the pairs in any order
+			for (size_t i = firstContact; i < contacts.size(); i++)
+			{
+				std::swap(contacts[i].startContactPoint, contacts[i].endContactPoint);
+				contacts[i].collisionNormal *= -1.0f;
+			}
 			// Logger::Log("Circle-Polygon collision between Entity " + std::to_string(a.GetId()) + " and Entity " + std::to_string(b.GetId()));
 			// Logger::Log("Collision Depth: ");
 			// for (const auto& contact : contacts)
@@ -149,9 +249,38 @@ bool CollisionSystem::IsColliding(const Entity a, const Entity b, const Collider
 			return true;
 		}
 	}
+
+	// Chain-Circle or Chain-Polygon collision (terrain). Two chains never collide, they are static
+	else if (aType.type == ColliderType::Chain && bType.type != ColliderType::Chain)
+	{
+		return IsCollidingWithChain(b, bType, a, contacts);
+	}
+
+	// Circle-Chain or Polygon-Chain collision
+	else if (aType.type != ColliderType::Chain && bType.type == ColliderType::Chain)
+	{
+		const size_t firstContact = contacts.size();
+		if (IsCollidingWithChain(a, aType, b, contacts))
+		{
+			// The contacts are from the chain, make them go from 'a' to 'b'
+			for (size_t i = firstContact; i < contacts.size(); i++)
+			{
+				std::swap(contacts[i].startContactPoint, contacts[i].endContactPoint);
+				contacts[i].collisionNormal *= -1.0f;
+			}
+			return true;
+		}
+	}
 	return false;
 }
 
+bool CollisionSystem::IsCollidingWithChain(const Entity other, const ColliderTypeComponent& otherType, const Entity chainEntity, std::vector<Contact>& outContacts)
+{
+	return otherType.type == ColliderType::Circle
+		? IsCollidingCircleChain(other, chainEntity, outContacts)
+		: IsCollidingPolygonChain(other, chainEntity, outContacts);
+}
+
 bool CollisionSystem::IsCollidingCircleCircle(const Entity a, const Entity b, std::vector<Contact>& outContacts)
 {
 	const auto& aCircleCollider = a.GetComponent<CircleColliderComponent>();
@@ -182,30 +311,12 @@ bool CollisionSystem::IsCollidingCircleCircle(const Entity a, const Entity b, st
 
 bool CollisionSystem::IsCollidingPolygonPolygon(const Entity a, const Entity b, std::vector<Contact>& outContacts)
 {
-	const auto& aCollider = a.GetComponent<ColliderTypeComponent>();
-	const auto& bCollider = b.GetComponent<ColliderTypeComponent>();
-
-	std::vector<Vector2> aGlobalVertices;
-	std::vector<Vector2> bGlobalVertices;
-
-	// Retrieve polygon (or box) properties of entity 'a'
-	if (aCollider.type == ColliderType::Box)
-	{
-		aGlobalVertices = a.GetComponent<BoxColliderComponent>().globalVertices;
-	}
-	else if (aCollider.type == ColliderType::Polygon)
+	// Polygon (or box) vertices and edge normals of both entities, read in place
+	const PolygonSpan aPolygon = PhysicsEngine::GetPolygonSpan(a);
+	const PolygonSpan bPolygon = PhysicsEngine::GetPolygonSpan(b);
+	if (aPolygon.IsEmpty() || bPolygon.IsEmpty())
 	{
-		aGlobalVertices = a.GetComponent<PolygonColliderComponent>().globalVertices;
-	}
-
-	// Retrieve polygon (or box) properties of entity 'b'
-	if (bCollider.type == ColliderType::Box)
-	{
-		bGlobalVertices = b.GetComponent<BoxColliderComponent>().globalVertices;
-	}
-	else if (bCollider.type == ColliderType::Polygon)
-	{
-		bGlobalVertices = b.GetComponent<PolygonColliderComponent>().globalVertices;
+		return false;
 	}
 
 	// // Values will be calculated by IsSATCollision()
@@ -215,7 +326,7 @@ bool CollisionSystem::IsCollidingPolygonPolygon(const Entity a, const Entity b,
 	// Vector2 collisionNormal;
 	//
 	// Contact contact;
-	if (!PhysicsEngine::IsSATCollision(aGlobalVertices, bGlobalVertices, outContacts))
+	if (!PhysicsEngine::IsSATCollision(aPolygon, bPolygon, outContacts))
 	{
 		return false;
 	}
@@ -233,15 +344,10 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 	float circleRadius = circleCollider.radius;
 
 	// Retrieve polygon (or box) properties
-	const auto& polygonCollider = polygonEntity.GetComponent<ColliderTypeComponent>();
-	std::vector<Vector2> polygonVertices; // Global vertices
-	if (polygonCollider.type == ColliderType::Box)
-	{
-		polygonVertices = polygonEntity.GetComponent<BoxColliderComponent>().globalVertices;
-	}
-	else if (polygonCollider.type == ColliderType::Polygon)
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(polygonEntity); // Global vertices and edge normals
+	if (polygon.IsEmpty())
 	{
-		polygonVertices = polygonEntity.GetComponent<PolygonColliderComponent>().globalVertices;
+		return false;
 	}
 
 	//------------------------------------------------------------------------
@@ -249,17 +355,17 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 	//------------------------------------------------------------------------
 	Vector2 closestEdgeStart;
 	Vector2 closestEdgeEnd;
+	size_t closestEdgeIndex = 0; // Feature id of the contact
 
 	bool isCircleCenterOutsidePolygon = false;
 	float maxProjection = std::numeric_limits<float>::lowest(); // Maximum Projection between an edge to the circle's center
 
 	// Loop all the edges of the polygon to find the nearest edge to the circle center
-	for (size_t i = 0; i < polygonVertices.size(); i++)
+	for (size_t i = 0; i < polygon.count; i++)
 	{
-		Vector2 edgeStart = polygonVertices[i];
-		Vector2 edgeEnd = polygonVertices[(i + 1) % polygonVertices.size()];
-		Vector2 edge = edgeEnd - edgeStart;
-		Vector2 edgeNormal = edge.Normal();
+		Vector2 edgeStart = polygon.vertices[i];
+		Vector2 edgeEnd = polygon.Vertex(i + 1);
+		Vector2 edgeNormal = polygon.normals[i];
 
 		// Project the circle center onto the edge normal
 		Vector2 vertexToCircleCenter = circleCenter - edgeStart;
@@ -271,6 +377,7 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 			maxProjection = projection;
 			closestEdgeStart = edgeStart;
 			closestEdgeEnd = edgeEnd;
+			closestEdgeIndex = i;
 			isCircleCenterOutsidePolygon = true;
 		}
 		else
@@ -281,6 +388,7 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 				maxProjection = projection;
 				closestEdgeStart = edgeStart;
 				closestEdgeEnd = edgeEnd;
+				closestEdgeIndex = i;
 			}
 		}
 	}
@@ -386,7 +494,7 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 					float penetrationDepth = circleRadius - maxProjection;
 					Vector2 startContactPoint = circleCenter - (collisionNormal * circleRadius);
 					Vector2 endContactPoint = startContactPoint + (collisionNormal * penetrationDepth);
-					outContacts.emplace_back(startContactPoint, endContactPoint, collisionNormal, penetrationDepth);
+					outContacts.emplace_back(startContactPoint, endContactPoint, collisionNormal, penetrationDepth, static_cast<uint32_t>(closestEdgeIndex));
 					return true;
 				}
 			}
@@ -399,7 +507,147 @@ bool CollisionSystem::IsCollidingCirclePolygon(const Entity circleEntity, const
 		float penetrationDepth = circleRadius - maxProjection;
 		Vector2 startContactPoint = circleCenter - (collisionNormal * circleRadius);
 		Vector2 endContactPoint = startContactPoint + (collisionNormal * penetrationDepth);
-		outContacts.emplace_back(startContactPoint, endContactPoint, collisionNormal, penetrationDepth);
+		outContacts.emplace_back(startContactPoint, endContactPoint, collisionNormal, penetrationDepth, static_cast<uint32_t>(closestEdgeIndex));
 		return true;
 	}
 }
+
+bool CollisionSystem::IsCollidingCircleChain(const Entity circleEntity, const Entity chainEntity, std::vector<Contact>& outContacts)
+{
+	const auto& circleCollider = circleEntity.GetComponent<CircleColliderComponent>();
+	const auto& chain = chainEntity.GetComponent<ChainColliderComponent>();
+	const Vector2 center = circleCollider.globalCenter;
+	const float radius = circleCollider.radius;
+
+	// Only the segments under the circle
+	size_t begin;
+	size_t end;
+	chain.FindSegments(center.x - radius, center.x + radius, begin, end);
+
+	// The normals point up, from the chain to the circle. Feature id = segment or vertex index * 2, + 1 for a vertex
+	const size_t contactCount = outContacts.size();
+	auto addContact = [&outContacts, center, radius](const Vector2& normal, const float penetrationDepth, const uint32_t featureId)
+	{
+		const Vector2 startContactPoint = center - normal * radius;
+		outContacts.emplace_back(startContactPoint, startContactPoint + normal * penetrationDepth, normal, penetrationDepth, featureId);
+	};
+	for (size_t i = begin; i < end; i++)
+	{
+		const Vector2& segmentStart = chain.globalVertices[i];
+		const Vector2& segmentEnd = chain.globalVertices[i + 1];
+		const Vector2& normal = chain.normals[i];
+		const float distance = (center - segmentStart).Dot(normal);
+
+		if (distance < 0.0f)
+		{
+			// Center below the chain: pushed up by the segment right above it
+			if (center.x >= segmentStart.x && center.x < segmentEnd.x && distance > -chain.depth)
+			{
+				addContact(normal, radius - distance, static_cast<uint32_t>(i) << 1);
+			}
+			continue;
+		}
+
+		// Closest to the inside of the segment
+		const Vector2 segment = segmentEnd - segmentStart;
+		const float along = (center - segmentStart).Dot(segment);
+		if (along > 0.0f && along < segment.MagnitudeSquared())
+		{
+			if (distance < radius)
+			{
+				addContact(normal, radius - distance, static_cast<uint32_t>(i) << 1);
+			}
+			continue;
+		}
+
+		// Closest to a vertex. A vertex between two segments is only tested by the segment starting at it, and only if it is a peak: the segments around the other vertices are closer
+		const size_t vertex = along <= 0.0f ? i : i + 1;
+		if ((vertex == i + 1 && vertex < chain.GetSegmentCount()) || !chain.IsConvexVertex(vertex))
+		{
+			continue;
+		}
+		const Vector2 vertexToCenter = center - chain.globalVertices[vertex];
+		const float distanceSquared = vertexToCenter.MagnitudeSquared();
+		if (distanceSquared < radius * radius && distanceSquared > 0.0f)
+		{
+			const float vertexDistance = std::sqrt(distanceSquared);
+			addContact(vertexToCenter / vertexDistance, radius - vertexDistance, (static_cast<uint32_t>(vertex) << 1) | 1u);
+		}
+	}
+	return outContacts.size() > contactCount;
+}
+
+bool CollisionSystem::IsCollidingPolygonChain(const Entity polygonEntity, const Entity chainEntity, std::vector<Contact>& outContacts)
+{
+	const PolygonSpan polygon = PhysicsEngine::GetPolygonSpan(polygonEntity);
+	const auto& chain = chainEntity.GetComponent<ChainColliderComponent>();
+	if (polygon.IsEmpty() || chain.GetSegmentCount() == 0)
+	{
+		return false;
+	}
+	const size_t contactCount = outContacts.size();
+
+	//------------------------------------------------------------------------
+	// Vertices of the polygon below the chain, pushed up by the segment right above them
+	//------------------------------------------------------------------------
+	float minX = polygon.vertices[0].x;
+	float maxX = polygon.vertices[0].x;
+	for (size_t i = 0; i < polygon.count; i++)
+	{
+		const Vector2& vertex = polygon.vertices[i];
+		minX = std::min(minX, vertex.x);
+		maxX = std::max(maxX, vertex.x);
+
+		size_t segment;
+		size_t segmentEnd;
+		chain.FindSegments(vertex.x, vertex.x, segment, segmentEnd);
+		if (segment == segmentEnd)
+		{
+			continue; // Beyond the ends of the chain
+		}
+		const Vector2& normal = chain.normals[segment];
+		const float distance = (vertex - chain.globalVertices[segment]).Dot(normal);
+		if (distance < 0.0f && distance > -chain.depth)
+		{
+			// Feature id = segment | polygon vertex | 0
+			const uint32_t featureId = (static_cast<uint32_t>(segment & 0xFFFF) << 16) | (static_cast<uint32_t>(i & 0x7FFF) << 1);
+			outContacts.emplace_back(vertex, vertex - normal * distance, normal, -distance, featureId);
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// Peaks of the chain inside the polygon (ex: a box on a hill top), pushed out through the closest edge of the polygon
+	//------------------------------------------------------------------------
+	size_t begin;
+	size_t end;
+	chain.FindSegments(minX, maxX, begin, end);
+	for (size_t vertexIndex = begin; vertexIndex <= end && vertexIndex < chain.globalVertices.size(); vertexIndex++)
+	{
+		const Vector2& vertex = chain.globalVertices[vertexIndex];
+		if (vertex.x < minX || vertex.x > maxX || !chain.IsConvexVertex(vertexIndex))
+		{
+			continue;
+		}
+
+		// Inside when behind every edge, the least negative separation is the closest edge
+		float maxSeparation = std::numeric_limits<float>::lowest();
+		size_t closestEdge = 0;
+		for (size_t i = 0; i < polygon.count && maxSeparation < 0.0f; i++)
+		{
+			const float separation = (vertex - polygon.vertices[i]).Dot(polygon.normals[i]);
+			if (separation > maxSeparation)
+			{
+				maxSeparation = separation;
+				closestEdge = i;
+			}
+		}
+		if (maxSeparation < 0.0f)
+		{
+			// Feature id = chain vertex | polygon edge | 1
+			const Vector2 normal = -polygon.normals[closestEdge];
+			const uint32_t featureId = (static_cast<uint32_t>(vertexIndex & 0xFFFF) << 16) | (static_cast<uint32_t>(closestEdge & 0x7FFF) << 1) | 1u;
+			outContacts.emplace_back(vertex - polygon.normals[closestEdge] * maxSeparation, vertex, normal, -maxSeparation, featureId);
+		}
+	}
+	return outContacts.size() > contactCount;
+}
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "src/ECS/System.h"
 #include "src/ECS/Entity.h"
 
 
+#include "src/Physics/BroadPhase.h"
 #include "src/Physics/Contact.h"
+#include "src/Physics/PhysicsQuery.h"
 
 
 class EventManager;
@@ -16,15 +19,30 @@ struct ColliderTypeComponent;
 class CollisionSystem : public System
 {
 public:
-	CollisionSystem()
-	{
-		RequireComponent<ColliderTypeComponent>();
-		RequireComponent<TransformComponent>();
-	}
+	CollisionSystem();
 
+	// Compare the CollisionFilterComponent of both entities (category/mask bits and group index)
 	[[nodiscard]] static bool ShouldIgnoreCollision(Entity a, Entity b);
 
-	void Update(const std::shared_ptr<EventManager>& eventManager) const;
+	// Run the narrow phase on the candidate pairs of the broad phase.
+	// The proxies of bodies are moved by PhysicsEngine::UpdateColliderProperties(), only colliders without a RigidBody are moved here
+	void Update(const std::shared_ptr<EventManager>& eventManager);
+
+	// Swap the broad phase (DynamicAABBTree by default). The proxies of the current entities are moved to the new broad phase
+	void SetBroadPhase(std::unique_ptr<IBroadPhase> broadPhase);
+	// The broad phase can also be used for region queries and raycasts against the collider bounds
+	[[nodiscard]] IBroadPhase& GetBroadPhase() { return *m_broadPhase; }
+	[[nodiscard]] const IBroadPhase& GetBroadPhase() const { return *m_broadPhase; }
+	// Ray casts, circle casts and overlap queries against the actual collider shapes, on top of the broad phase
+	[[nodiscard]] const PhysicsQuery& GetQuery() const { return m_query; }
+	// Number of pairs reported by the broad phase in the last Update()
+	[[nodiscard]] size_t GetCandidatePairCount() const { return m_pairs.size(); }
+
+	// Continuous collision detection of a circle collider moving by displacement from its globalCenter, against the colliders that don't move during a physics step (static bodies and colliders without a RigidBody).
+	// Returns the fraction (0 - 1) of the displacement before the first impact, 1 if nothing is hit. outNormal is the surface normal at the impact
+	[[nodiscard]] float FindTimeOfImpact(const Entity& entity, const Vector2& displacement, Vector2& outNormal);
+	// Same for a circle that is not in the world (ex: the ghost ball of the TrajectorySystem), filtered like a collider. outOther is the collider that is hit first
+	[[nodiscard]] float FindTimeOfImpact(const Vector2& start, const float radius, const Vector2& displacement, const CollisionFilterComponent& filter, Vector2& outNormal, Entity& outOther);
 
 	static bool IsColliding(const Entity a, const Entity b, const ColliderTypeComponent& aType, const ColliderTypeComponent& bType, std::vector<Contact>& contacts);
 
@@ -34,6 +52,43 @@ public:
 	// Collision detection between box-box, polygon-polygon and box-polygon
 	static bool IsCollidingPolygonPolygon(const Entity a, const Entity b, std::vector<Contact>& outContacts);
 
-	// Collision detection between circle-polygon(or box)
+	// Collision detection between circle-polygon(or box). The contacts go from the polygon to the circle
 	static bool IsCollidingCirclePolygon(const Entity circleEntity, const Entity polygonEntity, std::vector<Contact>& outContacts);
+
+	// Collision detection between circle-chain. The contacts go from the chain ('a') to the circle ('b')
+	static bool IsCollidingCircleChain(const Entity circleEntity, const Entity chainEntity, std::vector<Contact>& outContacts);
+
+	// Collision detection between polygon(or box)-chain. The contacts go from the chain ('a') to the polygon ('b')
+	static bool IsCollidingPolygonChain(const Entity polygonEntity, const Entity chainEntity, std::vector<Contact>& outContacts);
+
+protected:
+	void OnEntityAdded(Entity entity) override;
+	void OnEntityRemoved(Entity entity) override;
+
+private:
+	// Static colliders (infinite mass and not kinematic, like terrain) never move, so their proxy is never updated
+	[[nodiscard]] static bool IsStaticCollider(const Entity& entity);
+	// The CollisionFilterComponent of the entity, or the default one
+	[[nodiscard]] static const CollisionFilterComponent& GetCollisionFilter(const Entity& entity);
+	void CreateProxy(const Entity& entity);
+	// Circle or polygon against a chain, the contacts go from the chain to the other collider
+	static bool IsCollidingWithChain(const Entity other, const ColliderTypeComponent& otherType, const Entity chainEntity, std::vector<Contact>& outContacts);
+
+	// The proxy id of each entity is stored in its ColliderTypeComponent
+	std::unique_ptr<IBroadPhase> m_broadPhase;
+	// Follows the current broad phase
+	PhysicsQuery m_query;
+
+	// Candidate pairs reported by the broad phase, kept between frames to reuse the memory
+	std::vector<BroadPhasePair> m_pairs;
+	// Colliders overlapping the swept bounds of FindTimeOfImpact(), kept to reuse the memory
+	std::vector<Entity> m_sweepCandidates;
+
+	struct NarrowPhaseResult
+	{
+		bool isColliding = false;
+		std::vector<Contact> contacts;
+	};
+	// [Vector index = pair index], kept between frames to reuse the memory of the contacts
+	std::vector<NarrowPhaseResult> m_narrowPhaseResults;
 };
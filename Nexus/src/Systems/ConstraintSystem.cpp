@@ -3,6 +3,8 @@
 #include "ConstraintSystem.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "src/ECS/Entity.h"
 #include "src/ECS/Coordinator.h"
@@ -13,7 +15,9 @@
 #include "src/Components/TransformComponent.h"
 #include "src/Components/JointConstraintComponent.h"
 #include "src/Components/ConstraintTypeComponent.h"
+#include "src/Physics/Constants.h"
 #include "src/Physics/PenetrationConstraint.h"
+#include "src/Utils/JobSystem.h"
 
 void ConstraintSystem::InitializeLocalCoordinates() const
 {
@@ -36,9 +40,15 @@ void ConstraintSystem::InitializeLocalCoordinates() const
 // Subscribe to collision events
 void ConstraintSystem::SubscribeToEvents(const std::shared_ptr<EventManager>& eventManager)
 {
-	using CallbackType = std::function<void(ConstraintSystem*, CollisionEvent&)>;
-	const CallbackType callback = [this](auto&&, auto&& placeholder2) { onCollision(std::forward<decltype(placeholder2)>(placeholder2)); };
-	eventManager->SubscribeToEvent<CollisionEvent>(this, callback);
+	eventManager->SubscribeToEventBatch<CollisionEvent, &ConstraintSystem::OnCollisions>(this);
+}
+
+void ConstraintSystem::OnCollisions(const std::vector<CollisionEvent>& events)
+{
+	for (const auto& event : events)
+	{
+		onCollision(event);
+	}
 }
 
 void ConstraintSystem::onCollision(const CollisionEvent& event)
@@ -50,7 +60,8 @@ void ConstraintSystem::onCollision(const CollisionEvent& event)
 			event.b,
 			contact.startContactPoint,
 			contact.endContactPoint,
-			contact.collisionNormal
+			contact.collisionNormal,
+			contact.featureId
 		);
 	}
 }
@@ -59,16 +70,21 @@ void ConstraintSystem::onCollision(const CollisionEvent& event)
 void ConstraintSystem::Update(const float deltaTime)
 {
 	// Logger::Log("ConstraintSystem::Update GetPenetrationSize: " + std::to_string(GetPenetrationSize()));
-	PreSolve(deltaTime);
-	PreSolvePenetration(deltaTime);
+	BuildIslands();
 
-	// Iterate multiple times for better constraint resolution
-	for (int i = 0; i < 8; i++)
+	// The islands are independent, each one is solved as a whole on a single thread
+	JobSystem::ParallelFor(m_islands.size(), 1, [this, deltaTime](const size_t begin, const size_t end)
 	{
-		Solve();
-		SolvePenetration();
-	}
+		for (size_t i = begin; i < end; i++)
+		{
+			SolveIsland(m_islands[i], deltaTime);
+		}
+	});
+
+	UpdateSleeping(deltaTime);
 
+	// Keep the accumulated impulses to warm start the same contacts in the next frame
+	CacheContacts();
 	ClearPenetrations();
 }
 
@@ -86,77 +102,74 @@ void ConstraintSystem::PreSolve(const float deltaTime)
 		if (constraintType.type != ConstrainType::JOINT)
 			continue;
 
-		auto& jointComponent = entity.GetComponent<JointConstraintComponent>();
-		const auto& entityA = jointComponent.a;
-		const auto& entityB = jointComponent.b;
-
-		// Ensure connected entities have rigid body components so that we can use the inverse mass for constraint
-		if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
-			continue;
-
-		auto& transformA = entityA.GetComponent<TransformComponent>();
-		auto& transformB = entityB.GetComponent<TransformComponent>();
-		auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
-		auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
-
-		// Anchor point position in the world space
-		const Vector2 anchorAWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, jointComponent.anchorPointForA);
-		const Vector2 anchorBWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformB, jointComponent.anchorPointForB);
-
-		const Vector2 rA = anchorAWorld - transformA.position; // Distance between the anchor point and the center of mass of the entity
-		const Vector2 rB = anchorBWorld - transformB.position; // Distance between the anchor point and the center of mass of the entity
-
-		//---------------------------------------------
-		// Compute Jacobian matrix for constraint resolution
-		// First derivative of constrain = Jacobian matrix * velocity vector
-		// Where, Jacobian Matrix = [2(ra-rb), 2( ra(vector) x (ra - rb) ), 2(rb-ra), 2( rb(vector) x (rb - ra) )]
-		// And, velocity vector = PhysicsEngine::GetVelocitiesVector()
-		jointComponent.jacobian.Zero();
-
-		const Vector2 linearA = (anchorAWorld - anchorBWorld) * 2.0f;
-		jointComponent.jacobian.rowVectors[0][0] = linearA.x;
-		jointComponent.jacobian.rowVectors[0][1] = linearA.y;
-		jointComponent.jacobian.rowVectors[0][2] = rA.Cross(anchorAWorld - anchorBWorld) * 2.0f; // Angular A
-
-		const Vector2 linearB = (anchorBWorld - anchorAWorld) * 2.0f;
-		jointComponent.jacobian.rowVectors[0][3] = linearB.x;
-		jointComponent.jacobian.rowVectors[0][4] = linearB.y;
-		jointComponent.jacobian.rowVectors[0][5] = rB.Cross(anchorBWorld - anchorAWorld) * 2.0f;  // Angular B
-
-		const Matrix jacobianTranspose = jointComponent.jacobian.Transpose();
-
-		//---------------------------------------------
-		// Warm-starting: Apply cached impulses
-		VectorN cachedImpulses = jacobianTranspose * jointComponent.cachedLambda;
-
-		// Since impulses(lambda) = 
-		//  [ jacobianLinearA.x ]
-		//  [ jacobianLinearA.y ]
-		//  [ jacobianAngularA   ]
-		//  [ jacobianLinearB.x ]
-		//  [ jacobianLinearB.y ]
-		//  [ jacobianAngularB  ]
-		if (!rigidbodyA.isKinematic)
-		{
-			rigidbodyA.ApplyImpulseLinear(Vector2(cachedImpulses[0], cachedImpulses[1]));	// A linear impulse
-			rigidbodyA.ApplyImpulseAngular(cachedImpulses[2]);										// A angular impulse
-
-		}
-		if (!rigidbodyB.isKinematic)
-		{
-			rigidbodyB.ApplyImpulseLinear(Vector2(cachedImpulses[3], cachedImpulses[4]));	// B linear impulse
-			rigidbodyB.ApplyImpulseAngular(cachedImpulses[5]);										// B angular impulse
-		}
-
-		// Baumgarte stabilization(bias) for position error correction
-		constexpr float positionErrorThreshold = 0.01f;
-		constexpr float beta = 0.2f;
-		float positionError = (anchorBWorld - anchorAWorld).Dot(anchorBWorld - anchorAWorld);
-		positionError = std::max(0.0f, positionError - positionErrorThreshold); // To make sure that the positionalError is within limits
-		jointComponent.bias = (beta / deltaTime) * positionError;
+		PreSolveJoint(entity.GetComponent<JointConstraintComponent>(), deltaTime);
 	}
 }
 
+void ConstraintSystem::PreSolveJoint(JointConstraintComponent& jointComponent, const float deltaTime)
+{
+	const auto& entityA = jointComponent.a;
+	const auto& entityB = jointComponent.b;
+	jointComponent.rigidBodyA = nullptr;
+	jointComponent.rigidBodyB = nullptr;
+
+	// Skip the joints whose entities were killed, their ids may belong to other entities by now
+	if (!entityA.IsAlive() || !entityB.IsAlive())
+		return;
+
+	// Ensure connected entities have rigid body components so that we can use the inverse mass for constraint
+	if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
+		return;
+
+	auto& transformA = entityA.GetComponent<TransformComponent>();
+	auto& transformB = entityB.GetComponent<TransformComponent>();
+	auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
+	auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
+
+	// Skip the constraints of sleeping islands
+	if (!IsConstraintAwake(rigidbodyA, rigidbodyB))
+		return;
+
+	// Solve() reads the bodies directly, nothing is added or removed during the step
+	jointComponent.rigidBodyA = &rigidbodyA;
+	jointComponent.rigidBodyB = &rigidbodyB;
+
+	// Anchor point position in the world space
+	const Vector2 anchorAWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, jointComponent.anchorPointForA);
+	const Vector2 anchorBWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformB, jointComponent.anchorPointForB);
+
+	const Vector2 rA = anchorAWorld - transformA.position; // Distance between the anchor point and the center of mass of the entity
+	const Vector2 rB = anchorBWorld - transformB.position; // Distance between the anchor point and the center of mass of the entity
+
+	//---------------------------------------------
+	// Compute Jacobian matrix for constraint resolution
+	// First derivative of constrain = Jacobian matrix * velocity vector
+	// Where, Jacobian Matrix = [2(ra-rb), 2( ra(vector) x (ra - rb) ), 2(rb-ra), 2( rb(vector) x (rb - ra) )]
+	// And, velocity vector = [va, ωa, vb, ωb]. Only the linear part of B is stored, the one of A is its opposite
+	jointComponent.jacobianLinear = (anchorBWorld - anchorAWorld) * 2.0f;
+	jointComponent.jacobianAngularA = rA.Cross(anchorAWorld - anchorBWorld) * 2.0f;
+	jointComponent.jacobianAngularB = rB.Cross(anchorBWorld - anchorAWorld) * 2.0f;
+
+	//---------------------------------------------
+	// Effective mass = 1 / (J M^-1 JT). M^-1 is diagonal (1/ma, 1/ma, 1/Ia, 1/mb, 1/mb, 1/Ib), so J M^-1 JT is a sum of squares
+	const float inverseEffectiveMass =
+		(rigidbodyA.inverseOfMass + rigidbodyB.inverseOfMass) * jointComponent.jacobianLinear.MagnitudeSquared() +
+		rigidbodyA.inverseOfAngularMass * jointComponent.jacobianAngularA * jointComponent.jacobianAngularA +
+		rigidbodyB.inverseOfAngularMass * jointComponent.jacobianAngularB * jointComponent.jacobianAngularB;
+	jointComponent.effectiveMass = inverseEffectiveMass > 0.0f ? 1.0f / inverseEffectiveMass : 0.0f;
+
+	//---------------------------------------------
+	// Warm-starting: Apply cached impulses (JT * lambda)
+	ApplyJointImpulse(jointComponent, jointComponent.cachedLambda);
+
+	// Baumgarte stabilization(bias) for position error correction
+	constexpr float positionErrorThreshold = 0.01f;
+	constexpr float beta = 0.2f;
+	float positionError = (anchorBWorld - anchorAWorld).Dot(anchorBWorld - anchorAWorld);
+	positionError = std::max(0.0f, positionError - positionErrorThreshold); // To make sure that the positionalError is within limits
+	jointComponent.bias = (beta / deltaTime) * positionError;
+}
+
 // Resolve constraints for the system
 void ConstraintSystem::Solve()
 {
@@ -172,227 +185,478 @@ void ConstraintSystem::Solve()
 		if (constraintType.type != ConstrainType::JOINT)
 			continue;
 
-		auto& jointComponent = entity.GetComponent<JointConstraintComponent>();
-		const auto& entityA = jointComponent.a;
-		const auto& entityB = jointComponent.b;
-
-		// The connected entities should have rigidbody component so that we can use the inverse mass for constraint
-		if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
-			continue;
-
-		auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
-		auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
-
-		// Calculate velocities and inverse mass matrix
-		const VectorN velocities = PhysicsEngine::GetVelocitiesVector(rigidbodyA, rigidbodyB);
-		const Matrix inverseMassMatrix = PhysicsEngine::GetInverseMassMatrix(rigidbodyA, rigidbodyB);
+		SolveJoint(entity.GetComponent<JointConstraintComponent>());
+	}
+}
 
-		//---------------------------------------------
-		// Calculate lambda (constraint impulses)
-		// lambda = -(J V + b) / (J M^-1 JT) or,
-		// lambda = -(Jacobian Matrix * VelocitiesVector + bias) / (Jacobian Matrix * InverseMass Matrix * Jacobian Matrix transpose)
+void ConstraintSystem::SolveJoint(JointConstraintComponent& jointComponent)
+{
+	// Skipped by PreSolveJoint()
+	if (!jointComponent.rigidBodyA)
+		return;
+
+	const RigidBodyComponent& rigidbodyA = *jointComponent.rigidBodyA;
+	const RigidBodyComponent& rigidbodyB = *jointComponent.rigidBodyB;
+
+	//---------------------------------------------
+	// Calculate lambda (constraint impulses)
+	// lambda = -(J V + b) / (J M^-1 JT) or,
+	// lambda = -(Jacobian Matrix * VelocitiesVector + bias) * effective mass
+	const float jacobianVelocity =
+		jointComponent.jacobianLinear.Dot(rigidbodyB.velocity - rigidbodyA.velocity) +
+		jointComponent.jacobianAngularA * rigidbodyA.angularVelocity +
+		jointComponent.jacobianAngularB * rigidbodyB.angularVelocity;
+	const float lambda = -(jacobianVelocity + jointComponent.bias) * jointComponent.effectiveMass;
+	jointComponent.cachedLambda += lambda;
+
+	ApplyJointImpulse(jointComponent, lambda);
+}
 
-		VectorN numerator = jointComponent.jacobian * velocities * -1.0f;
-		numerator[0] -= jointComponent.bias;
+void ConstraintSystem::ApplyJointImpulse(const JointConstraintComponent& jointComponent, const float lambda)
+{
+	// Impulses = JT * lambda
+	if (!jointComponent.rigidBodyA->isKinematic)
+	{
+		jointComponent.rigidBodyA->ApplyImpulseLinear(jointComponent.jacobianLinear * -lambda);		// A linear impulse
+		jointComponent.rigidBodyA->ApplyImpulseAngular(jointComponent.jacobianAngularA * lambda);	// A angular impulse
+	}
+	if (!jointComponent.rigidBodyB->isKinematic)
+	{
+		jointComponent.rigidBodyB->ApplyImpulseLinear(jointComponent.jacobianLinear * lambda);		// B linear impulse
+		jointComponent.rigidBodyB->ApplyImpulseAngular(jointComponent.jacobianAngularB * lambda);	// B angular impulse
+	}
+}
 
-		const Matrix jacobianTranspose = jointComponent.jacobian.Transpose();
-		Matrix denominator = jointComponent.jacobian * inverseMassMatrix * jacobianTranspose;
+void ConstraintSystem::PreSolvePenetration(const float deltaTime)
+{
+	for (auto& penetration : m_penetrations)
+	{
+		PreSolvePenetration(penetration, deltaTime);
+	}
+}
 
-		// lambda = num/deno => lambda * denominator = numerator.
-		// Since this is of the form Ax = B solving using Gauss-Seidel method
-		VectorN lambda = Matrix::SolveGaussSeidel(denominator, numerator);
-		jointComponent.cachedLambda += lambda;
+void ConstraintSystem::PreSolvePenetration(PenetrationConstraint& penetration, const float deltaTime)
+{
+	const Entity& entityA = penetration.a;
+	const Entity& entityB = penetration.b;
+	penetration.rigidBodyA = nullptr;
+	penetration.rigidBodyB = nullptr;
+
+	// Ensure connected entities have rigid body components so that we can use the inverse mass for constraint
+	if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
+		return;
+
+	auto& transformA = entityA.GetComponent<TransformComponent>();
+	auto& transformB = entityB.GetComponent<TransformComponent>();
+	auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
+	auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
+
+	// Skip the constraints of sleeping islands
+	if (!IsConstraintAwake(rigidbodyA, rigidbodyB))
+		return;
+
+	// Solve() reads the bodies directly, nothing is added or removed during the step
+	penetration.rigidBodyA = &rigidbodyA;
+	penetration.rigidBodyB = &rigidbodyB;
+
+	// Collision point position in the world space
+	const Vector2 collisionAWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, penetration.aCollisionPoint);
+	const Vector2 collisionBWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformB, penetration.bCollisionPoint);
+	const Vector2 normalWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, penetration.collisionNormal);
+
+	const Vector2 rA = collisionAWorld - transformA.position; // Distance between the anchor point and the center of mass of the entity
+	const Vector2 rB = collisionBWorld - transformB.position; // Distance between the anchor point and the center of mass of the entity
+
+	//---------------------------------------------
+	// First derivative of constrain = Jacobian matrix * velocity vector
+	// The Jacobian Matrix is
+	//  [ -normal   -( ra(vector)x normal)      normal      ( rb(vector) x normal)     ]
+	//  [ -tangent  -( ra(vector)x tangent)     tangent     ( rb(vector) x tangent)    ]
+	// And, velocity vector = [va, ωa, vb, ωb]. Only the normal, the tangent and the cross products are stored
+	penetration.normal = normalWorld;
+	penetration.rACrossNormal = rA.Cross(normalWorld);
+	penetration.rBCrossNormal = rB.Cross(normalWorld);
+
+	// Second row: Impulses along the tangent (friction)
+	penetration.friction = std::max(rigidbodyA.friction, rigidbodyB.friction);
+	penetration.tangent = penetration.friction > 0.0f ? normalWorld.Normal() : Vector2();
+	penetration.rACrossTangent = rA.Cross(penetration.tangent);
+	penetration.rBCrossTangent = rB.Cross(penetration.tangent);
+
+	//---------------------------------------------
+	// K = J M^-1 JT, a 2x2 block. M^-1 is diagonal (1/ma, 1/ma, 1/Ia, 1/mb, 1/mb, 1/Ib) and the normal is perpendicular to the tangent, so:
+	//  K[0][0] = 1/ma + 1/mb + (ra x n)^2 / Ia + (rb x n)^2 / Ib
+	//  K[1][1] = (1/ma + 1/mb) |t|^2 + (ra x t)^2 / Ia + (rb x t)^2 / Ib
+	//  K[0][1] = (ra x n)(ra x t) / Ia + (rb x n)(rb x t) / Ib
+	const float inverseMassSum = rigidbodyA.inverseOfMass + rigidbodyB.inverseOfMass;
+	const float normalK = inverseMassSum * normalWorld.MagnitudeSquared() +
+		rigidbodyA.inverseOfAngularMass * penetration.rACrossNormal * penetration.rACrossNormal +
+		rigidbodyB.inverseOfAngularMass * penetration.rBCrossNormal * penetration.rBCrossNormal;
+	const float tangentK = inverseMassSum * penetration.tangent.MagnitudeSquared() +
+		rigidbodyA.inverseOfAngularMass * penetration.rACrossTangent * penetration.rACrossTangent +
+		rigidbodyB.inverseOfAngularMass * penetration.rBCrossTangent * penetration.rBCrossTangent;
+	penetration.normalMass = normalK > 0.0f ? 1.0f / normalK : 0.0f;
+	penetration.tangentMass = tangentK > 0.0f ? 1.0f / tangentK : 0.0f;
+	penetration.coupling =
+		rigidbodyA.inverseOfAngularMass * penetration.rACrossNormal * penetration.rACrossTangent +
+		rigidbodyB.inverseOfAngularMass * penetration.rBCrossNormal * penetration.rBCrossTangent;
+
+	//---------------------------------------------
+	// Warm-starting: Apply cached impulses (JT * lambda)
+	ApplyPenetrationImpulse(penetration, penetration.cachedLambda[0], penetration.cachedLambda[1]);
+
+	//---------------------------------------------
+	// Baumgarte stabilization(bias) for position error
+	// bias = (beta / deltaTime) * positionCorrection + (elasticity * vRelDotNormal)
+	constexpr float positionErrorThreshold = 0.01f;
+	constexpr float beta = 0.2f;
+	float positionCorrection = (collisionBWorld - collisionAWorld).Dot(-normalWorld);
+	positionCorrection = std::min(0.0f, positionCorrection + positionErrorThreshold);
+
+	// Calculate relative velocity pre-impulse normal to compute elasticity
+	Vector2 velocityA = rigidbodyA.velocity + (Vector2(-rigidbodyA.angularVelocity * rA.y, rigidbodyA.angularVelocity * rA.x));
+	Vector2 velocityB = rigidbodyB.velocity + (Vector2(-rigidbodyB.angularVelocity * rB.y, rigidbodyB.angularVelocity * rB.x));
+	float vRelDotNormal = (velocityA - velocityB).Dot(normalWorld);
+
+	// Coefficient of restitution between two bodies
+	float e = std::min(rigidbodyA.restitution, rigidbodyB.restitution);
+
+	// Bias w.r.t. elasticity(restitution)
+	penetration.bias = (beta / deltaTime) * positionCorrection + (e * vRelDotNormal);
+}
 
-		// Computing impulses with direction and magnitude
-		VectorN impulses = jacobianTranspose * lambda;
+void ConstraintSystem::SolvePenetration()
+{
+	for (auto& penetration : m_penetrations)
+	{
+		SolvePenetration(penetration);
+	}
+}
 
-		//---------------------------------------------
-		// Applying impulses to both A and B
-		if (!rigidbodyA.isKinematic)
-		{
-			rigidbodyA.ApplyImpulseLinear(Vector2(impulses[0], impulses[1])); // A linear impulse
-			rigidbodyA.ApplyImpulseAngular(impulses[2]);								// A angular impulse
+void ConstraintSystem::SolvePenetration(PenetrationConstraint& penetration)
+{
+	// Skipped by PreSolvePenetration()
+	if (!penetration.rigidBodyA)
+		return;
+
+	const RigidBodyComponent& rigidbodyA = *penetration.rigidBodyA;
+	const RigidBodyComponent& rigidbodyB = *penetration.rigidBodyB;
+
+	// Relative velocity along each row, J V
+	const Vector2 relativeVelocity = rigidbodyB.velocity - rigidbodyA.velocity;
+	const float normalVelocity = penetration.normal.Dot(relativeVelocity) +
+		penetration.rBCrossNormal * rigidbodyB.angularVelocity - penetration.rACrossNormal * rigidbodyA.angularVelocity;
+	const float tangentVelocity = penetration.tangent.Dot(relativeVelocity) +
+		penetration.rBCrossTangent * rigidbodyB.angularVelocity - penetration.rACrossTangent * rigidbodyA.angularVelocity;
+
+	// Calculate lambda (constraint impulses)
+	// lambda * (J M^-1 JT) = -(J V + b), solved with two Gauss-Seidel sweeps over the 2x2 block
+	const float normalTarget = -normalVelocity - penetration.bias;
+	const float tangentTarget = -tangentVelocity;
+	float normalLambda = normalTarget * penetration.normalMass;
+	float tangentLambda = (tangentTarget - penetration.coupling * normalLambda) * penetration.tangentMass;
+	normalLambda = (normalTarget - penetration.coupling * tangentLambda) * penetration.normalMass;
+	tangentLambda = (tangentTarget - penetration.coupling * normalLambda) * penetration.tangentMass;
+
+	// Accumulate impulses and clamp it within constraint limits. The cachedLambda will be used by PreSolve
+	const Vec<2> oldLambda = penetration.cachedLambda;
+	penetration.cachedLambda[0] = std::max(0.0f, oldLambda[0] + normalLambda);
+	penetration.cachedLambda[1] = oldLambda[1] + tangentLambda;
+
+	// Friction should be between -(μ * λn) and (μ * λn), where λn is impulse along normal
+	if (penetration.friction > 0.0f)
+	{
+		const float maxFriction = penetration.cachedLambda[0] * penetration.friction;
+		penetration.cachedLambda[1] = std::clamp(penetration.cachedLambda[1], -maxFriction, maxFriction);
+	}
 
-		}
-		if (!rigidbodyB.isKinematic)
-		{
-			rigidbodyB.ApplyImpulseLinear(Vector2(impulses[3], impulses[4])); // B linear impulse
-			rigidbodyB.ApplyImpulseAngular(impulses[5]);								// B angular impulse
-		}
-		// Logger::Warn("Impulse Linear A: " + Vector2(impulses[0], impulses[1]).ToString());
-		// Logger::Warn("Impulse Angular A: " + std::to_string(impulses[2]));
-		// Logger::Warn("Impulse Linear B: " + Vector2(impulses[3], impulses[4]).ToString());
-		// Logger::Warn("Impulse Angular B: " + std::to_string(impulses[5]));
+	ApplyPenetrationImpulse(penetration, penetration.cachedLambda[0] - oldLambda[0], penetration.cachedLambda[1] - oldLambda[1]);
+}
 
+void ConstraintSystem::ApplyPenetrationImpulse(const PenetrationConstraint& penetration, const float normalLambda, const float tangentLambda)
+{
+	// Impulses = JT * lambda
+	const Vector2 linearImpulse = penetration.normal * normalLambda + penetration.tangent * tangentLambda;
+	if (!penetration.rigidBodyA->isKinematic)
+	{
+		penetration.rigidBodyA->ApplyImpulseLinear(-linearImpulse);	// A linear impulse
+		penetration.rigidBodyA->ApplyImpulseAngular(-(penetration.rACrossNormal * normalLambda + penetration.rACrossTangent * tangentLambda));	// A angular impulse
+	}
+	if (!penetration.rigidBodyB->isKinematic)
+	{
+		penetration.rigidBodyB->ApplyImpulseLinear(linearImpulse);	// B linear impulse
+		penetration.rigidBodyB->ApplyImpulseAngular(penetration.rBCrossNormal * normalLambda + penetration.rBCrossTangent * tangentLambda);	// B angular impulse
 	}
 }
 
-void ConstraintSystem::PreSolvePenetration(const float deltaTime)
+bool ConstraintSystem::IsDynamic(const RigidBodyComponent& rigidBody)
 {
+	return !rigidBody.isKinematic && !rigidBody.IsStatic();
+}
 
-	for (auto& penetration : m_penetrations)
-	{
-		const Entity& entityA = penetration.a;
-		const Entity& entityB = penetration.b;
+bool ConstraintSystem::IsConstraintAwake(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB)
+{
+	return (IsDynamic(rigidBodyA) && rigidBodyA.isAwake) || (IsDynamic(rigidBodyB) && rigidBodyB.isAwake);
+}
 
-		// Ensure connected entities have rigid body components so that we can use the inverse mass for constraint
-		if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
+void ConstraintSystem::BuildIslands()
+{
+	// Every dynamic body starts as its own island
+	m_bodies.clear();
+	for (auto [entity, rigidBody] : GetCoordinator().View<RigidBodyComponent>())
+	{
+		if (!IsDynamic(rigidBody))
 			continue;
 
-		auto& transformA = entityA.GetComponent<TransformComponent>();
-		auto& transformB = entityB.GetComponent<TransformComponent>();
-		auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
-		auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
-
-		// Collision point position in the world space
-		const Vector2 collisionAWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, penetration.aCollisionPoint);
-		const Vector2 collisionBWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformB, penetration.bCollisionPoint);
-		Vector2 normalWorld = PhysicsEngine::LocalSpaceToWorldSpace(transformA, penetration.collisionNormal);
-
-		const Vector2 rA = collisionAWorld - transformA.position; // Distance between the anchor point and the center of mass of the entity
-		const Vector2 rB = collisionBWorld - transformB.position; // Distance between the anchor point and the center of mass of the entity
-
-		//---------------------------------------------
-		// First derivative of constrain = Jacobian matrix * velocity vector
-		// Compute Jacobian matrix for constraint resolution
-		// The Jacobian Matrix is
-		//  [ -normal   -2( ra(vector)x normal)      normal      2( rb(vector) x normal)     ]
-		//  [ -tangent  -2( ra(vector)x tangent)     tangent     2( rb(vector) x tangent)    ]
-		// And, velocity vector = PhysicsEngine::GetVelocitiesVector()
-		penetration.jacobian.Zero();
-
-		// Populating first row: Impulses along the normal
-		penetration.jacobian.rowVectors[0][0] = -normalWorld.x;			// Linear A
-		penetration.jacobian.rowVectors[0][1] = -normalWorld.y;			// Linear A
-		penetration.jacobian.rowVectors[0][2] = -rA.Cross(normalWorld); // Angular A
-
-		penetration.jacobian.rowVectors[0][3] = normalWorld.x;			// Linear B
-		penetration.jacobian.rowVectors[0][4] = normalWorld.y;			// Linear B
-		penetration.jacobian.rowVectors[0][5] = rB.Cross(normalWorld);  // Angular B
-
-		// Populating second row: Impulses along the tangent (friction)
-		penetration.friction = std::max(rigidbodyA.friction, rigidbodyB.friction);
-		if (penetration.friction > 0.0)
+		const size_t entityId = entity.GetId();
+		if (entityId >= m_islandParent.size())
 		{
-			Vector2 tangent = normalWorld.Normal();
-			penetration.jacobian.rowVectors[1][0] = -tangent.x;
-			penetration.jacobian.rowVectors[1][1] = -tangent.y;
-			penetration.jacobian.rowVectors[1][2] = -rA.Cross(tangent);
-			penetration.jacobian.rowVectors[1][3] = tangent.x;
-			penetration.jacobian.rowVectors[1][4] = tangent.y;
-			penetration.jacobian.rowVectors[1][5] = rB.Cross(tangent);
+			m_islandParent.resize(entityId + 1);
+			m_isIslandAwake.resize(entityId + 1);
+			m_islandSleepTime.resize(entityId + 1);
 		}
+		m_islandParent[entityId] = entityId;
+		m_isIslandAwake[entityId] = false;
+		m_bodies.push_back(entity);
+	}
 
-		const Matrix jacobianTranspose = penetration.jacobian.Transpose();
+	// An island is awake if any of its bodies is awake
+	for (const auto& body : m_bodies)
+	{
+		if (body.GetComponent<RigidBodyComponent>().isAwake)
+		{
+			m_isIslandAwake[body.GetId()] = true;
+		}
+	}
 
-		//---------------------------------------------
-		// Warm-starting: Apply cached impulses
-		VectorN cachedImpulses = jacobianTranspose * penetration.cachedLambda;
+	// Merge the islands connected by a penetration or a joint. Static and kinematic bodies don't connect islands (a body resting on the terrain doesn't join every other body on the terrain)
+	for (const auto& penetration : m_penetrations)
+	{
+		LinkBodies(penetration.a, penetration.b);
+	}
+	for (const auto& entity : GetSystemEntities())
+	{
+		if (entity.GetComponent<ConstraintTypeComponent>().type == ConstrainType::JOINT)
+		{
+			const auto& jointComponent = entity.GetComponent<JointConstraintComponent>();
+			LinkBodies(jointComponent.a, jointComponent.b);
+		}
+	}
+
+	// Wake up every body of an awake island (ex: an awake body landed on a sleeping stack)
+	m_islandCount = 0;
+	for (const auto& body : m_bodies)
+	{
+		const size_t root = FindIslandRoot(body.GetId());
+		if (root == body.GetId())
+		{
+			m_islandCount++;
+		}
 
-		// Since impulses(lambda) = 
-		//  [ jacobianLinearA  ]
-		//  [ jacobianAngularA ]
-		//  [ jacobianLinearB  ]
-		//  [ jacobianAngularB ]
-		// Apply impulses to bodies
-		if (!rigidbodyA.isKinematic)
+		auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		if (m_isIslandAwake[root] && !rigidBody.isAwake)
 		{
-			rigidbodyA.ApplyImpulseLinear(Vector2(cachedImpulses[0], cachedImpulses[1]));	// A linear impulse
-			rigidbodyA.ApplyImpulseAngular(cachedImpulses[2]);										// A angular impulse
+			rigidBody.SetAwake(true);
 		}
-		if (!rigidbodyB.isKinematic)
+	}
+
+	GroupConstraintsByIsland();
+}
+
+void ConstraintSystem::GroupConstraintsByIsland()
+{
+	// Number the awake islands in the order of their bodies, so the order doesn't depend on the threads
+	m_islands.clear();
+	if (m_islandIndex.size() < m_islandParent.size())
+	{
+		m_islandIndex.resize(m_islandParent.size());
+	}
+	for (const auto& body : m_bodies)
+	{
+		const size_t entityId = body.GetId();
+		if (FindIslandRoot(entityId) == entityId && m_isIslandAwake[entityId])
 		{
-			rigidbodyB.ApplyImpulseLinear(Vector2(cachedImpulses[3], cachedImpulses[4]));	// B linear impulse
-			rigidbodyB.ApplyImpulseAngular(cachedImpulses[5]);										// B angular impulse
+			m_islandIndex[entityId] = m_islands.size();
+			m_islands.push_back({ 0, 0, 0, 0 });
 		}
+	}
 
-		//---------------------------------------------
-		// Baumgarte stabilization(bias) for position error
-		// bias = (beta / deltaTime) * positionCorrection + (elasticity * vRelDotNormal)
-		constexpr float positionErrorThreshold = 0.01f;
-		constexpr float beta = 0.2f;
-		float positionCorrection = (collisionBWorld - collisionAWorld).Dot(-normalWorld);
-		positionCorrection = std::min(0.0f, positionCorrection + positionErrorThreshold);
+	// Island of a constraint = island of its dynamic body (static and kinematic bodies aren't part of any island)
+	auto getIsland = [this](const Entity& a, const Entity& b)
+	{
+		const Entity& dynamicBody = IsDynamic(a.GetComponent<RigidBodyComponent>()) ? a : b;
+		return m_islandIndex[FindIslandRoot(dynamicBody.GetId())];
+	};
 
-		// Calculate relative velocity pre-impulse normal to compute elasticity
-		Vector2 velocityA = rigidbodyA.velocity + (Vector2(-rigidbodyA.angularVelocity * rA.y, rigidbodyA.angularVelocity * rA.x));
-		Vector2 velocityB = rigidbodyB.velocity + (Vector2(-rigidbodyB.angularVelocity * rB.y, rigidbodyB.angularVelocity * rB.x));
-		float vRelDotNormal = (velocityA - velocityB).Dot(normalWorld);
+	// Collect the constraints that will be solved, in the same order as PreSolve() and PreSolvePenetration()
+	m_awakeJoints.clear();
+	m_jointIslands.clear();
+	for (const auto& entity : GetSystemEntities())
+	{
+		if (entity.GetComponent<ConstraintTypeComponent>().type != ConstrainType::JOINT)
+			continue;
 
-		// Coefficient of restitution between two bodies
-		float e = std::min(rigidbodyA.restitution, rigidbodyB.restitution);
+		auto& jointComponent = entity.GetComponent<JointConstraintComponent>();
+		if (!jointComponent.a.IsAlive() || !jointComponent.b.IsAlive())
+			continue;
+		if (!jointComponent.a.HasComponent<RigidBodyComponent>() || !jointComponent.b.HasComponent<RigidBodyComponent>())
+			continue;
+		if (!IsConstraintAwake(jointComponent.a.GetComponent<RigidBodyComponent>(), jointComponent.b.GetComponent<RigidBodyComponent>()))
+			continue;
 
-		// Bias w.r.t. elasticity(restitution)
-		penetration.bias = (beta / deltaTime) * positionCorrection + (e * vRelDotNormal);
+		m_awakeJoints.push_back(&jointComponent);
+		m_jointIslands.push_back(getIsland(jointComponent.a, jointComponent.b));
 	}
-}
 
-void ConstraintSystem::SolvePenetration()
-{
-	// TODO: resolve constrains for non-kinematic bodies
+	m_awakePenetrations.clear();
+	m_penetrationIslands.clear();
 	for (auto& penetration : m_penetrations)
 	{
-		const Entity& entityA = penetration.a;
-		const Entity& entityB = penetration.b;
-
-		// Ensure connected entities have rigid body components so that we can use the inverse mass for constraint
-		if (!entityA.HasComponent<RigidBodyComponent>() || !entityB.HasComponent<RigidBodyComponent>())
+		if (!penetration.a.HasComponent<RigidBodyComponent>() || !penetration.b.HasComponent<RigidBodyComponent>())
+			continue;
+		if (!IsConstraintAwake(penetration.a.GetComponent<RigidBodyComponent>(), penetration.b.GetComponent<RigidBodyComponent>()))
 			continue;
 
-		auto& rigidbodyA = entityA.GetComponent<RigidBodyComponent>();
-		auto& rigidbodyB = entityB.GetComponent<RigidBodyComponent>();
+		m_awakePenetrations.push_back(&penetration);
+		m_penetrationIslands.push_back(getIsland(penetration.a, penetration.b));
+	}
 
-		// Calculate velocities and inverse mass matrix
-		const VectorN velocities = PhysicsEngine::GetVelocitiesVector(rigidbodyA, rigidbodyB);
-		const Matrix inverseMassMatrix = PhysicsEngine::GetInverseMassMatrix(rigidbodyA, rigidbodyB);
+	// Counting sort by island. It is stable, so the constraints of an island keep their relative order
+	for (const size_t islandIndex : m_jointIslands)
+		m_islands[islandIndex].jointEnd++;
+	for (const size_t islandIndex : m_penetrationIslands)
+		m_islands[islandIndex].penetrationEnd++;
 
-		// Calculate lambda (constraint impulses)
-		// lambda = -(J V + b) / (J M^-1 JT) or,
-		// lambda = -(Jacobian Matrix * VelocitiesVector + bias) / (Jacobian Matrix * InverseMass Matrix * Jacobian Matrix transpose)
+	size_t jointOffset = 0;
+	size_t penetrationOffset = 0;
+	for (auto& island : m_islands)
+	{
+		island.jointBegin = jointOffset;
+		jointOffset += island.jointEnd;
+		island.jointEnd = island.jointBegin;
 
-		VectorN numerator = penetration.jacobian * velocities * -1.0f;
-		numerator[0] -= penetration.bias;
+		island.penetrationBegin = penetrationOffset;
+		penetrationOffset += island.penetrationEnd;
+		island.penetrationEnd = island.penetrationBegin;
+	}
 
-		const Matrix jacobianTranspose = penetration.jacobian.Transpose();
-		Matrix denominator = penetration.jacobian * inverseMassMatrix * jacobianTranspose;
+	m_islandJoints.resize(m_awakeJoints.size());
+	for (size_t i = 0; i < m_awakeJoints.size(); i++)
+		m_islandJoints[m_islands[m_jointIslands[i]].jointEnd++] = m_awakeJoints[i];
 
-		// lambda = num/deno => lambda * denominator = numerator.
-		// Since this is of the form Ax = B solving using Gauss-Seidel method
-		VectorN lambda = Matrix::SolveGaussSeidel(denominator, numerator);
+	m_islandPenetrations.resize(m_awakePenetrations.size());
+	for (size_t i = 0; i < m_awakePenetrations.size(); i++)
+		m_islandPenetrations[m_islands[m_penetrationIslands[i]].penetrationEnd++] = m_awakePenetrations[i];
+}
 
-		// Accumulate impulses and clamp it within constraint limits. The cachedLambda will be used by PreSolve
-		VectorN oldLambda = penetration.cachedLambda;
-		penetration.cachedLambda += lambda;
-		penetration.cachedLambda[0] = (penetration.cachedLambda[0] < 0.0f) ? 0.0f : penetration.cachedLambda[0];
+void ConstraintSystem::SolveIsland(const Island& island, const float deltaTime) const
+{
+	for (size_t i = island.jointBegin; i < island.jointEnd; i++)
+		PreSolveJoint(*m_islandJoints[i], deltaTime);
+	for (size_t i = island.penetrationBegin; i < island.penetrationEnd; i++)
+		PreSolvePenetration(*m_islandPenetrations[i], deltaTime);
 
-		// Friction should be between -(μ * λn) and (μ * λn), where λn is impulse along normal
-		if (penetration.friction > 0.0f)
+	// Iterate multiple times for better constraint resolution
+	for (int iteration = 0; iteration < m_solverIterations; iteration++)
+	{
+		for (size_t i = island.jointBegin; i < island.jointEnd; i++)
+			SolveJoint(*m_islandJoints[i]);
+		for (size_t i = island.penetrationBegin; i < island.penetrationEnd; i++)
+			SolvePenetration(*m_islandPenetrations[i]);
+	}
+}
+
+void ConstraintSystem::LinkBodies(const Entity& a, const Entity& b)
+{
+	if (!a.IsAlive() || !b.IsAlive() || !a.HasComponent<RigidBodyComponent>() || !b.HasComponent<RigidBodyComponent>())
+		return;
+
+	const auto& rigidBodyA = a.GetComponent<RigidBodyComponent>();
+	const auto& rigidBodyB = b.GetComponent<RigidBodyComponent>();
+	const bool isADynamic = IsDynamic(rigidBodyA);
+	const bool isBDynamic = IsDynamic(rigidBodyB);
+
+	if (isADynamic && isBDynamic)
+	{
+		const size_t rootA = FindIslandRoot(a.GetId());
+		const size_t rootB = FindIslandRoot(b.GetId());
+		if (rootA != rootB)
 		{
-			// penetration.cachedLambda[0] is normal
-			// penetration.cachedLambda[1] is tangent
-			const float maxFriction = penetration.cachedLambda[0] * penetration.friction;
-			penetration.cachedLambda[1] = std::clamp(penetration.cachedLambda[1], -maxFriction, maxFriction);
+			m_islandParent[rootB] = rootA;
+			m_isIslandAwake[rootA] = m_isIslandAwake[rootA] || m_isIslandAwake[rootB];
 		}
+		return;
+	}
+
+	// A moving kinematic body (ex: a swinging anchor) wakes up the island it touches
+	auto isMovingKinematic = [](const RigidBodyComponent& rigidBody)
+	{
+		return rigidBody.isKinematic && (rigidBody.velocity.MagnitudeSquared() > 0.0f || rigidBody.angularVelocity != 0.0f);
+	};
+	if (isADynamic && isMovingKinematic(rigidBodyB))
+	{
+		m_isIslandAwake[FindIslandRoot(a.GetId())] = true;
+	}
+	else if (isBDynamic && isMovingKinematic(rigidBodyA))
+	{
+		m_isIslandAwake[FindIslandRoot(b.GetId())] = true;
+	}
+}
 
-		lambda = penetration.cachedLambda - oldLambda;
+void ConstraintSystem::UpdateSleeping(const float deltaTime)
+{
+	constexpr float linearToleranceSquared = Physics::LINEAR_SLEEP_TOLERANCE * Physics::LINEAR_SLEEP_TOLERANCE;
 
-		// Computing impulses with direction and magnitude
-		VectorN impulses = jacobianTranspose * lambda;
+	// Update the sleep timer of the awake bodies and keep the smallest one per island
+	for (const auto& body : m_bodies)
+	{
+		m_islandSleepTime[FindIslandRoot(body.GetId())] = std::numeric_limits<float>::max();
+	}
+	for (const auto& body : m_bodies)
+	{
+		auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		if (!rigidBody.isAwake)
+			continue;
 
-		// Applying impulses to both A and B
-		if (!rigidbodyA.isKinematic)
+		if (rigidBody.velocity.MagnitudeSquared() > linearToleranceSquared || std::fabs(rigidBody.angularVelocity) > Physics::ANGULAR_SLEEP_TOLERANCE)
 		{
-			rigidbodyA.ApplyImpulseLinear(Vector2(impulses[0], impulses[1])); // A linear impulse
-			rigidbodyA.ApplyImpulseAngular(impulses[2]);								// A angular impulse
-			// Logger::Log("A impulse: " + Vector2(impulses[0], impulses[1]).ToString());
+			rigidBody.sleepTime = 0.0f;
 		}
-		if (!rigidbodyB.isKinematic)
+		else
 		{
-			rigidbodyB.ApplyImpulseLinear(Vector2(impulses[3], impulses[4])); // B linear impulse
-			rigidbodyB.ApplyImpulseAngular(impulses[5]);								// B angular impulse
-			// Logger::Log("B impulse: " + Vector2(impulses[3], impulses[4]).ToString());
+			rigidBody.sleepTime += deltaTime;
 		}
+
+		float& islandSleepTime = m_islandSleepTime[FindIslandRoot(body.GetId())];
+		islandSleepTime = std::min(islandSleepTime, rigidBody.sleepTime);
 	}
+
+	// The whole island goes to sleep at once, otherwise a sleeping body would be woken up again by the contact with its awake neighbours
+	m_awakeBodyCount = 0;
+	m_sleepingBodyCount = 0;
+	for (const auto& body : m_bodies)
+	{
+		auto& rigidBody = body.GetComponent<RigidBodyComponent>();
+		if (rigidBody.isAwake && m_islandSleepTime[FindIslandRoot(body.GetId())] >= Physics::TIME_TO_SLEEP)
+		{
+			rigidBody.SetAwake(false);
+		}
+		if (rigidBody.isAwake)
+			m_awakeBodyCount++;
+		else
+			m_sleepingBodyCount++;
+	}
+}
+
+size_t ConstraintSystem::FindIslandRoot(size_t entityId)
+{
+	// Path halving: point every visited node to its grandparent to keep the trees flat
+	while (m_islandParent[entityId] != entityId)
+	{
+		m_islandParent[entityId] = m_islandParent[m_islandParent[entityId]];
+		entityId = m_islandParent[entityId];
+	}
+	return entityId;
 }
 
 std::vector<PenetrationConstraint>& ConstraintSystem::GetPenetrations()
@@ -403,12 +667,37 @@ std::vector<PenetrationConstraint>& ConstraintSystem::GetPenetrations()
 void ConstraintSystem::ClearPenetrations()
 {
 	m_penetrations.clear();
+	m_warmStartedCount = 0;
 }
 
 void ConstraintSystem::AddPenetration(Entity a, Entity b, Vector2 startContactPoint, Vector2 endContactPoint,
-	Vector2 collisionNormal)
+	Vector2 collisionNormal, uint32_t featureId)
 {
-	m_penetrations.emplace_back(a, b, startContactPoint, endContactPoint, collisionNormal);
+	auto& penetration = m_penetrations.emplace_back(a, b, startContactPoint, endContactPoint, collisionNormal, featureId);
+
+	// Warm starting: if the same contact existed in the last frame then start from its accumulated impulses. PreSolvePenetration() applies them
+	if (!m_isWarmStarting)
+	{
+		return;
+	}
+	const CachedContact key{ a, b, featureId, {} };
+	const auto it = std::lower_bound(m_contactCache.begin(), m_contactCache.end(), key);
+	if (it != m_contactCache.end() && !(key < *it))
+	{
+		penetration.cachedLambda = it->cachedLambda;
+		m_warmStartedCount++;
+	}
+}
+
+void ConstraintSystem::CacheContacts()
+{
+	// The vector keeps its capacity, so this doesn't allocate once the number of contacts is stable
+	m_contactCache.clear();
+	for (const auto& penetration : m_penetrations)
+	{
+		m_contactCache.push_back({ penetration.a, penetration.b, penetration.featureId, penetration.cachedLambda });
+	}
+	std::sort(m_contactCache.begin(), m_contactCache.end());
 }
 
 size_t ConstraintSystem::GetPenetrationSize() const
@@ -10,7 +10,9 @@
 
 class CollisionEvent;
 class EventManager;
+class RigidBodyComponent;
 struct ConstraintTypeComponent;
+struct JointConstraintComponent;
 
 class ConstraintSystem : public System
 {
@@ -19,6 +21,11 @@ public:
 	{
 		RequireComponent<TransformComponent>();
 		RequireComponent<ConstraintTypeComponent>();
+
+		ReadComponent<TransformComponent>();
+		ReadComponent<ConstraintTypeComponent>();
+		WriteComponent<RigidBodyComponent>();
+		WriteComponent<JointConstraintComponent>();
 	}
 
 	// Calculate the local coordinates of the joint anchorPoint w.r.t the center of mass of the entity 'a' and 'b'
@@ -27,29 +34,133 @@ public:
 	// To populate the m_penetrations vector
 	void SubscribeToEvents(const std::shared_ptr<EventManager>& eventManager);
 	void onCollision(const CollisionEvent& event);
+	// All the collisions of the frame at once (the CollisionEvents are queued)
+	void OnCollisions(const std::vector<CollisionEvent>& events);
 
 	// Execute all the steps (PreSolve, Solve and PostSolve) to resolve constrains
+	// Only the constraints of awake islands are solved. The islands (bodies connected by penetrations or joints) are built at the start of the update and put to sleep at the end.
+	// The islands don't share any dynamic body, so they are solved in parallel on the JobSystem and the result is the same for any number of workers
 	void Update(const float deltaTime);
 
+	// Number of Solve() iterations per Update(). Since the contacts are warm started with the impulses of the previous frame, fewer iterations are needed for stable stacks
+	void SetSolverIterations(const int iterations) { m_solverIterations = iterations; }
+	[[nodiscard]] int GetSolverIterations() const { return m_solverIterations; }
+	// Without warm starting every contact starts from zero impulses (ex: to compare the iterations a stack needs, see StackingScene)
+	void SetWarmStarting(const bool isWarmStarting) { m_isWarmStarting = isWarmStarting; }
+
 	// Pre-solving step: Calculate Jacobian and apply cached impulses (lambda)
 	void PreSolve(const float deltaTime);
+	static void PreSolveJoint(JointConstraintComponent& jointComponent, float deltaTime);
 	// Solve step: Resolve constraints and accumulate impulses
 	void Solve();
+	static void SolveJoint(JointConstraintComponent& jointComponent);
+	// Apply JT * lambda to the bodies of the joint (set by PreSolveJoint())
+	static void ApplyJointImpulse(const JointConstraintComponent& jointComponent, float lambda);
 
 
 	// For Penetration constraint
 
 	// Pre-solving step: Calculate Jacobian and apply cached impulses (lambda)
 	void PreSolvePenetration(const float deltaTime);
+	static void PreSolvePenetration(PenetrationConstraint& penetration, float deltaTime);
 	// Solve step: Resolve constraints and accumulate impulses
 	void SolvePenetration();
+	static void SolvePenetration(PenetrationConstraint& penetration);
+	// Apply JT * lambda to the bodies of the penetration (set by PreSolvePenetration())
+	static void ApplyPenetrationImpulse(const PenetrationConstraint& penetration, float normalLambda, float tangentLambda);
 
 	// Manage penetration vector. Whenever a collision happens a new penetration is added to the vector and after resolution they are cleared.
+	// AddPenetration() warm starts the penetration with the accumulated impulses of the same contact (a, b, featureId) in the previous frame
 	std::vector<PenetrationConstraint>& GetPenetrations();
 	void ClearPenetrations();
-	void AddPenetration(Entity a, Entity b, Vector2 startContactPoint, Vector2 endContactPoint, Vector2 collisionNormal);
+	void AddPenetration(Entity a, Entity b, Vector2 startContactPoint, Vector2 endContactPoint, Vector2 collisionNormal, uint32_t featureId = 0);
 	size_t GetPenetrationSize() const;
 
+	// Body counts (dynamic bodies only) of the last Update()
+	[[nodiscard]] size_t GetAwakeBodyCount() const { return m_awakeBodyCount; }
+	[[nodiscard]] size_t GetSleepingBodyCount() const { return m_sleepingBodyCount; }
+	[[nodiscard]] size_t GetIslandCount() const { return m_islandCount; }
+
+	// Number of contacts kept from the last Update() and how many of the current penetrations were warm started from them
+	[[nodiscard]] size_t GetCachedContactCount() const { return m_contactCache.size(); }
+	[[nodiscard]] size_t GetWarmStartedCount() const { return m_warmStartedCount; }
+
 private:
+	// Accumulated impulses of a contact, kept for one frame. Keyed by the full entity handles, so a recycled id never picks up the impulses of a killed entity
+	struct CachedContact
+	{
+		Entity a;
+		Entity b;
+		uint32_t featureId;
+		Vec<2> cachedLambda;
+
+		[[nodiscard]] bool operator<(const CachedContact& other) const
+		{
+			if (a != other.a) return a < other.a;
+			if (b != other.b) return b < other.b;
+			return featureId < other.featureId;
+		}
+	};
+
+	// Replace the contact cache with the penetrations solved in this frame
+	void CacheContacts();
+
+	//------------------------------------------------------------------------
+	// Islands
+
+	// Dynamic = can be moved by the solver (not kinematic and not static). Only dynamic bodies are part of an island and can sleep
+	[[nodiscard]] static bool IsDynamic(const RigidBodyComponent& rigidBody);
+	// Is a constraint between these bodies solved? At least one of them has to be an awake dynamic body
+	[[nodiscard]] static bool IsConstraintAwake(const RigidBodyComponent& rigidBodyA, const RigidBodyComponent& rigidBodyB);
+
+	// Constraints of one awake island, as ranges of m_islandJoints and m_islandPenetrations
+	struct Island
+	{
+		size_t jointBegin;
+		size_t jointEnd;
+		size_t penetrationBegin;
+		size_t penetrationEnd;
+	};
+
+	// Union-find the dynamic bodies connected by the penetrations and joints, then wake up every island that has an awake body or touches a moving kinematic body.
+	// Finally group the awake constraints per island in m_islands
+	void BuildIslands();
+	// Group the constraints that will be solved by island, keeping their order inside an island
+	void GroupConstraintsByIsland();
+	// PreSolve, then Solve for m_solverIterations, the constraints of one island. Only touches the constraints and the bodies of that island
+	void SolveIsland(const Island& island, float deltaTime) const;
+	// Link the islands of 'a' and 'b' if both are dynamic. If only one is dynamic and the other one is a moving kinematic body, keep its island awake
+	void LinkBodies(const Entity& a, const Entity& b);
+	// Update the sleep timer of the awake bodies and put to sleep the islands whose bodies all stayed still for Physics::TIME_TO_SLEEP
+	void UpdateSleeping(float deltaTime);
+	[[nodiscard]] size_t FindIslandRoot(size_t entityId);
+
+	// Dynamic bodies found by BuildIslands()
+	std::vector<Entity> m_bodies;
+	std::vector<Island> m_islands;
+	std::vector<JointConstraintComponent*> m_islandJoints;
+	std::vector<PenetrationConstraint*> m_islandPenetrations;
+	// Island of every awake constraint (parallel to m_islandJoints/m_islandPenetrations before they are sorted)
+	std::vector<size_t> m_jointIslands;
+	std::vector<size_t> m_penetrationIslands;
+	std::vector<JointConstraintComponent*> m_awakeJoints;
+	std::vector<PenetrationConstraint*> m_awakePenetrations;
+	// [Vector index = entity id]
+	std::vector<size_t> m_islandParent;		// Union-find parent, the root of an island is its own parent
+	std::vector<bool> m_isIslandAwake;		// Only valid for the roots
+	std::vector<float> m_islandSleepTime;	// Only valid for the roots. Min sleep time of the bodies of the island
+	std::vector<size_t> m_islandIndex;		// Only valid for the roots of awake islands. Index in m_islands
+
+	size_t m_awakeBodyCount = 0;
+	size_t m_sleepingBodyCount = 0;
+	size_t m_islandCount = 0;
+
 	std::vector<PenetrationConstraint> m_penetrations;
+
+	// Sorted by (a, b, featureId) for binary search. Rebuilt at the end of every Update(), so the contacts that stopped touching are dropped
+	std::vector<CachedContact> m_contactCache;
+	size_t m_warmStartedCount = 0;
+
+	int m_solverIterations = 8;
+	bool m_isWarmStarting = true;
 };
@@ -32,24 +32,20 @@ GameplaySystem::GameplaySystem(std::unique_ptr<Coordinator>& coordinator, std::u
 	: m_coordinator(coordinator.get()), m_assetManager(assetManager.get()), m_audioManager(std::move(audioManager)), m_gameState(std::move(gameState)), m_score(std::move(score))
 {
 	RequireComponent<PlayerComponent>();
+	// No ReadComponent/WriteComponent: it kills and creates entities, so the SystemScheduler runs it alone
 	m_gameStartTime = std::chrono::steady_clock::now();
 }
 
 void GameplaySystem::SubscribeToEvents(const std::shared_ptr<EventManager>& eventManager)
 {
 	// Collision Event
-	const std::function<void(GameplaySystem*, CollisionEvent&)> callbackCollision = [this](auto&&, auto&& placeholder2) { onCollision(std::forward<decltype(placeholder2)>(placeholder2)); };
-	eventManager->SubscribeToEvent<CollisionEvent>(this, callbackCollision);
-	//  std::placeholders::_2 tells std::bind that the second argument (the event) will be provided when the resulting function is called. This allows us to create a callable object that matches the required function signature of SubscribeToEvent, where the first argument is the instance (DamageSystem*), and the second argument is the event (CollisionEvent&).
+	eventManager->SubscribeToEvent<CollisionEvent, &GameplaySystem::onCollision>(this);
 
 	// Launch Ball Event
-	const std::function<void(GameplaySystem*, LaunchBallEvent&)> callbackLaunch = [this](auto&&, auto&& placeholder2) { onBallLaunch(std::forward<decltype(placeholder2)>(placeholder2)); };
-	eventManager->SubscribeToEvent<LaunchBallEvent>(this, callbackLaunch);
+	eventManager->SubscribeToEvent<LaunchBallEvent, &GameplaySystem::onBallLaunch>(this);
 
 	// Player State change event
-	const std::function<void(GameplaySystem*, PlayerStateChangeEvent&)> callback = [this](auto&&, auto&& placeholder2) { OnPlayerStateChange(std::forward<decltype(placeholder2)>(placeholder2)); };
-	eventManager->SubscribeToEvent<PlayerStateChangeEvent>(this, callback);
-	
+	eventManager->SubscribeToEvent<PlayerStateChangeEvent, &GameplaySystem::OnPlayerStateChange>(this);
 }
 
 void GameplaySystem::OnPlayerStateChange(const PlayerStateChangeEvent& event)
@@ -60,17 +56,8 @@ void GameplaySystem::OnPlayerStateChange(const PlayerStateChangeEvent& event)
 void GameplaySystem::onBallLaunch(const LaunchBallEvent& event)
 {
 	Logger::Log(event.force.ToString());
-	switch (m_activeAbility) {
-	case Ability::NORMAL_SHOT:
-		event.player.GetComponent<RigidBodyComponent>().AddForce(event.force);
-		break;
-	case Ability::POWER_SHOT:
-		event.player.GetComponent<RigidBodyComponent>().AddForce(event.force * 2);
-		break;
-	case Ability::WEAK_SHOT:
-		event.player.GetComponent<RigidBodyComponent>().AddForce(event.force / 2);
-		break;
-	}
+	// AddForce() also wakes the ball up if it fell asleep
+	event.player.GetComponent<RigidBodyComponent>().AddForce(event.force * GetShotForceScale(m_activeAbility));
 	
 	auto& playerComponent = event.player.GetComponent<PlayerComponent>();
 
@@ -96,6 +83,10 @@ void GameplaySystem::onCollision(const CollisionEvent& event)
 	const auto& playerEntity = isAPlayer ? event.a : event.b;
 	const auto& otherEntity = isAPlayer ? event.b : event.a;
 
+	// The physics runs several steps per frame and the kills only happen at the next Coordinator::Update(): a killed ball or explosive keeps colliding until then
+	if (playerEntity.IsToBeKilled() || otherEntity.IsToBeKilled())
+		return;
+
 	// Handle Killers
 	if (otherEntity.BelongsToGroup("StaticKillers"))
 	{
@@ -146,6 +137,22 @@ void GameplaySystem::onCollision(const CollisionEvent& event)
 		Vector2 explosionKickBackDir = playerEntity.GetComponent<TransformComponent>().position - otherEntity.GetComponent<TransformComponent>().position;
 		playerEntity.GetComponent<RigidBodyComponent>().AddForce(explosionKickBackDir * m_explosionStrength);
 
+		// The blast also pushes the other dynamic bodies around the explosive
+		m_coordinator->GetSystem<CollisionSystem>().GetQuery().OverlapCircle(position, m_explosionRadius, m_blastEntities);
+		for (Entity& blastEntity : m_blastEntities)
+		{
+			if (blastEntity == otherEntity || blastEntity == playerEntity || !blastEntity.HasComponent<RigidBodyComponent>())
+			{
+				continue;
+			}
+			RigidBodyComponent& blastRigidBody = blastEntity.GetComponent<RigidBodyComponent>();
+			if (blastRigidBody.IsStatic())
+			{
+				continue;
+			}
+			blastRigidBody.AddForce((blastEntity.GetComponent<TransformComponent>().position - position) * m_explosionStrength);
+		}
+
 		if (!m_audioManager->IsAudioPlaying("explosion"))	m_audioManager->PlayAudio("explosion", false);
 	}
 
@@ -171,7 +178,7 @@ void GameplaySystem::Update(std::vector<Vector2>& terrainVertices)
 		m_ballInHole = false;
 	}
 
-	for (auto& player : GetSystemEntities())
+	for (auto player : GetSystemEntities())
 	{
 		UpdateScore(player);
 		auto& playerPosition = player.GetComponent<TransformComponent>().position;
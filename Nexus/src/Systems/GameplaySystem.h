@@ -52,6 +52,8 @@ private:
 
 	// Obstacles variables
 	float m_explosionStrength = 5000.f; // The kickback force to the player
+	float m_explosionRadius = 150.f; // The other bodies in this radius are pushed too
+	std::vector<Entity> m_blastEntities;
 
 	// Active player ability
 	Ability m_activeAbility = Ability::NORMAL_SHOT;
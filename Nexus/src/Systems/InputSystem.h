@@ -32,10 +32,7 @@ public:
 		// Create a new shared pointer from the reference. Need it to emit launch ball event events.
 		m_eventManager = eventManager;
 
-		using CallbackType = std::function<void(InputSystem*, ActionChangeEvent&)>;
-		const CallbackType callback = [this](auto&&, auto&& placeholder2) { OnActionChange(std::forward<decltype(placeholder2)>(placeholder2)); };
-		eventManager->SubscribeToEvent<ActionChangeEvent>(this, callback);
-		// std::bind usually copies the so need std::ref to ensure object is passed by reference wrapper using std::ref
+		eventManager->SubscribeToEvent<ActionChangeEvent, &InputSystem::OnActionChange>(this);
 	}
 
 	void OnActionChange(const ActionChangeEvent& actionEvent)
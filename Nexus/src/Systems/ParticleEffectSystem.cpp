@@ -17,6 +17,7 @@
 #include "src/Physics/Particle.h"
 #include "src/Utils/Vector2.h"
 #include "src/Utils/GraphicsUtils.h"
+#include "src/Utils/JobSystem.h"
 #include "src/Utils/Math.h"
 #include "src/Utils/Random.h"
 #include "src/Physics/Camera.h"
@@ -29,30 +30,35 @@ void ParticleEffectSystem::Update(const float deltaTime)
 
 void ParticleEffectSystem::UpdateParticle(const float deltaTime)
 {
-	for (auto& particle : m_particlePool)
+	// Particles don't interact with each other, the pool is updated in parallel
+	JobSystem::ParallelFor(m_particlePool.size(), 256, [this, deltaTime](const size_t begin, const size_t end)
 	{
-		if (!particle.active)
-			continue;
-
-		if (particle.lifeRemaining <= 0.0f)
+		for (size_t i = begin; i < end; i++)
 		{
-			particle.active = false;
-			continue;
-		}
+			Particle& particle = m_particlePool[i];
+			if (!particle.active)
+				continue;
+
+			if (particle.lifeRemaining <= 0.0f)
+			{
+				particle.active = false;
+				continue;
+			}
 
-		particle.lifeRemaining -= deltaTime;
+			particle.lifeRemaining -= deltaTime;
 
-		if (particle.useGravity)
-		{
-			particle.velocity.y -= Physics::gravity * particle.gravityStrength * deltaTime;
-		}
+			if (particle.useGravity)
+			{
+				particle.velocity.y -= Physics::gravity * particle.gravityStrength * deltaTime;
+			}
 
-		particle.position += particle.velocity * deltaTime;
-		if (particle.rotation < 0)
-			particle.rotation -= 5.f * deltaTime;  // Keep rotating negative
-		else
-			particle.rotation += 5.f * deltaTime;  // Keep rotating positive
-	}
+			particle.position += particle.velocity * deltaTime;
+			if (particle.rotation < 0)
+				particle.rotation -= 5.f * deltaTime;  // Keep rotating negative
+			else
+				particle.rotation += 5.f * deltaTime;  // Keep rotating positive
+		}
+	});
 }
 
 void ParticleEffectSystem::UpdateEmitters(const float deltaTime)
@@ -221,10 +227,8 @@ void ParticleEffectSystem::Render(const Camera& camera) const
 
 void ParticleEffectSystem::SubscribeToEvents(const std::shared_ptr<EventManager>& eventManager)
 {
-	using CallbackType = std::function<void(ParticleEffectSystem*, PlayerStateChangeEvent&)>;
-	const CallbackType callback = [this](auto&&, auto&& placeholder2) { OnPlayerStateChange(std::forward<decltype(placeholder2)>(placeholder2)); };
-	eventManager->SubscribeToEvent<PlayerStateChangeEvent>(this, callback);
-	//  std::placeholders::_2 tells std::bind that the second argument (the event) will be provided when the resulting function is called. This allows us to create a callable object that matches the required function signature of SubscribeToEvent, where the first argument is the instance (PhysicsSystem*), and the second argument is the event (CollisionEvent&).
+	// OnPlayerStateChange() is static, the owner is only used to unsubscribe
+	eventManager->SubscribeToEvent<PlayerStateChangeEvent, &ParticleEffectSystem::OnPlayerStateChange>(this);
 }
 
 void ParticleEffectSystem::OnPlayerStateChange(const PlayerStateChangeEvent& event)
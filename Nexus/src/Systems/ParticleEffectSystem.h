@@ -18,6 +18,9 @@ public:
 	{
 		RequireComponent<TransformComponent>();
 		RequireComponent<ParticleEmitterComponent>();
+
+		ReadComponent<TransformComponent>();
+		WriteComponent<ParticleEmitterComponent>();
 		m_particlePool.resize(1000);
 	}
 
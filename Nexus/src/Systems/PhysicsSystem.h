@@ -1,12 +1,21 @@
 #pragma once
 
 #include "src/ECS/System.h"
+#include "src/ECS/Coordinator.h"
 
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/GravityComponent.h"
+#include "src/Components/PolygonColliderComponent.h"
 #include "src/Components/RigidbodyComponent.h"
 #include "src/Components/TransformComponent.h"
+#include "src/Systems/CollisionSystem.h"
 #include "src/EventManagement/EventManager.h"
 #include "src/Physics/PhysicsEngine.h"
 #include "src/Physics/Constants.h"
+#include "src/Physics/GravityField.h"
 #include "../Games/GalaxyGolf/WorldSettings.h"
 #include "src/Events/CollisionEvent.h"
 #include "src/Utils/Random.h"
@@ -19,6 +28,16 @@ public:
 	{
 		RequireComponent<TransformComponent>();
 		RequireComponent<RigidBodyComponent>();
+
+		// UpdateVelocities() also moves the colliders
+		WriteComponent<TransformComponent>();
+		WriteComponent<RigidBodyComponent>();
+		WriteComponent<ColliderTypeComponent>();
+		WriteComponent<BoxColliderComponent>();
+		WriteComponent<CircleColliderComponent>();
+		WriteComponent<PolygonColliderComponent>();
+		WriteComponent<ChainColliderComponent>();
+		ReadComponent<GravityComponent>();
 	}
 
 	void InitializeEntityPhysics() const
@@ -32,10 +51,7 @@ public:
 
 	void SubscribeToEvents(const std::unique_ptr<EventManager>& eventManager)
 	{
-		using CallbackType = std::function<void(PhysicsSystem*, CollisionEvent&)>;
-		const CallbackType callback = [this](auto&&, auto&& placeholder2) { OnCollision(std::forward<decltype(placeholder2)>(placeholder2)); };
-		eventManager->SubscribeToEvent<CollisionEvent>(this, callback);
-		//  std::placeholders::_2 tells std::bind that the second argument (the event) will be provided when the resulting function is called. This allows us to create a callable object that matches the required function signature of SubscribeToEvent, where the first argument is the instance (PhysicsSystem*), and the second argument is the event (CollisionEvent&).
+		eventManager->SubscribeToEvent<CollisionEvent, &PhysicsSystem::OnCollision>(this);
 	}
 
 	static void OnCollision(const CollisionEvent& event)
@@ -53,15 +69,28 @@ public:
 		);
 	}
 
-	// Add and integrate forces for non-kinematic bodies
-	void UpdateForces(const float deltaTime, const WorldSettings& worldSettings)
+	// Called before every physics step: the render interpolates between this state and the one after the step
+	void StorePreviousTransforms() const
 	{
-		for (auto& entity : GetSystemEntities())
+		for (auto [entity, transform, rigidBody] : GetCoordinator().View<TransformComponent, RigidBodyComponent>())
 		{
-			// auto& transform = entity.GetComponent<TransformComponent>();
-			auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+			transform.previousPosition = transform.position;
+			transform.previousRotation = transform.rotation;
+		}
+	}
+
+	// Add and integrate forces for non-kinematic bodies. Sleeping bodies are skipped
+	void UpdateForces(const float deltaTime, const WorldSettings& worldSettings) const
+	{
+		auto view = GetCoordinator().View<TransformComponent, RigidBodyComponent>();
+		for (auto [entity, transform, rigidBody] : view)
+		{
+			if (!rigidBody.isAwake)
+			{
+				continue;
+			}
 
-			if (!entity.BelongsToGroup("Aliens")) // No gravity for bodies that are getting attracted by gravitational force b/w each other
+			if (!entity.BelongsToGroup("Aliens") && !entity.HasComponent<GravityComponent>()) // No gravity for bodies that are getting attracted by gravitational force b/w each other
 			{
 				// Adding weight force
 				Vector2 weight = Vector2(0.0f, (rigidBody.mass * worldSettings.gravity * Physics::PIXEL_PER_METER));
@@ -80,53 +109,110 @@ public:
 			AddSpringForceToConnectedEntities(entity);
 
 
+			// One way: the ball isn't pulled back and keeps its weight. The clamped distance² (50 to 500) makes it a steady pull, not the gravity of GravityField
 			if (entity.BelongsToGroup("Aliens"))
 			{
-				for (auto& ball : entity.GetEntitiesByRelationshipTag("Attracted"))
+				// Structured bindings can't be captured
+				RigidBodyComponent& alienRigidBody = rigidBody;
+				const Vector2 alienPosition = transform.position;
+				entity.ForEachEntityByRelationshipTag("Attracted", [&alienRigidBody, alienPosition](const Entity& ball)
 				{
-					rigidBody.AddForce(PhysicsEngine::GenerateGravitationalForce(
-						rigidBody,
+					alienRigidBody.AddForce(PhysicsEngine::GenerateGravitationalForce(
+						alienRigidBody,
 						ball.GetComponent<RigidBodyComponent>(),
-						ball.GetComponent<TransformComponent>().position - entity.GetComponent<TransformComponent>().position,
+						ball.GetComponent<TransformComponent>().position - alienPosition,
 						10000,
 						50,
 						500
 					));
-
-				}
+				});
 			}
-
-			PhysicsEngine::IntegrateForces(rigidBody, deltaTime);
 		}
+
+		// Before the integration: the attraction wakes the sleeping bodies up
+		AddMutualGravityForces();
+
+		// Integrated once all the forces are added, the springs also pull on the bodies that come earlier in the view
+		IntegrateForces(deltaTime);
 	}
 
-	// Integrate velocity and acceleration (linear and angular) for all the bodies and update their collider
-	void UpdateVelocities(const float deltaTime)
+	// Integrate velocity and acceleration (linear and angular) for all the awake bodies and update their collider
+	void UpdateVelocities(const float deltaTime) const
 	{
-		for (auto entity : GetSystemEntities())
+		IntegrateVelocities(deltaTime);
+
+		auto view = GetCoordinator().View<TransformComponent, RigidBodyComponent>();
+		// Update collider (and its broad phase proxy) for all the bodies
+		if (GetCoordinator().HasSystem<CollisionSystem>())
 		{
-			auto& transform = entity.GetComponent<TransformComponent>();
-			auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+			auto& collisionSystem = GetCoordinator().GetSystem<CollisionSystem>();
+			SweepBullets(deltaTime, collisionSystem);
 
-			if (rigidBody.isKinematic)
+			// The static bodies (ex: the terrain chain) never move: CollisionSystem::CreateProxy() computed their collider once and their proxy is static
+			auto& broadPhase = collisionSystem.GetBroadPhase();
+			for (auto [entity, transform, rigidBody] : view)
 			{
-				rigidBody.velocity += rigidBody.acceleration * deltaTime;
-				transform.position += rigidBody.velocity * deltaTime;
-				rigidBody.angularVelocity += rigidBody.angularAcceleration * deltaTime;
-				transform.rotation += rigidBody.angularVelocity * deltaTime;
+				if (rigidBody.isAwake && (rigidBody.isKinematic || !rigidBody.IsStatic()))
+				{
+					PhysicsEngine::UpdateColliderProperties(entity, transform, broadPhase, rigidBody.velocity * deltaTime);
+				}
 			}
-			else
+			return;
+		}
+		for (auto [entity, transform, rigidBody] : view)
+		{
+			if (rigidBody.isAwake)
 			{
-				PhysicsEngine::IntegrateVelocities(rigidBody, transform, deltaTime);
+				PhysicsEngine::UpdateColliderProperties(entity, transform);
 			}
 		}
-		// Update collider for all the bodies
-		for (auto entity : GetSystemEntities())
+	}
+
+	// The integration part of UpdateForces(): the forces added to the awake bodies become their acceleration and velocity.
+	// With the archetype storage a whole chunk is integrated at once, in place (see PhysicsEngine::IntegrateForces())
+	void IntegrateForces(const float deltaTime) const
+	{
+		GetCoordinator().View<TransformComponent, RigidBodyComponent>().ForEachChunk([deltaTime](const size_t count, TransformComponent*, RigidBodyComponent* rigidBodies)
 		{
-			auto& transform = entity.GetComponent<TransformComponent>();
-			// auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+			PhysicsEngine::IntegrateForces(rigidBodies, count, deltaTime);
+		});
+	}
 
-			PhysicsEngine::UpdateColliderProperties(entity, transform);
+	// The integration part of UpdateVelocities(): moves the awake bodies, the colliders aren't updated
+	void IntegrateVelocities(const float deltaTime) const
+	{
+		GetCoordinator().View<TransformComponent, RigidBodyComponent>().ForEachChunk([deltaTime](const size_t count, TransformComponent* transforms, RigidBodyComponent* rigidBodies)
+		{
+			PhysicsEngine::IntegrateVelocities(rigidBodies, transforms, count, deltaTime);
+		});
+	}
+
+	// Continuous collision detection for the bullets (RigidBodyComponent::isBullet). The colliders aren't updated yet, so each circle is swept from its globalCenter along this step's movement.
+	// A bullet that hits a static collider is moved back to the first impact (plus Physics::CCD_TARGET_PENETRATION): the rest of its movement is skipped for this step instead of making every step smaller,
+	// and the next collision step finds the contact and emits the CollisionEvent as usual
+	void SweepBullets(const float deltaTime, CollisionSystem& collisionSystem) const
+	{
+		for (auto [entity, transform, rigidBody] : GetCoordinator().View<TransformComponent, RigidBodyComponent>())
+		{
+			if (!rigidBody.isBullet || !rigidBody.isAwake || rigidBody.isKinematic || !entity.HasComponent<CircleColliderComponent>())
+			{
+				continue;
+			}
+
+			// Moving less than its radius, the discrete collision detection still sees the overlap
+			const Vector2 displacement = rigidBody.velocity * deltaTime;
+			const float radius = entity.GetComponent<CircleColliderComponent>().radius;
+			if (displacement.MagnitudeSquared() < radius * radius)
+			{
+				continue;
+			}
+
+			Vector2 normal;
+			const float timeOfImpact = collisionSystem.FindTimeOfImpact(entity, displacement, normal);
+			if (timeOfImpact < 1.0f)
+			{
+				transform.position += displacement * (timeOfImpact - 1.0f) - normal * Physics::CCD_TARGET_PENETRATION;
+			}
 		}
 	}
 
@@ -138,7 +224,7 @@ public:
 			auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
 
 			// Adding forces to connected spring entities
-			for (auto connectedEntity : entity.GetEntitiesByRelationshipTag("Spring"))
+			entity.ForEachEntityByRelationshipTag("Spring", [&transform, &rigidBody](const Entity& connectedEntity)
 			{
 				auto& connectedEntityTransform = connectedEntity.GetComponent<TransformComponent>();
 				auto& connectedEntityRigidBody = connectedEntity.GetComponent<RigidBodyComponent>();
@@ -150,7 +236,7 @@ public:
 				Vector2 springForce = PhysicsEngine::GenerateSpringForce(connectedEntityTransform, transform, restLength, springForceStrength);
 				connectedEntityRigidBody.AddForce(springForce);
 				rigidBody.AddForce(-springForce);
-			}
+			});
 		}
 		if (entity.BelongsToGroup("TightAnchor") || entity.BelongsToGroup("Spring"))
 		{
@@ -158,7 +244,7 @@ public:
 			auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
 
 			// Adding forces to connected spring entities
-			for (auto connectedEntity : entity.GetEntitiesByRelationshipTag("Spring"))
+			entity.ForEachEntityByRelationshipTag("Spring", [&transform, &rigidBody](const Entity& connectedEntity)
 			{
 				auto& connectedEntityTransform = connectedEntity.GetComponent<TransformComponent>();
 				auto& connectedEntityRigidBody = connectedEntity.GetComponent<RigidBodyComponent>();
@@ -170,7 +256,39 @@ public:
 				Vector2 springForce = PhysicsEngine::GenerateSpringForce(connectedEntityTransform, transform, restLength, springForceStrength);
 				connectedEntityRigidBody.AddForce(springForce);
 				rigidBody.AddForce(-springForce);
+			});
+		}
+	}
+
+	// N-body gravity between the bodies with a GravityComponent. Set its strength, opening angle etc. here
+	[[nodiscard]] GravityField& GetGravityField() const { return m_gravityField; }
+
+private:
+	// Every body with a GravityComponent attracts all the others, sleeping ones included
+	void AddMutualGravityForces() const
+	{
+		auto view = GetCoordinator().View<TransformComponent, RigidBodyComponent, GravityComponent>();
+		m_gravityField.Clear();
+		for (auto [entity, transform, rigidBody, gravity] : view)
+		{
+			m_gravityField.Add(transform.position, rigidBody.mass);
+		}
+		if (m_gravityField.GetSize() < 2)
+		{
+			return;
+		}
+
+		m_gravityField.ComputeForces();
+		size_t index = 0;
+		for (auto [entity, transform, rigidBody, gravity] : view)
+		{
+			if (!rigidBody.IsStatic())
+			{
+				rigidBody.AddForce(m_gravityField.GetForce(index));
 			}
+			index++;
 		}
 	}
+
+	mutable GravityField m_gravityField;
 };
@@ -16,6 +16,7 @@ public:
 	PlayerSystem()
 	{
 		RequireComponent<PlayerComponent>();
+		// No ReadComponent/WriteComponent: it emits PlayerStateChangeEvents, so the SystemScheduler runs it alone
 	}
 
 	void Update(const std::shared_ptr<EventManager>& eventManager) const
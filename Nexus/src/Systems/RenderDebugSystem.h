@@ -7,7 +7,9 @@
 #include "src/Components/ColliderTypeComponent.h"
 #include "src/Components/PolygonColliderComponent.h"
 #include "src/Components/CircleColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
 #include "src/Components/JointConstraintComponent.h"
+#include "src/Components/RigidBodyComponent.h"
 
 #include "src/Physics/Contact.h"
 
@@ -42,6 +44,9 @@ public:
 					case ColliderType::Polygon:
 						DrawPolygonCollider(entity, camera);
 						break;
+					case ColliderType::Chain:
+						DrawChainCollider(entity, camera);
+						break;
 				}
 
 				// Draw contact info
@@ -67,17 +72,16 @@ public:
 		}
 	}
 
-	void RenderConnectedEntites(const Camera& camera) const
+	// The lines follow the interpolated positions of the sprites (see RenderSystem::Update()), the colliders are drawn where the physics has them
+	void RenderConnectedEntites(const Camera& camera, const float alpha = 1.f) const
 	{
 		for (auto entity : GetSystemEntities())
 		{
-			const auto& transform = entity.GetComponent<TransformComponent>();
 			// Debug lines for Spring relationship
 			for (auto connectedEntity : entity.GetEntitiesByRelationshipTag("Spring"))
 			{
-				const auto& connectedEntityTransform = connectedEntity.GetComponent<TransformComponent>();
-				const Vector2 start = Camera::WorldToScreen(transform.position, camera);
-				const Vector2 end = Camera::WorldToScreen(connectedEntityTransform.position, camera);
+				const Vector2 start = Camera::WorldToScreen(GetRenderPosition(entity, alpha), camera);
+				const Vector2 end = Camera::WorldToScreen(GetRenderPosition(connectedEntity, alpha), camera);
 				Graphics::DrawLine(
 					Vector2(start.x, start.y),
 					Vector2(end.x, end.y)
@@ -88,14 +92,11 @@ public:
 			if (entity.HasComponent<JointConstraintComponent>())
 			{
 				auto& jointComponent = entity.GetComponent<JointConstraintComponent>();
-				const Vector2 start = Camera::WorldToScreen(
-					jointComponent.a.GetComponent<TransformComponent>().position,
-					camera
-				);
-				const Vector2 end = Camera::WorldToScreen(
-					jointComponent.b.GetComponent<TransformComponent>().position,
-					camera
-				);
+				if (!jointComponent.a.IsAlive() || !jointComponent.b.IsAlive())
+					continue;
+
+				const Vector2 start = Camera::WorldToScreen(GetRenderPosition(jointComponent.a, alpha), camera);
+				const Vector2 end = Camera::WorldToScreen(GetRenderPosition(jointComponent.b, alpha), camera);
 				Graphics::DrawLine(
 					Vector2(start.x, start.y),
 					Vector2(end.x, end.y),
@@ -105,6 +106,12 @@ public:
 		}
 	}
 
+	[[nodiscard]] static Vector2 GetRenderPosition(const Entity& entity, const float alpha)
+	{
+		const auto& transform = entity.GetComponent<TransformComponent>();
+		return entity.HasComponent<RigidBodyComponent>() ? transform.GetInterpolatedPosition(alpha) : transform.position;
+	}
+
 	static void DrawBoxCollider(const Entity& entity, const Camera& camera)
 	{
 		const auto& collider = entity.GetComponent<BoxColliderComponent>();
@@ -142,4 +149,15 @@ public:
 		const auto transformedVertices = Camera::TransformVertices(collider.globalVertices, camera);
 		Graphics::DrawPolygon(transformedVertices);
 	}
+
+	// Open chain: no edge between the last and the first vertex
+	static void DrawChainCollider(const Entity& entity, const Camera& camera)
+	{
+		const auto& collider = entity.GetComponent<ChainColliderComponent>();
+		const auto transformedVertices = Camera::TransformVertices(collider.globalVertices, camera);
+		for (size_t i = 0; i + 1 < transformedVertices.size(); i++)
+		{
+			Graphics::DrawLine(transformedVertices[i], transformedVertices[i + 1]);
+		}
+	}
 };
\ No newline at end of file
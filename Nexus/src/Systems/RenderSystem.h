@@ -9,6 +9,7 @@
 #include "src/AssetManagement/AssetManager.h"
 
 #include "src/Components/AnimationComponent.h"
+#include "src/Components/RigidBodyComponent.h"
 #include "src/Components/SpriteComponent.h"
 #include "src/Components/TransformComponent.h"
 
@@ -23,7 +24,8 @@ public:
 		RequireComponent<SpriteComponent>();
 	}
 
-	void Update(const std::unique_ptr<AssetManager>& assetManager, const Camera& camera) const
+	// alpha: how far the frame is between the last two physics steps (FixedTimestep::GetAlpha()), the rigid bodies are drawn in between
+	void Update(const std::unique_ptr<AssetManager>& assetManager, const Camera& camera, const float alpha = 1.f) const
 	{
 		//------------------------------------------------------------------------
 		// To make sure that the entity with higher SpriteComponent::z-index are rendered on top of lower, we need a sorted vector of SpriteComponent w.r.t z-index. 
@@ -41,7 +43,8 @@ public:
 			m_renderQueue.emplace_back(RenderableEntity{
 				&entity.GetComponent<TransformComponent>(),
 				&entity.GetComponent<SpriteComponent>(),
-				entity.HasComponent<AnimationComponent>()
+				entity.HasComponent<AnimationComponent>(),
+				entity.HasComponent<RigidBodyComponent>()
 				});
 		}
 
@@ -56,17 +59,20 @@ public:
 		);
 
 		// RenderTerrain the entities based on sorted renderQueue
-		for (const auto& [transformComponent, spriteComponent, bHasAnimationComponent] : m_renderQueue)
+		for (const auto& [transformComponent, spriteComponent, bHasAnimationComponent, bIsInterpolated] : m_renderQueue)
 		{
 			CSimpleSprite* sprite = assetManager->GetSprite(spriteComponent->assetId);
 			if (!sprite) continue;
 
+			const Vector2 position = bIsInterpolated ? transformComponent->GetInterpolatedPosition(alpha) : transformComponent->position;
+			const float rotation = bIsInterpolated ? transformComponent->GetInterpolatedRotation(alpha) : transformComponent->rotation;
+
 			// Transform position through camera
-			const Vector2 screenPos = Camera::WorldToScreen(transformComponent->position, camera);
+			const Vector2 screenPos = Camera::WorldToScreen(position, camera);
 
 			// sprite->SetPosition(transformComponent->position.x, transformComponent->position.y);
 			sprite->SetPosition(screenPos.x, screenPos.y);
-			sprite->SetAngle(transformComponent->rotation);
+			sprite->SetAngle(rotation);
 			sprite->SetScale(transformComponent->scale.x);
 
 			// Usually the animation component handles which frame to render from the sprite but in absence of it setting the frame here
@@ -86,6 +92,8 @@ private:
 		const SpriteComponent* spriteComponent;
 		// Need to decided if the render system should handle setting the frame or animation system
 		bool bHasAnimationComponent; // TODO: Refactor this.
+		// Only the rigid bodies have a previous transform (see PhysicsSystem::StorePreviousTransforms())
+		bool bIsInterpolated;
 	};
 
 	// Cache for transformed positions to avoid recalculating for static objects
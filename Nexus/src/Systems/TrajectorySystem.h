@@ -1,32 +1,66 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 #include "src/ECS/System.h"
 #include "src/ECS/Entity.h"
 
+#include "src/Components/BoxColliderComponent.h"
+#include "src/Components/ChainColliderComponent.h"
+#include "src/Components/CircleColliderComponent.h"
+#include "src/Components/ColliderTypeComponent.h"
+#include "src/Components/CollisionFilterComponent.h"
+#include "src/Components/GravityComponent.h"
 #include "src/Components/PlayerComponent.h"
+#include "src/Components/PolygonColliderComponent.h"
 #include "src/Components/RigidBodyComponent.h"
 #include "src/Components/TransformComponent.h"
+#include "src/Physics/Constants.h"
+#include "src/Physics/PhysicsEngine.h"
+#include "src/Systems/CollisionSystem.h"
 #include "src/Utils/GraphicsUtils.h"
 #include "src/Physics/Camera.h"
-
+#include "../Games/GalaxyGolf/WorldSettings.h"
+
+//------------------------------------------------------------------------
+// TrajectorySystem
+// While the shot is aimed, it previews the path of the ball with a ghost simulation: a copy of the ball's RigidBody gets the launch force of the active ability and is stepped with the same forces (gravity, wind, drag) and the same PhysicsEngine integration as the PhysicsSystem.
+// The ghost only collides with the static colliders (they never move, so the world is read-only for it) through CollisionSystem::FindTimeOfImpact(), and bounces off them. After a bounce the rest of the step is swept again.
+// Attractions are left out: the "Attracted" relationship pulls the aliens towards the ball, not the ball, and the mutual gravity of the GravityComponent bodies would need the other bodies to move with the ghost.
+// The path is only simulated again when the drag vector, the ability or the wind changes, and each simulation stops after SIMULATION_BUDGET
+//------------------------------------------------------------------------
 class TrajectorySystem : public System
 {
 private:
-	float m_gravity = 9.8f * 600;
-	float m_timeStep = 0.1f;
-	int m_maxSteps = 10;
+	static constexpr float PREVIEW_DURATION = 2.0f; // Seconds of ghost simulation
+	static constexpr int MAX_BOUNCES = 3; // The preview stops after this many bounces
+	static constexpr int STEPS_PER_POINT = 4; // Steps between two drawn points
+	static constexpr float REDRAG_THRESHOLD = 2.0f; // Pixels the mouse drag has to move before the path is simulated again
+	static constexpr std::chrono::microseconds SIMULATION_BUDGET{ 500 };
 
 public:
 	TrajectorySystem()
 	{
 		RequireComponent<PlayerComponent>();
+
+		ReadComponent<PlayerComponent>();
+		// The ghost starts from the ball and collides with the static colliders
+		ReadComponent<TransformComponent>();
+		ReadComponent<RigidBodyComponent>();
+		ReadComponent<ColliderTypeComponent>();
+		ReadComponent<CircleColliderComponent>();
+		ReadComponent<BoxColliderComponent>();
+		ReadComponent<PolygonColliderComponent>();
+		ReadComponent<ChainColliderComponent>();
+		ReadComponent<CollisionFilterComponent>();
+		ReadComponent<GravityComponent>();
 	}
 
-	// deltaTime is in seconds
-	void Update(const float deltaTime)
+	// stepTime is the fixed physics step, in seconds
+	void Update(const float stepTime, const WorldSettings& worldSettings)
 	{
-		m_timeStep = deltaTime;
 		for (auto& entity : GetSystemEntities())
 		{
 			auto& player = entity.GetComponent<PlayerComponent>();
@@ -36,11 +70,29 @@ public:
 			{
 				App::GetMousePos(m_startMousePos.x, m_startMousePos.y);
 				m_wasMouseHeld = true;
+				m_hasTrajectory = false;
 			}
 			else if (!player.bIsMouseClickHold && m_wasMouseHeld)
 			{
 				m_wasMouseHeld = false;
 			}
+
+			if (!player.bIsMouseClickHold)
+			{
+				continue;
+			}
+
+			Vector2 currentMousePos;
+			App::GetMousePos(currentMousePos.x, currentMousePos.y);
+			const Vector2 drag = currentMousePos - m_startMousePos;
+			if (!m_hasTrajectory || player.activeAbility != m_ability || worldSettings.windSpeed != m_windSpeed || (drag - m_drag).MagnitudeSquared() > REDRAG_THRESHOLD * REDRAG_THRESHOLD)
+			{
+				m_drag = drag;
+				m_ability = player.activeAbility;
+				m_windSpeed = worldSettings.windSpeed;
+				m_hasTrajectory = true;
+				SimulateTrajectory(entity, stepTime, worldSettings);
+			}
 		}
 	}
 
@@ -51,13 +103,7 @@ public:
 			const auto& player = entity.GetComponent<PlayerComponent>();
 			if (player.bIsMouseClickHold)
 			{
-				Vector2 currentMousePos;
-				App::GetMousePos(currentMousePos.x, currentMousePos.y);
-
-				const auto& transform = entity.GetComponent<TransformComponent>();
-				CalculateTrajectory(transform.position, m_startMousePos, currentMousePos);
-
-				for (size_t i = 0; i < trajectoryPoints.size() - 1; ++i)
+				for (size_t i = 0; i + 1 < trajectoryPoints.size(); ++i)
 				{
 					Graphics::DrawCircle(
 						Camera::WorldToScreen(trajectoryPoints[i], camera),
@@ -83,28 +129,116 @@ private:
 	Vector2 m_startMousePos;
 	bool m_wasMouseHeld = false;
 
-	void CalculateTrajectory(const Vector2& playerPos, const Vector2& startMouse, const Vector2& currentMouse)
+	// Drag vector, ability and wind of the simulated path
+	Vector2 m_drag;
+	Ability m_ability = Ability::NORMAL_SHOT;
+	float m_windSpeed = 0.0f;
+	bool m_hasTrajectory = false;
+
+	void SimulateTrajectory(const Entity& player, const float stepTime, const WorldSettings& worldSettings)
 	{
 		trajectoryPoints.clear();
+		if (!player.HasComponent<RigidBodyComponent>() || !player.HasComponent<TransformComponent>())
+		{
+			return;
+		}
 
-		// Calculate force direction and magnitude
-		Vector2 direction = currentMouse - startMouse;
+		// Ghost copy of the ball, it never goes back to the world
+		RigidBodyComponent rigidBody = player.GetComponent<RigidBodyComponent>();
+		TransformComponent transform = player.GetComponent<TransformComponent>();
+
+		// Same launch force as the InputSystem and the GameplaySystem (AddForce() on the next step)
+		Vector2 direction = m_drag;
 		const float magnitude = direction.MagnitudeSquared();
-		direction = -direction.Normalize();  // Match your input system
+		direction = -direction.Normalize();
+		PhysicsEngine::AddForce(rigidBody, direction * magnitude * GetShotForceScale(m_ability));
+
+		// Without a collider or a collision system the ghost goes through everything
+		CollisionSystem* collisionSystem = GetCoordinator().HasSystem<CollisionSystem>() ? &GetCoordinator().GetSystem<CollisionSystem>() : nullptr;
+		const bool hasCollider = player.HasComponent<CircleColliderComponent>();
+		const float radius = hasCollider ? player.GetComponent<CircleColliderComponent>().radius : 0.0f;
+		const Vector2 colliderOffset = hasCollider ? player.GetComponent<CircleColliderComponent>().globalCenter - transform.position : Vector2();
+		const auto& filter = player.HasComponent<CollisionFilterComponent>() ? player.GetComponent<CollisionFilterComponent>() : CollisionFilterComponent();
+
+		// Like PhysicsSystem::UpdateForces(), the bodies that are attracted by the others get no weight
+		const bool hasWeight = !player.BelongsToGroup("Aliens") && !player.HasComponent<GravityComponent>();
+
+		trajectoryPoints.push_back(transform.position);
+
+		const auto startTime = std::chrono::steady_clock::now();
+		const int stepCount = static_cast<int>(PREVIEW_DURATION / stepTime);
+		int bounceCount = 0;
+		for (int step = 1; step <= stepCount && bounceCount < MAX_BOUNCES; step++)
+		{
+			// Forces of PhysicsSystem::UpdateForces()
+			if (hasWeight)
+			{
+				PhysicsEngine::AddForce(rigidBody, Vector2(0.0f, rigidBody.mass * worldSettings.gravity * Physics::PIXEL_PER_METER));
+			}
+			PhysicsEngine::AddForce(rigidBody, Vector2(worldSettings.windSpeed, 0.0f));
+			PhysicsEngine::AddForce(rigidBody, PhysicsEngine::GenerateDragForce(rigidBody, worldSettings.atmosphereDrag));
+			PhysicsEngine::IntegrateForces(rigidBody, stepTime);
 
-		// Scale the initial velocity
-		const Vector2 initialVelocity = direction * (magnitude * 0.01f);
+			// Move until the first impact and bounce, then sweep the rest of the step again: it can hit another surface (ex: into a corner)
+			float remainingTime = stepTime;
+			while (remainingTime > 0.0f && bounceCount < MAX_BOUNCES)
+			{
+				const Vector2 displacement = rigidBody.velocity * remainingTime;
+				Vector2 normal;
+				Entity other = player;
+				const float timeOfImpact = collisionSystem && hasCollider
+					? collisionSystem->FindTimeOfImpact(transform.position + colliderOffset, radius, displacement, filter, normal, other)
+					: 1.0f;
+				if (timeOfImpact >= 1.0f)
+				{
+					PhysicsEngine::IntegrateVelocities(rigidBody, transform, remainingTime);
+					break;
+				}
 
-		Vector2 position = playerPos;
-		Vector2 velocity = initialVelocity;
+				PhysicsEngine::IntegrateVelocities(rigidBody, transform, remainingTime * timeOfImpact);
+				remainingTime *= 1.0f - timeOfImpact;
+				Bounce(rigidBody, other, normal);
+				bounceCount++;
+				trajectoryPoints.push_back(transform.position);
+			}
 
-		trajectoryPoints.push_back(position);
+			if (step % STEPS_PER_POINT == 0)
+			{
+				trajectoryPoints.push_back(transform.position);
+			}
+			if (std::chrono::steady_clock::now() - startTime > SIMULATION_BUDGET)
+			{
+				break;
+			}
+		}
+	}
+
+	// Velocity change of a contact with a static collider, like the penetration constraint: restitution is the smallest of the two and friction the largest. The rotation of the ball is ignored
+	static void Bounce(RigidBodyComponent& rigidBody, const Entity& other, const Vector2& normal)
+	{
+		const float normalSpeed = rigidBody.velocity.Dot(normal);
+		if (normalSpeed >= 0.0f)
+		{
+			return;
+		}
+
+		float restitution = rigidBody.restitution;
+		float friction = rigidBody.friction;
+		if (other.HasComponent<RigidBodyComponent>())
+		{
+			const auto& otherRigidBody = other.GetComponent<RigidBodyComponent>();
+			restitution = std::min(restitution, otherRigidBody.restitution);
+			friction = std::max(friction, otherRigidBody.friction);
+		}
 
-		for (int i = 1; i < m_maxSteps; ++i)
+		// The normal impulse reverses the normal velocity, friction takes at most friction * normal impulse from the tangent velocity
+		const float normalImpulse = -(1.0f + restitution) * normalSpeed;
+		Vector2 tangentVelocity = rigidBody.velocity - normal * normalSpeed;
+		const float tangentSpeed = tangentVelocity.Magnitude();
+		if (tangentSpeed > 0.0f)
 		{
-			velocity.y -= m_gravity * m_timeStep;
-			position += velocity * m_timeStep;
-			trajectoryPoints.push_back(position);
+			tangentVelocity *= std::max(0.0f, tangentSpeed - friction * normalImpulse) / tangentSpeed;
 		}
+		rigidBody.velocity = tangentVelocity - normal * (restitution * normalSpeed);
 	}
 };
@@ -0,0 +1,260 @@
+#include "stdafx.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+std::vector<std::thread> JobSystem::m_workers;
+std::vector<std::unique_ptr<JobSystem::WorkerQueue>> JobSystem::m_queues;
+std::atomic<size_t> JobSystem::m_queuedJobCount{ 0 };
+std::mutex JobSystem::m_sleepMutex;
+std::condition_variable JobSystem::m_wakeUp;
+bool JobSystem::m_isStopping = false;
+thread_local size_t JobSystem::m_queueIndex = 0;
+
+void JobSystem::Initialize(const size_t workerCount)
+{
+	Shutdown();
+
+	m_queues.clear();
+	for (size_t i = 0; i <= workerCount; i++)
+	{
+		m_queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	m_isStopping = false;
+	m_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, i + 1);
+	}
+}
+
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard lock(m_sleepMutex);
+		m_isStopping = true;
+	}
+	m_wakeUp.notify_all();
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+	m_queues.clear();
+	m_queuedJobCount = 0;
+}
+
+size_t JobSystem::GetDefaultWorkerCount()
+{
+	const unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+	return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0;
+}
+
+JobSystem::JobHandle JobSystem::Schedule(std::function<void()> function, const std::initializer_list<JobHandle> dependencies)
+{
+	return Schedule(std::move(function), std::vector<JobHandle>(dependencies));
+}
+
+JobSystem::JobHandle JobSystem::Schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies)
+{
+	auto job = std::make_shared<Job>();
+	job->function = std::move(function);
+	for (const auto& dependency : dependencies)
+	{
+		AddContinuation(dependency, job);
+	}
+	ReleaseDependency(job);
+	return job;
+}
+
+bool JobSystem::IsFinished(const JobHandle& job)
+{
+	return !job || job->isFinished;
+}
+
+void JobSystem::Wait(const JobHandle& job)
+{
+	while (!IsFinished(job))
+	{
+		if (!TryRunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(const size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	grainSize = std::max<size_t>(grainSize, 1);
+	const size_t rangeCount = (count + grainSize - 1) / grainSize;
+
+	const auto runRange = [&function, count, grainSize](const size_t range)
+	{
+		const size_t begin = range * grainSize;
+		function(begin, std::min(begin + grainSize, count));
+	};
+
+	if (m_workers.empty() || rangeCount == 1)
+	{
+		for (size_t range = 0; range < rangeCount; range++)
+		{
+			runRange(range);
+		}
+		return;
+	}
+
+	// The ranges are handed out one at a time, so the work is balanced even when the ranges have very different costs.
+	// The helper jobs let the idle workers steal a share of the loop, a helper that starts after the last range was taken just returns
+	std::atomic<size_t> nextRange{ 0 };
+	const auto runRanges = [&nextRange, &runRange, rangeCount]
+	{
+		for (size_t range = nextRange++; range < rangeCount; range = nextRange++)
+		{
+			runRange(range);
+		}
+	};
+
+	const size_t helperCount = std::min(rangeCount - 1, m_workers.size());
+	std::vector<JobHandle> helpers;
+	helpers.reserve(helperCount);
+	for (size_t i = 0; i < helperCount; i++)
+	{
+		helpers.push_back(Schedule(runRanges));
+	}
+
+	runRanges();
+
+	// The helpers reference the local variables, wait for all of them
+	for (const auto& helper : helpers)
+	{
+		Wait(helper);
+	}
+}
+
+void JobSystem::AddContinuation(const JobHandle& dependency, const JobHandle& job)
+{
+	if (!dependency)
+	{
+		return;
+	}
+
+	std::lock_guard lock(dependency->mutex);
+	if (dependency->isFinished)
+	{
+		return;
+	}
+	++job->unfinishedDependencies;
+	dependency->continuations.push_back(job);
+}
+
+void JobSystem::ReleaseDependency(const JobHandle& job)
+{
+	if (job->unfinishedDependencies.fetch_sub(1) == 1)
+	{
+		Enqueue(job);
+	}
+}
+
+void JobSystem::Enqueue(JobHandle job)
+{
+	if (m_workers.empty())
+	{
+		Execute(job);
+		return;
+	}
+
+	{
+		auto& queue = *m_queues[m_queueIndex];
+		std::lock_guard lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+	++m_queuedJobCount;
+
+	// Lock so a worker that is about to sleep can't miss the notification
+	{
+		std::lock_guard lock(m_sleepMutex);
+	}
+	m_wakeUp.notify_one();
+}
+
+void JobSystem::Execute(const JobHandle& job)
+{
+	job->function();
+	// Release the captures right away, the handle can outlive the job for a while
+	job->function = nullptr;
+
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard lock(job->mutex);
+		job->isFinished = true;
+		continuations.swap(job->continuations);
+	}
+	for (const auto& continuation : continuations)
+	{
+		ReleaseDependency(continuation);
+	}
+}
+
+bool JobSystem::TryRunJob()
+{
+	const size_t queueCount = m_queues.size();
+	if (queueCount == 0)
+	{
+		return false;
+	}
+
+	JobHandle job;
+	{
+		// Newest job of the own queue first, its data is the most likely to still be in the cache
+		auto& queue = *m_queues[m_queueIndex];
+		std::lock_guard lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+	}
+	for (size_t i = 1; !job && i < queueCount; i++)
+	{
+		// Steal the oldest job of another queue
+		auto& queue = *m_queues[(m_queueIndex + i) % queueCount];
+		std::lock_guard lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+	}
+
+	if (!job)
+	{
+		return false;
+	}
+	--m_queuedJobCount;
+	Execute(job);
+	return true;
+}
+
+void JobSystem::WorkerLoop(const size_t queueIndex)
+{
+	m_queueIndex = queueIndex;
+	while (true)
+	{
+		if (TryRunJob())
+		{
+			continue;
+		}
+
+		std::unique_lock lock(m_sleepMutex);
+		m_wakeUp.wait(lock, [] { return m_isStopping || m_queuedJobCount > 0; });
+		if (m_isStopping)
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+// JobSystem
+// Work-stealing task scheduler shared by the whole engine (ConstraintSystem islands, SystemScheduler stages, narrow phase, particles).
+//   - Every worker owns a deque: it pushes and pops its own jobs at the back (LIFO, cache friendly) and steals from the front of the other deques when it runs out.
+//     Queue 0 belongs to the threads that aren't workers (the main thread).
+//   - A job can depend on other jobs, it is queued once all of them are finished (continuations).
+//   - Wait() and ParallelFor() never block idle: the waiting thread runs queued jobs until what it waits for is finished, so jobs can wait on other jobs.
+// Without Initialize() (or with 0 workers) every job runs inline on the scheduling thread as soon as its dependencies are finished.
+//
+// Usage:
+//		const auto load = JobSystem::Schedule([] { ... });
+//		const auto build = JobSystem::Schedule([] { ... }, { load });
+//		JobSystem::Wait(build);
+//		JobSystem::ParallelFor(particles.size(), 256, [&](size_t begin, size_t end) { ... });
+//------------------------------------------------------------------------
+class JobSystem
+{
+	struct Job;
+
+public:
+	// Handle to a scheduled job, to wait for it or to use it as a dependency. An empty handle counts as finished
+	using JobHandle = std::shared_ptr<Job>;
+
+	// Start the worker threads. Call it before scheduling any job
+	static void Initialize(size_t workerCount = GetDefaultWorkerCount());
+	// Stop and join the worker threads. The jobs still queued are dropped, so wait for them first
+	static void Shutdown();
+
+	[[nodiscard]] static size_t GetWorkerCount() { return m_workers.size(); }
+	// One worker per hardware thread, minus the main thread
+	[[nodiscard]] static size_t GetDefaultWorkerCount();
+
+	// Queue the function once all the dependencies are finished
+	static JobHandle Schedule(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {});
+	static JobHandle Schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies);
+	// Continuation: run the function after the job
+	static JobHandle ContinueWith(const JobHandle& job, std::function<void()> function) { return Schedule(std::move(function), { job }); }
+
+	[[nodiscard]] static bool IsFinished(const JobHandle& job);
+	// Run other jobs until the job is finished
+	static void Wait(const JobHandle& job);
+
+	// Split [0, count) into ranges of grainSize indices and call function(begin, end) for each of them, in parallel. Returns once all the ranges are done.
+	// The calling thread works on the ranges too
+	static void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function);
+
+private:
+	struct Job
+	{
+		std::function<void()> function;
+		// +1 while Schedule() is still registering the dependencies
+		std::atomic<size_t> unfinishedDependencies{ 1 };
+		std::atomic<bool> isFinished{ false };
+
+		// Protects continuations and the transition to finished
+		std::mutex mutex;
+		std::vector<JobHandle> continuations;
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<JobHandle> jobs;
+	};
+
+	// Register the job as a continuation of the dependency, unless the dependency is already finished
+	static void AddContinuation(const JobHandle& dependency, const JobHandle& job);
+	static void ReleaseDependency(const JobHandle& job);
+
+	static void Enqueue(JobHandle job);
+	static void Execute(const JobHandle& job);
+
+	// Pop a job from the queue of this thread, or steal one from the other queues. Returns false if every queue is empty
+	static bool TryRunJob();
+	static void WorkerLoop(size_t queueIndex);
+
+	static std::vector<std::thread> m_workers;
+	// [Vector index = queue index], 0 for the non worker threads and 1..n for the workers
+	static std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+	// Sleeping workers wait for m_queuedJobCount > 0
+	static std::atomic<size_t> m_queuedJobCount;
+	static std::mutex m_sleepMutex;
+	static std::condition_variable m_wakeUp;
+	static bool m_isStopping;
+
+	// Queue of the current thread
+	static thread_local size_t m_queueIndex;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+
+// Fixed size counterpart of VectorN. The dimension is known at compile time and the data lives on the stack (or inline in the owning object), so no operation allocates.
+template <size_t N>
+struct Vec
+{
+	static constexpr size_t dimensions = N;
+	float data[N] = {};
+
+	Vec operator+(const Vec& vector) const;			// v1 + v2
+	Vec operator-(const Vec& vector) const;			// v1 - v2
+	Vec operator*(float scalar) const;				// v1 * scalar
+
+	Vec& operator+=(const Vec& vector);				// v1 += v2
+	Vec& operator-=(const Vec& vector);				// v1 -= v2
+	Vec& operator*=(float scalar);					// v *= scalar
+
+	float operator[] (const size_t index) const { return data[index]; }	// vector[index] to fetch a value at index.
+	float& operator[] (const size_t index) { return data[index]; }		// vector[index] to assign a value at index.
+
+	[[nodiscard]] float Dot(const Vec& vector) const;	// Return a dot product. A vector's projection onto another
+	void Zero();										// Put zero everywhere inside the vector
+};
+
+template <size_t N>
+Vec<N> Vec<N>::operator+(const Vec& vector) const
+{
+	Vec result;
+	for (size_t i = 0; i < N; i++)
+		result.data[i] = data[i] + vector.data[i];
+	return result;
+}
+
+template <size_t N>
+Vec<N> Vec<N>::operator-(const Vec& vector) const
+{
+	Vec result;
+	for (size_t i = 0; i < N; i++)
+		result.data[i] = data[i] - vector.data[i];
+	return result;
+}
+
+template <size_t N>
+Vec<N> Vec<N>::operator*(const float scalar) const
+{
+	Vec result;
+	for (size_t i = 0; i < N; i++)
+		result.data[i] = data[i] * scalar;
+	return result;
+}
+
+template <size_t N>
+Vec<N>& Vec<N>::operator+=(const Vec& vector)
+{
+	for (size_t i = 0; i < N; i++)
+		data[i] += vector.data[i];
+	return *this;
+}
+
+template <size_t N>
+Vec<N>& Vec<N>::operator-=(const Vec& vector)
+{
+	for (size_t i = 0; i < N; i++)
+		data[i] -= vector.data[i];
+	return *this;
+}
+
+template <size_t N>
+Vec<N>& Vec<N>::operator*=(const float scalar)
+{
+	for (size_t i = 0; i < N; i++)
+		data[i] *= scalar;
+	return *this;
+}
+
+template <size_t N>
+float Vec<N>::Dot(const Vec& vector) const
+{
+	float sum = 0.0f;
+	for (size_t i = 0; i < N; i++)
+		sum += data[i] * vector.data[i];
+	return sum;
+}
+
+template <size_t N>
+void Vec<N>::Zero()
+{
+	for (size_t i = 0; i < N; i++)
+		data[i] = 0.0f;
+}